@@ -1,9 +1,16 @@
 #pragma once
 
 #include <opencv2/opencv.hpp>
+#include <atomic>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <functional>
+#include <thread>
+#include "CaptureScheduler.h"
+#include "FrameAccounting.h"
+#include "IdleMonitor.h"
 
 namespace CodiceCam {
 
@@ -12,10 +19,35 @@ namespace CodiceCam {
  *
  * The CameraManager handles webcam initialization, frame capture,
  * and provides a callback-based interface for frame processing.
+ *
+ * Capture is split across two threads. The capture thread calls grab()
+ * continuously so the driver queue never holds stale frames, but only
+ * calls retrieve() (MJPEG decode and color conversion) when the processing
+ * thread is idle. The callback therefore always receives the freshest
+ * frame, and frames it would have skipped are never decoded; they are
+ * recorded as DROPPED_STALE ("not_retrieved").
+ *
+ * With an IdleMonitor attached, an inactive table drops to the monitor's
+ * motion-check rate: frames between checks are not retrieved
+ * (SKIPPED_STATIC, "idle") and checked frames without motion are not
+ * processed (SKIPPED_STATIC, "idle_static").
+ *
+ * In low-memory mode the camera delivers the Y (luma) plane only: the
+ * backend's RGB conversion is turned off, luma is taken straight from
+ * YUYV/UYVY frames, MJPEG frames are decoded to grayscale (no chroma
+ * upsampling or color conversion), and BGR frames from backends that
+ * ignore the setting are converted once at capture. Frames are then one
+ * byte per pixel through the whole pipeline instead of three.
+ *
+ * With several cameras sharing a CaptureScheduler, the processing thread
+ * holds each retrieved frame until the camera's slot in the frame period,
+ * so the pipelines take turns on the cores instead of waking together.
  */
 class CameraManager {
 public:
     using FrameCallback = std::function<void(const cv::Mat&)>;
+    using AccountedFrameCallback = std::function<FrameStatus(const cv::Mat&, const FrameInfo&)>;
+    using DeferredFrameCallback = std::function<void(const cv::Mat&, const FrameInfo&)>;
 
     /**
      * @brief Constructor
@@ -43,6 +75,67 @@ public:
      */
     bool startCapture(FrameCallback callback);
 
+    /**
+     * @brief Start capturing frames with per-frame status reporting
+     *
+     * The callback returns the terminal status of each frame, which is
+     * recorded in the frame accounting.
+     * @param callback Function to call for each frame
+     * @return true if successful, false otherwise
+     */
+    bool startCapture(AccountedFrameCallback callback);
+
+    /**
+     * @brief Start capturing frames whose status is reported later
+     *
+     * For consumers that queue frames and finish them asynchronously (e.g.
+     * FrameParallelDetector): the callback takes over each frame and must
+     * eventually call getFrameAccounting().finishFrame() for it. The callback
+     * may keep a reference to the frame; the camera never writes into a
+     * buffer it has handed over.
+     * @param callback Function to call for each frame
+     * @return true if successful, false otherwise
+     */
+    bool startDeferredCapture(DeferredFrameCallback callback);
+
+    /**
+     * @brief Get the frame accounting (counters and rates per frame status)
+     * @return Frame accounting
+     */
+    FrameAccounting& getFrameAccounting();
+
+    /**
+     * @brief Attach an idle monitor (power save when the table is inactive)
+     *
+     * Must be called before capture starts. The pipeline should report the
+     * markers of each processed frame with IdleMonitor::reportMarkers().
+     * @param idle_monitor Idle monitor, or nullptr to always run at full rate
+     */
+    void setIdleMonitor(std::shared_ptr<IdleMonitor> idle_monitor);
+
+    /**
+     * @brief Share a capture scheduler with other cameras (staggered processing)
+     *
+     * Must be called before capture starts. The camera registers with the
+     * scheduler while capturing, using the frame rate reported at initialize().
+     * @param capture_scheduler Scheduler, or nullptr to process each frame at once
+     */
+    void setCaptureScheduler(std::shared_ptr<CaptureScheduler> capture_scheduler);
+
+    /**
+     * @brief Enable/disable low-memory mode (grayscale Y-plane frames)
+     *
+     * Must be called before initialize().
+     * @param enable true to capture the Y plane only, false for BGR frames
+     */
+    void setLowMemoryMode(bool enable);
+
+    /**
+     * @brief Get the bytes held by the capture buffers (raw, retrieved and handed-off frames)
+     * @return Bytes
+     */
+    size_t getMemoryBytes() const;
+
     /**
      * @brief Stop capturing frames
      */
@@ -85,15 +178,64 @@ private:
     int width_;
     int height_;
     std::unique_ptr<cv::VideoCapture> cap_;
-    FrameCallback frame_callback_;
-    bool capturing_;
+    AccountedFrameCallback frame_callback_;
+    DeferredFrameCallback deferred_callback_;
+    FrameAccounting frame_accounting_;
+    std::shared_ptr<IdleMonitor> idle_monitor_;
+    std::shared_ptr<CaptureScheduler> capture_scheduler_;
+    int scheduler_source_;   // Source ID while capturing, -1 otherwise
+    double frame_period_ms_; // From the frame rate reported at initialize() (0 = unknown)
+    std::atomic<bool> capturing_;
     bool initialized_;
 
+    // Low-memory mode: Y plane extracted from the raw (unconverted) frame
+    bool low_memory_mode_;
+    int luma_channel_;  // Channel holding Y in 2-channel frames (0 = YUYV, 1 = UYVY)
+    bool planar_yuv_;   // 1-channel frames are planar YUV 4:2:0 (Y plane on top), not gray
+    cv::Mat raw_frame_;
+    std::atomic<size_t> capture_bytes_;
+
+    // Capture (grab/retrieve) and processing (callback) threads
+    std::thread capture_thread_;
+    std::thread processing_thread_;
+
+    // Hand-off of one retrieved frame from the capture to the processing thread
+    std::mutex handoff_mutex_;
+    std::condition_variable handoff_cv_;
+    cv::Mat handoff_frame_;
+    FrameInfo handoff_info_;
+    bool handoff_ready_;
+    bool processor_idle_;
+
     /**
-     * @brief Capture loop running in separate thread
+     * @brief Check the camera can start and reap threads of a failed capture
+     * @return true if capture can start, false otherwise
+     */
+    bool canStart();
+
+    /**
+     * @brief Start the capture and processing threads
+     * @return true if successful, false otherwise
+     */
+    bool startThreads();
+
+    /**
+     * @brief Capture loop: grab every frame, retrieve only when the processor is idle
      */
     void captureLoop();
 
+    /**
+     * @brief Processing loop: run the callback on each handed-off frame
+     */
+    void processingLoop();
+
+    /**
+     * @brief Retrieve the grabbed frame (Y plane only in low-memory mode)
+     * @param frame Output frame
+     * @return true if a frame was retrieved, false otherwise
+     */
+    bool retrieveFrame(cv::Mat& frame);
+
     /**
      * @brief Validate frame dimensions
      * @param width Width to validate
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace CodiceCam {
+
+/**
+ * @brief Phase staggering configuration
+ */
+struct CaptureSchedulerConfig {
+    double frame_period_ms = 0.0;     // Shared frame period (0 = longest period the sources declare)
+    double phase_smoothing = 0.05;    // Weight of each capture in a source's phase estimate
+    double max_delay_fraction = 0.75; // A frame further than this from its slot is processed at once
+};
+
+/**
+ * @brief Staggers the processing of several capture sources across the frame period
+ *
+ * Cameras on one box run at the same frame rate and, on a shared clock or
+ * USB controller, often deliver their frames at the same moment, so every
+ * pipeline competes for the cores at once and then leaves them idle. The
+ * scheduler gives each source a processing slot and holds each frame until
+ * its slot, so N sources start one period / N apart.
+ *
+ * Each source's capture phase (capture timestamp modulo the frame period)
+ * is tracked with an exponential average on the circle, so drift between
+ * free-running cameras is followed rather than fought. Slots are evenly
+ * spaced and assigned in phase order, rotated to minimize the longest
+ * hold; sources already spread out are held for little or nothing. The
+ * order and the rotation only change by a clear margin, so sources that
+ * capture together do not trade slots on jitter; phases are compared on
+ * the circle (cut half a slot before the first slot), so a source whose
+ * phase wraps past the end of the period keeps its place. A frame that arrives past
+ * its slot (jitter, a late retrieve) is processed at once instead of
+ * waiting most of a period.
+ *
+ * Thread-safe: every source's processing thread calls dispatchTime().
+ */
+class CaptureScheduler {
+public:
+    /**
+     * @brief Constructor
+     * @param config Scheduling configuration
+     */
+    explicit CaptureScheduler(const CaptureSchedulerConfig& config = CaptureSchedulerConfig());
+
+    /**
+     * @brief Register a capture source
+     * @param name Source name in the statistics
+     * @param frame_period_ms Source frame period in milliseconds
+     * @return Source ID
+     */
+    int addSource(const std::string& name, double frame_period_ms);
+
+    /**
+     * @brief Unregister a capture source (its slot goes to the others)
+     * @param source Source ID
+     */
+    void removeSource(int source);
+
+    /**
+     * @brief Get when to start processing a frame
+     * @param source Source ID
+     * @param capture_time Frame capture time
+     * @return Start of the source's next slot, or capture_time if the source is unknown
+     */
+    std::chrono::steady_clock::time_point dispatchTime(int source, std::chrono::steady_clock::time_point capture_time);
+
+    /**
+     * @brief Get statistics (period, and per source phase, slot and hold times)
+     * @return Statistics string
+     */
+    std::string getStatistics() const;
+
+private:
+    struct Source {
+        std::string name;
+        double frame_period_ms;
+        bool has_phase;
+        double phase_ms;        // Smoothed capture phase in [0, period)
+        double slot_ms;         // Assigned processing phase in [0, period)
+        size_t rank;            // Position in the slot order
+        uint64_t frames;
+        double total_delay_ms;
+        double max_delay_ms;
+        uint64_t late_frames;   // Past the slot by more than jitter, processed at once
+    };
+
+    CaptureSchedulerConfig config_;
+    mutable std::mutex mutex_;
+    std::chrono::steady_clock::time_point epoch_;  // Phase reference
+    std::map<int, Source> sources_;
+    int next_source_;
+    bool has_anchor_;
+    double anchor_phase_ms_;  // Phase of the source holding the first slot at the last assignment
+
+    double periodLocked() const;
+    void assignSlotsLocked(double period);
+};
+
+} // namespace CodiceCam
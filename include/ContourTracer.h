@@ -0,0 +1,84 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace CodiceCam {
+
+/**
+ * @brief External contour tracer that abandons contours too large to be markers
+ *
+ * Equivalent to cv::findContours(RETR_EXTERNAL, CHAIN_APPROX_SIMPLE): the
+ * same Suzuki-Abe raster scan and border following, the same starting
+ * point, orientation and corner compression, and contours nested inside an
+ * outer contour are skipped the same way. While following a border it
+ * tracks the running bounding box and step count; once either exceeds the
+ * limits, the border is abandoned and its whole component is marked visited
+ * with a flood fill, so the scan never restarts on it and no points are
+ * stored or filtered for it.
+ *
+ * Unlike findContours, contours inside an abandoned contour are reported
+ * (a marker lying inside a closed table or screen edge is not hidden).
+ *
+ * The label buffer and flood-fill stack are reused across frames.
+ */
+class BoundedContourTracer {
+public:
+    BoundedContourTracer();
+
+    /**
+     * @brief Set the abandon limits
+     * @param max_extent Largest bounding box width or height in pixels (0 = unlimited)
+     * @param max_length Largest number of border steps (0 = unlimited)
+     */
+    void setLimits(int max_extent, int max_length);
+
+    /**
+     * @brief Trace the external contours of a binary image
+     * @param binary 8-bit single-channel image (nonzero = foreground)
+     * @param contours Output contours (CHAIN_APPROX_SIMPLE points)
+     * @return true if traced, false if the image is not 8-bit single-channel
+     */
+    bool trace(const cv::Mat& binary, std::vector<std::vector<cv::Point>>& contours);
+
+    /**
+     * @brief Get the number of contours traced to completion
+     * @return Contour count
+     */
+    uint64_t getTracedCount() const;
+
+    /**
+     * @brief Get the number of contours abandoned at the limits
+     * @return Contour count
+     */
+    uint64_t getAbandonedCount() const;
+
+    /**
+     * @brief Get the bytes held by the label image and per-contour buffers
+     * @return Bytes
+     */
+    size_t getMemoryBytes() const;
+
+private:
+    int max_extent_;
+    int max_length_;
+
+    // Padded label image: 0 background, 1 foreground, 2 traced, negative = right bound or abandoned
+    std::vector<int8_t> labels_;
+    int stride_;
+    int deltas_[16];
+
+    // Reused per contour
+    std::vector<cv::Point> points_;
+    std::vector<int> fill_stack_;
+
+    uint64_t traced_;
+    uint64_t abandoned_;
+
+    bool followBorder(int start, cv::Point origin);
+    void abandonComponent(int start);
+};
+
+} // namespace CodiceCam
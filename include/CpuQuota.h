@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace CodiceCam {
+
+/**
+ * @brief CPU throttling counters from the cgroup's cpu.stat
+ */
+struct CpuThrottling {
+    uint64_t periods = 0;          // nr_periods: enforcement periods with runnable threads
+    uint64_t throttled = 0;        // nr_throttled: periods in which the quota ran out
+    uint64_t throttled_usec = 0;   // throttled_usec: total time spent throttled
+};
+
+/**
+ * @brief Effective CPU count of the process under cgroup v2 limits
+ *
+ * std::thread::hardware_concurrency() reports every host core, so inside a
+ * container with a CPU quota a pool sized from it runs more threads than
+ * the quota allows and the kernel throttles the whole cgroup for the rest
+ * of each period (typically 100 ms). The effective count is the smallest of:
+ * - the scheduler affinity mask (sched_getaffinity)
+ * - the cgroup's cpuset.cpus.effective
+ * - cpu.max quota / period, rounded down (at least 1), taken over the
+ *   process's cgroup and all its ancestors
+ *
+ * The cgroup is found through /proc/self/cgroup ("0::<path>") under the
+ * given cgroup v2 mount point, so a test can point it at any directory
+ * laid out like /sys/fs/cgroup. Missing files mean "no limit"; on cgroup
+ * v1 or non-Linux systems only the affinity mask or hardware concurrency
+ * applies.
+ */
+class CpuQuota {
+public:
+    /**
+     * @brief Constructor (reads the limits)
+     * @param cgroup_root cgroup v2 mount point
+     * @param proc_cgroup File naming the process's cgroup
+     */
+    explicit CpuQuota(const std::string& cgroup_root = "/sys/fs/cgroup",
+                      const std::string& proc_cgroup = "/proc/self/cgroup");
+
+    /**
+     * @brief Re-read the limits (quotas can change at runtime)
+     * @return true if a cgroup v2 hierarchy was found, false otherwise
+     */
+    bool refresh();
+
+    /**
+     * @brief Get the number of CPUs the process can actually use
+     * @return Effective CPU count (at least 1)
+     */
+    int getEffectiveCpuCount() const;
+
+    /**
+     * @brief Get the cpu.max quota in CPUs
+     * @return Quota / period, or 0 if unlimited
+     */
+    double getQuotaCpus() const;
+
+    /**
+     * @brief Get the number of CPUs in the cpuset
+     * @return CPU count, or 0 if unknown
+     */
+    int getCpusetCount() const;
+
+    /**
+     * @brief Get the number of CPUs in the affinity mask
+     * @return CPU count
+     */
+    int getAffinityCount() const;
+
+    /**
+     * @brief Read the current throttling counters of the process's cgroup
+     * @param throttling Output counters
+     * @return true if cpu.stat was read, false otherwise
+     */
+    bool readThrottling(CpuThrottling& throttling) const;
+
+    /**
+     * @brief Get the cgroup directory in use
+     * @return Path, or empty if no cgroup v2 hierarchy was found
+     */
+    const std::string& getCgroupPath() const;
+
+    /**
+     * @brief Get statistics (limits and throttling)
+     * @return Statistics string
+     */
+    std::string getStatistics() const;
+
+    /**
+     * @brief Get the process-wide effective CPU count
+     *
+     * Read once from the default cgroup mount; used to size thread pools.
+     * @return Effective CPU count (at least 1)
+     */
+    static int effectiveCpuCount();
+
+    /**
+     * @brief Parse a cpuset list such as "0-3,8,10-11"
+     * @param list cpuset list
+     * @return Number of CPUs in the list
+     */
+    static int parseCpuList(const std::string& list);
+
+private:
+    std::string cgroup_root_;
+    std::string proc_cgroup_;
+    std::string cgroup_path_;
+
+    double quota_cpus_;
+    int cpuset_count_;
+    int affinity_count_;
+    int effective_count_;
+};
+
+} // namespace CodiceCam
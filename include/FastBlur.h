@@ -0,0 +1,128 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace CodiceCam {
+
+class FrameQualityMap;
+
+/**
+ * @brief Fixed-point separable Gaussian blur fused with grayscale and contrast
+ *
+ * Replaces the cvtColor -> GaussianBlur -> convertTo chain of
+ * ImageProcessor::preprocessFrame with a single row-streaming pass:
+ * - BGR to gray with OpenCV's 14-bit coefficients (bit-exact with cvtColor)
+ * - Vertical pass over a ring of gray rows into 16-bit lanes (Q8.8)
+ * - Horizontal pass accumulated in 32-bit lanes: Q8.8 sums times Q8 weights
+ *   need 24 bits. 16-bit lanes would mean rounding the vertical pass to
+ *   8 bits first, which moves 11-23% of pixels by a gray level; with one
+ *   rounding at the end, kernels 3-11 match cv::GaussianBlur exactly
+ * - Contrast/brightness through a 256-entry lookup table
+ *
+ * Weights are Q8 (sum to 256). For kernel sizes 3, 5 and 7 they are the
+ * binomial kernels OpenCV itself uses when sigma is 0; larger kernels are
+ * the sampled Gaussian for OpenCV's default sigma quantized to Q8. Borders
+ * are reflected like BORDER_REFLECT_101.
+ *
+ * Accuracy against a floating-point Gaussian of the same gray image
+ * (1920x1080, rounded to 8 bits) never exceeds 1 gray level:
+ *
+ * | Kernel | Identical pixels (camera-like) | Identical pixels (white noise) |
+ * |--------|--------------------------------|--------------------------------|
+ * | 3      | 96.9%                          | 96.8%                          |
+ * | 5      | 99.8%                          | 99.8%                          |
+ * | 7      | 99.99%                         | 99.99%                         |
+ * | 9-15   | 99.1-99.4%                     | 89.5-92.3%                     |
+ *
+ * Against cv::GaussianBlur (itself fixed-point for 8-bit images) kernels
+ * 3-11 are identical and 13-15 differ by at most 2 gray levels, because
+ * OpenCV quantizes those kernels finer than Q8; test_fast_blur checks both
+ * bounds.
+ *
+ * The inner loops are plain fixed-width integer loops over contiguous rows
+ * so the compiler vectorizes them (SSE2/AVX2/NEON) without intrinsics.
+ */
+class FastBlur {
+public:
+    static constexpr int MAX_KERNEL_SIZE = 15;
+
+    /**
+     * @brief Constructor
+     * @param kernel_size Blur kernel size (odd, 3-15)
+     */
+    explicit FastBlur(int kernel_size = 5);
+
+    /**
+     * @brief Set the kernel size
+     * @param kernel_size Blur kernel size (odd, 3-15)
+     * @return true if the kernel size is supported, false otherwise
+     */
+    bool setKernelSize(int kernel_size);
+
+    /**
+     * @brief Get the kernel size
+     * @return Kernel size
+     */
+    int getKernelSize() const;
+
+    /**
+     * @brief Get the Q8 kernel weights
+     * @return Weights (sum to 256)
+     */
+    const std::vector<uint16_t>& getKernel() const;
+
+    /**
+     * @brief Check whether a frame can take the fused path
+     * @param frame Input frame
+     * @param kernel_size Blur kernel size
+     * @return true for 8-bit BGR or gray frames larger than the kernel
+     */
+    static bool supports(const cv::Mat& frame, int kernel_size);
+
+    /**
+     * @brief Convert to gray, blur and apply contrast in one pass
+     * @param input 8-bit BGR or grayscale frame
+     * @param output Output 8-bit grayscale frame
+     * @param alpha Contrast factor (1.0 = no change)
+     * @param beta Brightness offset (0 = no change)
+     * @param quality Quality map fed each gray row as it is converted, or nullptr
+     * @return true if processed, false if the frame is not supported
+     */
+    bool apply(const cv::Mat& input, cv::Mat& output, double alpha = 1.0, double beta = 0.0,
+               FrameQualityMap* quality = nullptr);
+
+    /**
+     * @brief Get a description of the kernel
+     * @return Kernel description string
+     */
+    std::string getInfo() const;
+
+    /**
+     * @brief Get the bytes held by the scratch buffers
+     * @return Bytes
+     */
+    size_t getMemoryBytes() const;
+
+private:
+    int kernel_size_;
+    std::vector<uint16_t> kernel_;
+
+    // Contrast lookup table, rebuilt when alpha/beta change
+    uint8_t lut_[256];
+    double lut_alpha_;
+    double lut_beta_;
+
+    // Scratch buffers reused across frames
+    std::vector<uint8_t> gray_ring_;     // kernel_size_ gray rows
+    std::vector<uint16_t> column_sums_;  // Vertical pass output, padded for the horizontal pass
+    std::vector<uint32_t> row_acc_;      // Horizontal pass accumulators
+
+    void buildKernel();
+    void buildLut(double alpha, double beta);
+    void convertRow(const cv::Mat& input, int y, uint8_t* gray_row) const;
+};
+
+} // namespace CodiceCam
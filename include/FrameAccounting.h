@@ -0,0 +1,140 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace CodiceCam {
+
+/**
+ * @brief Terminal status of a captured frame
+ */
+enum class FrameStatus {
+    DELIVERED,           // Markers committed to TUIO within the latency budget
+    DROPPED_STALE,       // Superseded by a newer frame before processing
+    DROPPED_QUEUE_FULL,  // No processing slot available
+    PROCESSING_ERROR,    // Empty frame, exception or failed processing step
+    OVER_BUDGET,         // Committed, but capture-to-commit latency exceeded the budget
+    SKIPPED_STATIC       // Intentionally not processed because the scene is static
+};
+
+constexpr int FRAME_STATUS_COUNT = 6;
+
+/**
+ * @brief Identity of a frame as it moves through the pipeline
+ */
+struct FrameInfo {
+    uint64_t sequence = 0;                                 // Capture sequence number
+    std::chrono::steady_clock::time_point capture_time;    // Time the frame was captured
+};
+
+/**
+ * @brief Tracks every captured frame to a terminal status
+ *
+ * Each frame gets a sequence number when captured (beginFrame) and exactly
+ * one terminal status (finishFrame). Counters are kept per status together
+ * with per-second rates over a sliding window, and an optional detail tag
+ * (e.g. "empty_frame", "exception") records which mechanism produced the
+ * status. Thread-safe.
+ */
+class FrameAccounting {
+public:
+    static constexpr int RATE_WINDOW_SECONDS = 10;
+
+    FrameAccounting();
+
+    /**
+     * @brief Register a newly captured frame
+     * @return Frame identity (sequence number and capture time)
+     */
+    FrameInfo beginFrame();
+
+    /**
+     * @brief Record the terminal status of a frame
+     *
+     * DELIVERED frames whose latency exceeds the budget are recorded as
+     * OVER_BUDGET.
+     * @param frame Frame identity from beginFrame
+     * @param status Terminal status
+     * @param detail Optional reason tag for the status
+     * @return Status actually recorded
+     */
+    FrameStatus finishFrame(const FrameInfo& frame, FrameStatus status, const std::string& detail = "");
+
+    /**
+     * @brief Set the capture-to-commit latency budget
+     * @param budget_ms Budget in milliseconds (0 = no budget)
+     */
+    void setLatencyBudget(int budget_ms);
+
+    /**
+     * @brief Get the total number of frames with a status
+     * @param status Frame status
+     * @return Frame count
+     */
+    uint64_t getCount(FrameStatus status) const;
+
+    /**
+     * @brief Get the rate of a status over the sliding window
+     * @param status Frame status
+     * @return Frames per second
+     */
+    double getRate(FrameStatus status) const;
+
+    /**
+     * @brief Get the number of frames captured but not yet finished
+     * @return In-flight frame count
+     */
+    uint64_t getInFlight() const;
+
+    /**
+     * @brief Get the number of frames captured
+     * @return Captured frame count
+     */
+    uint64_t getCaptured() const;
+
+    /**
+     * @brief Get statistics
+     * @return Statistics string
+     */
+    std::string getStatistics() const;
+
+    /**
+     * @brief Reset all counters
+     */
+    void reset();
+
+    /**
+     * @brief Get the name of a status
+     * @param status Frame status
+     * @return Status name
+     */
+    static const char* getStatusName(FrameStatus status);
+
+private:
+    mutable std::mutex mutex_;
+    std::chrono::steady_clock::time_point start_time_;
+
+    uint64_t next_sequence_;
+    uint64_t captured_;
+    std::array<uint64_t, FRAME_STATUS_COUNT> counts_;
+    std::map<std::string, uint64_t> details_;
+
+    // Per-second buckets for rates; bucket_second_ tags which second a bucket holds
+    std::array<std::array<uint64_t, RATE_WINDOW_SECONDS>, FRAME_STATUS_COUNT> buckets_;
+    std::array<int64_t, RATE_WINDOW_SECONDS> bucket_second_;
+
+    // Latency
+    int latency_budget_ms_;
+    double total_latency_ms_;
+    double max_latency_ms_;
+    uint64_t latency_samples_;
+
+    int64_t currentSecond() const;
+    double rateLocked(int status_index, int64_t now_second) const;
+};
+
+} // namespace CodiceCam
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <vector>
+
+namespace CodiceCam {
+
+/**
+ * @brief Recorded frames for offline checks (test_* comparison programs)
+ */
+class FrameDataset {
+public:
+    /**
+     * @brief Load a dataset: a directory of images (in file name order) or a video file
+     * @param path Directory or video file
+     * @param frames Frames are appended here
+     * @return true if frames holds at least one frame afterwards, false otherwise
+     */
+    static bool load(const std::string& path, std::vector<cv::Mat>& frames);
+};
+
+/**
+ * @brief Counts the mismatches of an offline comparison and prints the first few
+ */
+class MismatchLog {
+public:
+    /**
+     * @brief Constructor
+     * @param max_printed Mismatches printed; the rest are only counted
+     */
+    explicit MismatchLog(size_t max_printed = 20);
+
+    /**
+     * @brief Record a mismatch
+     * @param frame Frame index in the dataset
+     * @param problem Description
+     */
+    void add(size_t frame, const std::string& problem);
+
+    /**
+     * @brief Get the number of mismatches recorded
+     * @return Mismatch count
+     */
+    size_t getCount() const;
+
+private:
+    size_t max_printed_;
+    size_t count_;
+};
+
+} // namespace CodiceCam
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "FrameAccounting.h"
+#include "MarkerDetector.h"
+
+namespace CodiceCam {
+
+/**
+ * @brief Frame-parallel detection configuration
+ */
+struct ParallelDetectionConfig {
+    int contexts = 2;           // Detector contexts, each on its own thread
+    int max_in_flight = 0;      // Frames submitted but not yet committed (0 = 2 x contexts)
+    int max_lateness_ms = 200;  // Skip a frame this old once a newer frame is ready (0 = never skip)
+    bool deterministic = false; // Never drop or skip: submit() waits for room (replay, equivalence checks)
+};
+
+/**
+ * @brief Runs detection on consecutive frames in parallel and commits them in capture order
+ *
+ * Each submitted frame is queued for the next free detector context; with K
+ * contexts, K frames are detected at once. Finished frames wait in a reorder
+ * buffer and are committed strictly in submission (capture) order, from one
+ * thread at a time, so the consumer (e.g. TUIOBridge) sees a monotonic
+ * stream.
+ *
+ * Bounds and skip rules, each recorded in the frame accounting:
+ * - submit() drops the frame when max_in_flight frames are already
+ *   uncommitted (DROPPED_QUEUE_FULL, "in_flight_limit")
+ * - A frame still waiting for a context after max_lateness_ms while newer
+ *   frames are queued is dropped (DROPPED_STALE, "late_dispatch")
+ * - A frame blocking the head of the reorder buffer after max_lateness_ms
+ *   while a newer frame is finished is skipped and its result discarded
+ *   (DROPPED_STALE, "late_frame")
+ *
+ * In deterministic mode nothing is dropped or skipped: submit() blocks
+ * until the reorder buffer has room, so every submitted frame is detected
+ * and committed in order and the committed stream matches a serial run over
+ * the same frames.
+ *
+ * Detector contexts must not share mutable state: the detect function gets
+ * the context index and should use one MarkerDetector per context. It also
+ * gets the frame's FrameInfo, so the capture time travels with the frame.
+ */
+class FrameParallelDetector {
+public:
+    using DetectFunction = std::function<bool(int context, const cv::Mat& frame, const FrameInfo& info,
+                                              std::vector<CodiceMarker>& markers)>;
+    using CommitFunction = std::function<FrameStatus(const cv::Mat& frame, const FrameInfo& info,
+                                                     const std::vector<CodiceMarker>& markers)>;
+
+    /**
+     * @brief Constructor
+     * @param config Detection configuration
+     */
+    explicit FrameParallelDetector(const ParallelDetectionConfig& config = ParallelDetectionConfig());
+
+    /**
+     * @brief Destructor (stops the contexts)
+     */
+    ~FrameParallelDetector();
+
+    FrameParallelDetector(const FrameParallelDetector&) = delete;
+    FrameParallelDetector& operator=(const FrameParallelDetector&) = delete;
+
+    /**
+     * @brief Start the detector contexts
+     * @param detect Detection function, called concurrently with distinct context indices
+     * @param commit Commit function, called in capture order from one thread at a time
+     * @param accounting Frame accounting receiving each frame's terminal status (may be null)
+     * @return true if started, false otherwise
+     */
+    bool start(DetectFunction detect, CommitFunction commit, FrameAccounting* accounting);
+
+    /**
+     * @brief Stop the contexts
+     *
+     * Frames still queued are dropped (DROPPED_STALE, "shutdown"); frames
+     * being detected finish and are committed.
+     */
+    void stop();
+
+    /**
+     * @brief Queue a frame for detection
+     *
+     * Must be called from one thread, in capture order. The frame buffer is
+     * referenced, not copied, until the frame is committed.
+     * @param frame Captured frame
+     * @param info Frame identity
+     * @return true if queued, false if dropped
+     */
+    bool submit(const cv::Mat& frame, const FrameInfo& info);
+
+    /**
+     * @brief Wait until every submitted frame has been committed or dropped
+     */
+    void drain();
+
+    /**
+     * @brief Get the number of detector contexts
+     * @return Context count
+     */
+    int getContextCount() const;
+
+    /**
+     * @brief Get the bytes of the frames submitted but not yet committed
+     * @return Bytes
+     */
+    size_t getInFlightBytes() const;
+
+    /**
+     * @brief Get statistics
+     * @return Statistics string
+     */
+    std::string getStatistics() const;
+
+private:
+    struct Slot {
+        FrameInfo info;
+        cv::Mat frame;
+        std::vector<CodiceMarker> markers;
+        bool done = false;
+        bool ok = false;
+    };
+
+    ParallelDetectionConfig config_;
+    DetectFunction detect_;
+    CommitFunction commit_;
+    FrameAccounting* accounting_;
+
+    std::vector<std::thread> contexts_;
+    mutable std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable room_cv_;  // Reorder buffer shrank (deterministic submit, drain)
+    std::deque<std::shared_ptr<Slot>> window_;   // Submitted, not yet committed, in capture order
+    std::deque<std::shared_ptr<Slot>> pending_;  // Waiting for a context
+    bool running_;
+
+    // Serializes commits so they leave in capture order
+    std::mutex commit_mutex_;
+
+    // Statistics
+    std::atomic<uint64_t> submitted_;
+    std::atomic<uint64_t> committed_;
+    std::atomic<uint64_t> dropped_in_flight_;
+    std::atomic<uint64_t> skipped_late_;
+    std::atomic<uint64_t> detection_errors_;
+    std::atomic<uint64_t> commit_errors_;     // Commit function threw; not counted as committed
+    size_t max_depth_;
+
+    void contextLoop(int index);
+    void commitReady();
+    void skipLateHeadLocked(std::chrono::steady_clock::time_point now);
+    void finish(const FrameInfo& info, FrameStatus status, const std::string& detail);
+};
+
+} // namespace CodiceCam
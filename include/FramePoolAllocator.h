@@ -0,0 +1,113 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace CodiceCam {
+
+/**
+ * @brief Frame pool configuration
+ */
+struct FramePoolConfig {
+    size_t region_bytes = 64 * 1024 * 1024;    // Size of each preallocated region
+    size_t max_pool_bytes = 512 * 1024 * 1024; // No regions beyond this; larger demand uses the system allocator
+    size_t min_pooled_bytes = 4096;            // Smaller buffers use the system allocator
+    bool huge_pages = true;                    // Back regions with 2 MiB pages when the kernel allows it
+};
+
+/**
+ * @brief cv::MatAllocator that recycles buffers from preallocated regions
+ *
+ * Buffers are carved from large regions mapped once (2 MiB huge pages when
+ * available, otherwise transparent huge pages are requested) and are
+ * 64-byte aligned. When the last cv::Mat referencing a buffer is released,
+ * OpenCV's reference count calls deallocate() and the buffer goes back to
+ * the free list of its size class instead of to the system allocator, so
+ * frame, gray, edge and patch buffers of a steady-state pipeline are reused
+ * frame after frame. The UMatData bookkeeping lives in the block header and
+ * is recycled with the buffer.
+ *
+ * Buffers below min_pooled_bytes, user-provided data, and demand beyond
+ * max_pool_bytes fall back to cv::fastMalloc. Regions are never returned to
+ * the OS while the allocator lives. Thread-safe.
+ */
+class FramePoolAllocator : public cv::MatAllocator {
+public:
+    /**
+     * @brief Constructor
+     * @param config Pool configuration
+     */
+    explicit FramePoolAllocator(const FramePoolConfig& config = FramePoolConfig());
+
+    /**
+     * @brief Destructor (unmaps all regions; no pooled cv::Mat may outlive it)
+     */
+    ~FramePoolAllocator() override;
+
+    FramePoolAllocator(const FramePoolAllocator&) = delete;
+    FramePoolAllocator& operator=(const FramePoolAllocator&) = delete;
+
+    cv::UMatData* allocate(int dims, const int* sizes, int type, void* data, size_t* step,
+                           cv::AccessFlag flags, cv::UMatUsageFlags usage_flags) const override;
+    bool allocate(cv::UMatData* data, cv::AccessFlag access_flags, cv::UMatUsageFlags usage_flags) const override;
+    void deallocate(cv::UMatData* data) const override;
+
+    /**
+     * @brief Get statistics
+     * @return Statistics string
+     */
+    std::string getStatistics() const;
+
+    /**
+     * @brief Make the process-wide pool OpenCV's default cv::Mat allocator
+     *
+     * The pool is created on the first call and never destroyed, so cv::Mat
+     * objects may outlive main(). Mats allocated before the call keep their
+     * original allocator. Later calls return the same pool and ignore config.
+     * @param config Pool configuration (first call only)
+     * @return The installed pool
+     */
+    static FramePoolAllocator* installAsDefault(const FramePoolConfig& config = FramePoolConfig());
+
+private:
+    // Precedes every pooled buffer; the UMatData handed to OpenCV lives in it
+    struct BlockHeader {
+        size_t class_bytes;
+        BlockHeader* next_free;
+    };
+
+    struct Region {
+        char* base;
+        size_t bytes;
+        size_t used;
+        bool huge_pages;
+    };
+
+    FramePoolConfig config_;
+
+    // allocate/deallocate are const in cv::MatAllocator; the pool state is not
+    mutable std::mutex mutex_;
+    mutable std::vector<Region> regions_;
+    mutable std::unordered_map<size_t, BlockHeader*> free_lists_;
+    mutable size_t mapped_bytes_;
+
+    // Statistics
+    mutable std::atomic<uint64_t> reused_;
+    mutable std::atomic<uint64_t> carved_;
+    mutable std::atomic<uint64_t> fallback_;
+    mutable std::atomic<uint64_t> in_use_;
+
+    BlockHeader* acquireBlock(size_t class_bytes) const;
+    BlockHeader* carveBlock(size_t class_bytes) const;
+    bool mapRegion(size_t bytes) const;
+    static size_t slotOffset();
+    static size_t headerBytes();
+    static void unmapRegion(const Region& region);
+};
+
+} // namespace CodiceCam
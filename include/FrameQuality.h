@@ -0,0 +1,150 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace CodiceCam {
+
+/**
+ * @brief Frame quality gate configuration
+ */
+struct FrameQualityConfig {
+    int tile_size = 32;              // Tile side in pixels
+    int sample_step = 2;             // Sample every Nth pixel in each direction
+    double min_sharpness = 30.0;     // Minimum sharpness (gray levels squared) to decode a region
+    double max_clipped_ratio = 0.25; // Maximum fraction of clipped samples to decode a region
+    int clip_low = 5;                // Samples at or below this are underexposed
+    int clip_high = 250;             // Samples at or above this are overexposed
+};
+
+/**
+ * @brief Sharpness and exposure of a frame region
+ */
+struct RegionQuality {
+    double sharpness = 0.0;      // Lower of the x and y second-difference variances
+    double clipped_ratio = 0.0;  // Fraction of samples under- or overexposed
+    uint64_t samples = 0;
+
+    bool isBlurred(const FrameQualityConfig& config) const { return sharpness < config.min_sharpness; }
+    bool isClipped(const FrameQualityConfig& config) const { return clipped_ratio > config.max_clipped_ratio; }
+};
+
+/**
+ * @brief Per-tile sharpness and clipping estimate, to skip decoding motion-blurred regions
+ *
+ * A subsampled grid of the gray camera frame accumulates, per tile, the
+ * second differences along x and y (the two halves of the 4-neighbour
+ * Laplacian) and the number of clipped samples. Preprocessing passes that
+ * already stream the gray rows feed them through begin()/addRow()/end(),
+ * so the estimate costs no pass of its own; estimate() runs it over a
+ * whole frame when no such pass exists. A region's quality combines the tiles it overlaps, so the
+ * variances are exact over the sampled pixels of those tiles.
+ *
+ * Sharpness is the lower of the two variances rather than the variance of
+ * the full Laplacian: motion blur along one axis leaves edges across the
+ * other axis sharp, and the full Laplacian hides it. Around a 120-pixel
+ * marker, a sharp frame measures above 1000 and a slide blurring it over
+ * 9 or 15 pixels about 30 or 20; sensor noise of sigma gray levels adds
+ * about 6 sigma^2, so noisy cameras need a higher min_sharpness.
+ *
+ * Not thread-safe; each ImageProcessor owns one.
+ */
+class FrameQualityMap {
+public:
+    /**
+     * @brief Constructor
+     * @param config Tile and threshold configuration
+     */
+    explicit FrameQualityMap(const FrameQualityConfig& config = FrameQualityConfig());
+
+    /**
+     * @brief Set the tile and threshold configuration
+     * @param config Configuration
+     */
+    void setConfig(const FrameQualityConfig& config);
+
+    /**
+     * @brief Get the configuration
+     * @return Configuration
+     */
+    const FrameQualityConfig& getConfig() const;
+
+    /**
+     * @brief Estimate per-tile quality for a frame
+     * @param frame 8-bit gray or BGR camera frame
+     * @return true if estimated, false if the frame format is unsupported
+     */
+    bool estimate(const cv::Mat& frame);
+
+    /**
+     * @brief Start an estimate fed row by row
+     * @param frame_size Size of the gray frame
+     */
+    void begin(cv::Size frame_size);
+
+    /**
+     * @brief Accumulate one gray row
+     *
+     * Rows off the sample grid, and the first and last row, are ignored, so
+     * a pass can feed every row it has read together with its neighbours.
+     * @param y Row index
+     * @param above Row y - 1
+     * @param row Row y
+     * @param below Row y + 1
+     */
+    void addRow(int y, const uchar* above, const uchar* row, const uchar* below);
+
+    /**
+     * @brief Finish an estimate fed row by row
+     */
+    void end();
+
+    /**
+     * @brief Check whether an estimate for the current frame exists
+     * @return true after a successful estimate
+     */
+    bool isValid() const;
+
+    /**
+     * @brief Get the quality of a region
+     * @param region Region in pixels (clipped to the frame)
+     * @return Combined quality of the tiles the region overlaps
+     */
+    RegionQuality measure(const cv::Rect& region) const;
+
+    /**
+     * @brief Check whether a region is sharp and exposed well enough to decode
+     * @param region Region in pixels
+     * @return true if decodable or no estimate exists, false otherwise
+     */
+    bool isDecodable(const cv::Rect& region) const;
+
+    /**
+     * @brief Get the bytes held by the tile grid
+     * @return Bytes
+     */
+    size_t getMemoryBytes() const;
+
+private:
+    struct Tile {
+        uint32_t samples = 0;
+        uint32_t clipped = 0;
+        int64_t sum_xx = 0;
+        int64_t sq_xx = 0;
+        int64_t sum_yy = 0;
+        int64_t sq_yy = 0;
+    };
+
+    FrameQualityConfig config_;
+    cv::Size frame_size_;
+    int cols_;
+    int rows_;
+    std::vector<Tile> tiles_;
+    bool valid_;
+
+    // Gray conversion of BGR frames passed to estimate()
+    cv::Mat gray_;
+};
+
+} // namespace CodiceCam
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace CodiceCam {
+
+/**
+ * @brief Idle power-save configuration
+ */
+struct IdleConfig {
+    int idle_after_ms = 30000;      // No markers and no scene change for this long enters idle mode
+    int check_interval_ms = 500;    // Motion check period; in idle mode also the frame rate (2 FPS)
+    int downscale = 8;              // Motion check resolution divisor
+    int pixel_threshold = 12;       // Gray-level difference counted as a changed pixel
+    double motion_fraction = 0.002; // Changed pixel fraction counted as scene change
+};
+
+/**
+ * @brief Idle state machine for closed-venue power saving
+ *
+ * Tracks the last activity (a marker reported by the pipeline, or a scene
+ * change seen by the motion check). After idle_after_ms without activity
+ * the monitor is idle: CameraManager keeps grabbing so frames stay fresh,
+ * but decodes only one frame per check_interval_ms, runs just the motion
+ * check on it (a downscaled grayscale difference against the previous
+ * check) and skips detection (SKIPPED_STATIC, "idle" / "idle_static").
+ * The first checked frame that shows motion wakes the monitor and is
+ * processed at once, so the first token placed on the table costs at most
+ * one check interval.
+ *
+ * checkFrame() and isIdle() are called from the capture thread,
+ * reportMarkers() from any thread.
+ */
+class IdleMonitor {
+public:
+    /**
+     * @brief Constructor
+     * @param config Idle configuration
+     */
+    explicit IdleMonitor(const IdleConfig& config = IdleConfig());
+
+    /**
+     * @brief Report the markers found in a processed frame
+     * @param marker_count Number of markers (any marker counts as activity)
+     */
+    void reportMarkers(size_t marker_count);
+
+    /**
+     * @brief Compare a frame with the previous checked frame
+     * @param frame Captured frame
+     * @param now Capture time
+     * @return true if the scene changed (activity), false otherwise
+     */
+    bool checkFrame(const cv::Mat& frame, std::chrono::steady_clock::time_point now);
+
+    /**
+     * @brief Check whether a motion check is due
+     * @param now Current time
+     * @return true if check_interval_ms has passed since the last check
+     */
+    bool isCheckDue(std::chrono::steady_clock::time_point now) const;
+
+    /**
+     * @brief Check whether the table is idle (and log state changes)
+     * @param now Current time
+     * @return true if idle, false otherwise
+     */
+    bool isIdle(std::chrono::steady_clock::time_point now);
+
+    /**
+     * @brief Get statistics
+     * @return Statistics string
+     */
+    std::string getStatistics() const;
+
+private:
+    IdleConfig config_;
+
+    // steady_clock ticks of the last activity, written by the pipeline and the capture thread
+    std::atomic<int64_t> last_activity_;
+    std::chrono::steady_clock::time_point last_check_;
+    std::chrono::steady_clock::time_point idle_since_;
+    bool idle_;
+
+    // Previous checked frame (downscaled grayscale) and scratch buffers
+    cv::Mat reference_;
+    cv::Mat small_;
+    cv::Mat diff_;
+
+    // Statistics
+    std::atomic<uint64_t> idle_entries_;
+    std::atomic<uint64_t> wakeups_;
+    std::atomic<uint64_t> checks_;
+    std::atomic<int64_t> idle_ms_;
+    std::atomic<bool> idle_now_;
+
+    void markActivity(std::chrono::steady_clock::time_point now);
+};
+
+} // namespace CodiceCam
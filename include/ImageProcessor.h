@@ -3,6 +3,11 @@
 #include <opencv2/opencv.hpp>
 #include <memory>
 #include <vector>
+#include "ContourTracer.h"
+#include "FastBlur.h"
+#include "FrameQuality.h"
+#include "PerfCounters.h"
+#include "SizePriorMap.h"
 
 namespace CodiceCam {
 
@@ -52,6 +57,19 @@ public:
      */
     void setPreprocessingParams(int blur_kernel_size = 5, double contrast_alpha = 1.2, int brightness_beta = 10);
 
+    /**
+     * @brief Enable the fused fixed-point blur path
+     *
+     * When enabled and blur_kernel_size > 1, grayscale conversion, blur and
+     * contrast run as one FastBlur pass instead of
+     * cvtColor + GaussianBlur + convertTo. Output matches cv::GaussianBlur
+     * for kernels up to 11 and differs by at most 2 gray levels above
+     * (test_fast_blur). Disabled by default, so edges and thresholds only
+     * move for callers that ask for it.
+     * @param enable true to use FastBlur, false to use cv::GaussianBlur
+     */
+    void setFastBlurEnabled(bool enable);
+
     /**
      * @brief Set edge detection parameters
      * @param low_threshold Canny edge detection low threshold
@@ -67,6 +85,74 @@ public:
      */
     void setContourFilterParams(double min_area = 1000, double max_area = 50000, double min_perimeter = 100);
 
+    /**
+     * @brief Set the largest marker side length the detector accepts
+     *
+     * Together with the maximum contour area, this bounds the contours the
+     * bounded tracer follows to completion.
+     * @param max_marker_size Largest marker side in pixels (0 = derive from the maximum contour area)
+     */
+    void setMaxMarkerSize(int max_marker_size);
+
+    /**
+     * @brief Enable bounded contour tracing
+     *
+     * When enabled (default), contours are traced by BoundedContourTracer,
+     * which abandons any contour whose bounding box or length exceeds what a
+     * marker could produce instead of following it to the end. When disabled,
+     * cv::findContours is used.
+     * @param enable true to use BoundedContourTracer, false to use cv::findContours
+     */
+    void setBoundedTracingEnabled(bool enable);
+
+    /**
+     * @brief Set the per-location marker size prior used by filterContour
+     *
+     * Contours whose size (square root of the area) does not fit the prior
+     * at their location are rejected after the area check.
+     * @param size_prior Size prior (shared, may be updated concurrently), or nullptr to disable
+     */
+    void setSizePrior(std::shared_ptr<SizePriorMap> size_prior);
+
+    /**
+     * @brief Enable the per-tile sharpness and exposure estimate
+     *
+     * When enabled, processFrame estimates the quality of the gray camera
+     * frame from the rows its contrast (or FastBlur) pass already reads, so
+     * the detector can skip decoding candidates in motion-blurred or clipped
+     * regions. With cv::GaussianBlur the estimate needs a pass of its own.
+     * Disabled by default.
+     * @param enable true to estimate quality in processFrame
+     * @param config Tile and threshold configuration
+     */
+    void setQualityGating(bool enable, const FrameQualityConfig& config = FrameQualityConfig());
+
+    /**
+     * @brief Check whether the quality estimate is enabled
+     * @return true if enabled
+     */
+    bool isQualityGatingEnabled() const;
+
+    /**
+     * @brief Estimate quality for a frame preprocessed elsewhere
+     * @param input_frame Camera frame (gray or BGR)
+     * @return true if estimated, false otherwise
+     */
+    bool estimateQuality(const cv::Mat& input_frame);
+
+    /**
+     * @brief Get the quality estimate of the last frame
+     * @return Quality map (invalid if gating is disabled)
+     */
+    const FrameQualityMap& getQualityMap() const;
+
+    /**
+     * @brief Set the stage profiler (benchmark mode)
+     * @param profiler Profiler to record the preprocess, detectEdges and
+     *                 findContours stages into, or nullptr to disable
+     */
+    void setProfiler(StageProfiler* profiler);
+
     /**
      * @brief Get current preprocessing parameters
      * @return String description of current parameters
@@ -79,6 +165,30 @@ public:
      */
     const cv::Mat& getPreprocessedFrame() const;
 
+    /**
+     * @brief Get the number of frames whose contour list was truncated
+     * @return Frame count
+     */
+    uint64_t getTruncatedFrameCount() const;
+
+    /**
+     * @brief Get the total number of contours dropped by truncation
+     * @return Contour count
+     */
+    uint64_t getTruncatedContourCount() const;
+
+    /**
+     * @brief Get the total number of contours abandoned by the bounded tracer
+     * @return Contour count
+     */
+    uint64_t getAbandonedContourCount() const;
+
+    /**
+     * @brief Get the bytes held between frames (preprocessed frame and scratch buffers)
+     * @return Bytes
+     */
+    size_t getMemoryBytes() const;
+
 private:
     // Preprocessing parameters
     int blur_kernel_size_;
@@ -94,11 +204,40 @@ private:
     double max_contour_area_;
     double min_contour_perimeter_;
 
+    // Fused fixed-point blur
+    FastBlur fast_blur_;
+    bool fast_blur_enabled_;
+
+    // Bounded contour tracing
+    BoundedContourTracer contour_tracer_;
+    bool bounded_tracing_enabled_;
+    int max_marker_size_;
+
+    // Per-tile sharpness and exposure of the last frame
+    FrameQualityMap quality_map_;
+    bool quality_gating_enabled_;
+
+    // Contrast/brightness lookup table, rebuilt when the parameters change
+    cv::Mat contrast_lut_;
+    double contrast_lut_alpha_;
+    int contrast_lut_beta_;
+
+    // Per-location size prior (nullptr = global area window only)
+    std::shared_ptr<SizePriorMap> size_prior_;
+
+    // Stage profiler (not owned, nullptr when benchmark mode is off)
+    StageProfiler* profiler_;
+
+    // Contour truncation counters
+    uint64_t truncated_frames_;
+    uint64_t truncated_contours_;
+
     // Store preprocessed frame for pattern reading
     cv::Mat preprocessed_frame_;
 
     // Internal processing methods
     cv::Mat preprocessFrame(const cv::Mat& input_frame);
+    void applyContrast(const cv::Mat& gray, cv::Mat& output, FrameQualityMap* quality);
     cv::Mat detectEdges(const cv::Mat& grayscale_frame);
     bool filterContour(const std::vector<cv::Point>& contour) const;
 
@@ -1,9 +1,12 @@
 #pragma once
 
 #include <opencv2/opencv.hpp>
+#include <chrono>
 #include <vector>
 #include <memory>
 #include "ImageProcessor.h"
+#include "PerfCounters.h"
+#include "SizePriorMap.h"
 
 namespace CodiceCam {
 
@@ -21,6 +24,59 @@ struct CodiceMarker {
     CodiceMarker() : id(-1), angle(0.0), deskew_angle(0.0), confidence(0.0) {}
 };
 
+/**
+ * @brief Pixel format of the camera frame given to the detector
+ */
+enum class FrameFormat {
+    BGR,   // 8-bit 3-channel color frame
+    GRAY   // 8-bit 1-channel frame (e.g. the camera's Y plane in low-memory mode)
+};
+
+/**
+ * @brief What a caller hands to MarkerDetector::detectMarkers
+ *
+ * The camera frame is always required, since markers are sampled from it.
+ * If the caller already ran ImageProcessor::processFrame on that frame, it
+ * passes the preprocessed frame and edge image from the same call and the
+ * detector starts at contour finding; otherwise the detector preprocesses
+ * the camera frame itself. Nothing is read from an earlier frame.
+ */
+struct FrameInput {
+    cv::Mat frame;                 // Camera frame (BGR or gray)
+    FrameFormat format;
+    cv::Mat preprocessed;          // Preprocessed gray frame (empty if not supplied)
+    cv::Mat edges;                 // Edge image from the same processFrame call (empty if not supplied)
+    std::chrono::steady_clock::time_point capture_time;  // Epoch if unknown
+
+    FrameInput() : format(FrameFormat::BGR) {}
+
+    /**
+     * @brief Check whether preprocessing has already been run
+     * @return true if preprocessed frame and edges are supplied
+     */
+    bool isPreprocessed() const { return !edges.empty(); }
+
+    /**
+     * @brief Describe a raw camera frame (format from its channel count)
+     * @param frame BGR or gray camera frame
+     * @param capture_time When the frame was captured
+     * @return Frame input the detector preprocesses itself
+     */
+    static FrameInput fromCamera(const cv::Mat& frame,
+                                 std::chrono::steady_clock::time_point capture_time = {});
+
+    /**
+     * @brief Describe a camera frame the caller already preprocessed
+     * @param frame BGR or gray camera frame
+     * @param preprocessed Preprocessed frame from ImageProcessor::processFrame
+     * @param edges Edge image from the same processFrame call
+     * @param capture_time When the frame was captured
+     * @return Frame input the detector takes straight to contour finding
+     */
+    static FrameInput fromPreprocessed(const cv::Mat& frame, const cv::Mat& preprocessed, const cv::Mat& edges,
+                                       std::chrono::steady_clock::time_point capture_time = {});
+};
+
 /**
  * @brief Detects and decodes Codice markers in camera frames
  *
@@ -40,13 +96,20 @@ public:
     ~MarkerDetector();
 
     /**
-     * @brief Detect markers in a camera frame
-     * @param frame Input camera frame
+     * @brief Detect markers in a frame, skipping the stages the caller already ran
+     * @param input Camera frame, plus preprocessed frame and edges if already computed
+     * @param markers Output vector of detected markers
+     * @return true if detection successful, false otherwise
+     */
+    bool detectMarkers(const FrameInput& input, std::vector<CodiceMarker>& markers);
+
+    /**
+     * @brief Detect markers in a raw camera frame
+     * @param frame Input camera frame (BGR or gray)
      * @param markers Output vector of detected markers
      * @return true if detection successful, false otherwise
      */
     bool detectMarkers(const cv::Mat& frame, std::vector<CodiceMarker>& markers);
-    bool detectMarkers(const cv::Mat& original_frame, const cv::Mat& processed_frame, std::vector<CodiceMarker>& markers);
 
     /**
      * @brief Set detection parameters
@@ -56,6 +119,72 @@ public:
      */
     void setDetectionParams(int min_marker_size = 40, int max_marker_size = 200, double min_confidence = 0.7);
 
+    /**
+     * @brief Set the per-location marker size prior
+     *
+     * Off by default: candidates are gated on the global size window only.
+     * Pass a new map to learn from the markers this detector accepts, a
+     * shared map to pool learning across detectors, or a calibrated map
+     * loaded from file.
+     * @param size_prior Size prior, or nullptr to disable
+     */
+    void setSizePrior(std::shared_ptr<SizePriorMap> size_prior);
+
+    /**
+     * @brief Get the per-location marker size prior
+     * @return Size prior, or nullptr if disabled
+     */
+    std::shared_ptr<SizePriorMap> getSizePrior() const;
+
+    /**
+     * @brief Enable/disable deterministic mode
+     *
+     * Detection output then depends only on the frame and the configuration:
+     * the size prior keeps gating candidates but stops learning, and no
+     * markers are coasted, so a frame gives the same markers whichever frames
+     * this detector saw before.
+     * Used to compare serial and frame-parallel runs (SerialEquivalenceChecker).
+     * @param enable true to freeze learned state, false to learn
+     */
+    void setDeterministicMode(bool enable);
+
+    /**
+     * @brief Enable/disable decode gating on frame sharpness and exposure
+     *
+     * The camera frame's per-tile sharpness and clipping are estimated during
+     * preprocessing. Candidates in motion-blurred or clipped regions are not
+     * warped or decoded. A marker from the previous frame that was not
+     * decoded is coasted (reported with its last ID and angle) when a skipped
+     * candidate lies within one marker side of it, moved to that candidate, or
+     * when its last region is itself low quality, for up to max_coast_ms
+     * after its last decode (frame capture times, so the window does not
+     * depend on the frame rate). Disabled by default: the default
+     * thresholds are not yet tuned on recorded frames, and they apply to the
+     * gray frame before contrast adjustment. Detectors that see only
+     * every Nth frame (frame-parallel contexts) should pass 0: their last
+     * frame is not the previous frame, so coasting would replay stale state.
+     * @param enable true to gate decoding, false to decode every candidate
+     * @param config Tile and threshold configuration
+     * @param max_coast_ms Time a marker may be coasted without a decode (0 = no coasting)
+     */
+    void setQualityGating(bool enable, const FrameQualityConfig& config = FrameQualityConfig(), int max_coast_ms = 250);
+
+    /**
+     * @brief Enable/disable low-memory mode
+     *
+     * Debug mode and the live debug window clone full-resolution frames
+     * every frame (and the window keeps its own copy), so low-memory mode
+     * turns them off and refuses to turn them on.
+     * @param enable true to keep no debug frames, false to allow them
+     */
+    void setLowMemoryMode(bool enable);
+
+    /**
+     * @brief Get the bytes held between frames by this detector's image processor
+     * @return Bytes
+     */
+    size_t getMemoryBytes() const;
+
     /**
      * @brief Enable/disable debug visualization
      * @param enable true to enable debug output, false to disable
@@ -80,6 +209,25 @@ public:
      */
     std::string getDetectionStats() const;
 
+    /**
+     * @brief Enable/disable benchmark mode
+     *
+     * Profiles the preprocess, detectEdges, findContours, approxQuad,
+     * extractMarker and decodeMarker stages. With hardware counters, each
+     * stage also reports cycles, IPC, cache misses and branch misses per
+     * frame; when perf_event_open is unavailable (e.g. in a container) it
+     * falls back to wall-clock time. Enabling resets the collected profile.
+     * @param enable true to enable benchmark mode, false to disable
+     * @param use_hardware_counters true to read hardware performance counters
+     */
+    void setBenchmarkMode(bool enable, bool use_hardware_counters = true);
+
+    /**
+     * @brief Get the per-stage benchmark report
+     * @return Report string (empty if benchmark mode was never enabled)
+     */
+    std::string getBenchmarkReport() const;
+
     /**
      * @brief Test marker decoding with a pre-extracted marker region
      * @param marker_region Pre-extracted 100x100 marker region
@@ -96,15 +244,36 @@ private:
     int min_marker_size_;
     int max_marker_size_;
     double min_confidence_;
+    std::shared_ptr<SizePriorMap> size_prior_;  // Learned from accepted markers, gates contours (nullptr = off)
+    bool deterministic_mode_;  // Size prior frozen, output independent of frame history
     bool debug_mode_;
     bool debug_window_enabled_;
     bool verbose_mode_;
     bool quiet_mode_;  // Suppress most debug output
+    bool low_memory_mode_;  // No debug frames or windows
+
+    // Benchmark mode stage profiler (null when disabled)
+    std::unique_ptr<StageProfiler> profiler_;
+    bool benchmark_mode_;
 
     // Detection statistics
     mutable int total_frames_processed_;
     mutable int total_markers_detected_;
     mutable int total_detection_attempts_;
+    mutable int total_processing_errors_;  // Frames for which detectMarkers returned false
+    double total_capture_latency_ms_;  // Capture to end of detection, frames with a capture time
+    int capture_latency_samples_;
+
+    // Quality gating: candidates skipped this frame and markers that may be coasted
+    struct TrackedMarker {
+        CodiceMarker marker;
+        std::chrono::steady_clock::time_point last_decoded;  // Capture time of the last decode
+    };
+    std::vector<TrackedMarker> tracked_markers_;
+    std::vector<std::vector<cv::Point2f>> low_quality_candidates_;
+    int max_coast_ms_;
+    mutable int total_candidates_skipped_;
+    mutable int total_markers_coasted_;
 
     // Location-based deduplication for debug images
     std::vector<cv::Point2f> previous_marker_locations_;
@@ -118,6 +287,8 @@ private:
     bool decodeMarker(const cv::Mat& marker_region, int& marker_id, double& confidence, const std::string& timestamp = "", int marker_index = -1);
     bool validateMarkerPattern(const cv::Mat& binary_marker, int& marker_id, double& confidence);
     bool hasLocationChanged(const std::vector<CodiceMarker>& current_markers);
+    bool validateInput(const FrameInput& input) const;
+    void coastTrackedMarkers(std::vector<CodiceMarker>& markers, std::chrono::steady_clock::time_point frame_time);
 
     /**
      * @brief Perspective transform to get square marker view
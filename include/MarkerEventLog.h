@@ -0,0 +1,187 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "MarkerStreamCodec.h"
+
+namespace CodiceCam {
+
+/**
+ * @brief Marker lifecycle event kinds written to the event log
+ */
+enum class MarkerEventKind : uint8_t {
+    DETECTED,
+    UPDATED,
+    LOST
+};
+
+/**
+ * @brief Event log configuration
+ */
+struct MarkerEventLogConfig {
+    std::string path = "marker_events.ndjson";  // File, FIFO, or "-" for stdout
+    bool log_frames = true;            // One line per frame with all markers
+    bool log_lifecycle = true;         // One line per DETECTED/LOST event
+    bool log_updates = false;          // Also log UPDATED events (one per marker per frame)
+    size_t max_file_bytes = 64 * 1024 * 1024;  // Rotate after this many bytes (0 = never)
+    int max_file_age_s = 3600;         // Rotate after this many seconds (0 = never)
+    size_t queue_records = 16384;      // Queue capacity in records (rounded up to a power of two)
+    size_t write_buffer_bytes = 1024 * 1024;  // stdio block buffer size
+    int flush_interval_ms = 1000;      // Flush the block buffer at least this often
+};
+
+/**
+ * @brief NDJSON marker event sink for analytics
+ *
+ * Writes one compact JSON object per line:
+ * - Frame: {"t":1700000000123,"f":42,"m":[{"id":5,"x":0.5123,"y":0.2500,"a":1.571,"c":0.93}]}
+ * - Lifecycle: {"t":1700000000123,"ev":"DETECTED","id":5,"s":12,"x":0.5123,"y":0.2500,"a":1.571}
+ *
+ * "t" is Unix time in milliseconds. The detection thread only copies POD
+ * records into a single-producer/single-consumer ring; a background thread
+ * formats them and writes through a block-buffered stdio stream. When the
+ * ring is full the frame or event is dropped and counted rather than
+ * blocking the caller. A frame is queued whole or not at all.
+ *
+ * Regular files are rotated by size and age: the current file is renamed to
+ * <path>.<YYYYmmdd-HHMMSS> and a new one is opened. FIFOs and stdout are
+ * never rotated.
+ *
+ * logFrame and logEvent must be called from one thread at a time (the
+ * thread that calls TUIOBridge::updateMarkers).
+ */
+class MarkerEventLog {
+public:
+    /**
+     * @brief Constructor
+     * @param config Log configuration
+     */
+    explicit MarkerEventLog(const MarkerEventLogConfig& config = MarkerEventLogConfig());
+
+    /**
+     * @brief Destructor (drains the queue and closes the file)
+     */
+    ~MarkerEventLog();
+
+    MarkerEventLog(const MarkerEventLog&) = delete;
+    MarkerEventLog& operator=(const MarkerEventLog&) = delete;
+
+    /**
+     * @brief Open the output and start the writer thread
+     *
+     * Opening a FIFO blocks until a reader connects.
+     * @return true if opened successfully, false otherwise
+     */
+    bool open();
+
+    /**
+     * @brief Drain the queue, stop the writer thread and close the output
+     *
+     * Waits for logFrame/logEvent calls already past their open check, so
+     * every record they queue is written before the output closes.
+     */
+    void close();
+
+    /**
+     * @brief Check if the log is open
+     * @return true if open
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Get the configuration
+     * @return Configuration
+     */
+    const MarkerEventLogConfig& getConfig() const;
+
+    /**
+     * @brief Queue one frame of markers
+     * @param markers Markers of the frame
+     * @param count Number of markers
+     * @return true if queued, false if disabled or dropped (full queue, or a non-finite or
+     *         out-of-range value)
+     */
+    bool logFrame(const StreamMarker* markers, size_t count);
+
+    /**
+     * @brief Queue one lifecycle event
+     * @param kind Event kind
+     * @param marker_id Codice marker ID
+     * @param session_id TUIO session ID
+     * @param x Normalized X position
+     * @param y Normalized Y position
+     * @param angle Rotation angle in radians
+     * @return true if queued, false if filtered or dropped (full queue, or a non-finite or
+     *         out-of-range value)
+     */
+    bool logEvent(MarkerEventKind kind, int marker_id, int session_id, float x, float y, float angle);
+
+    /**
+     * @brief Get statistics
+     * @return Statistics string
+     */
+    std::string getStatistics() const;
+
+private:
+    enum RecordType : uint8_t { FRAME_HEADER, FRAME_MARKER, LIFECYCLE_EVENT };
+
+    // Fixed-size record copied by the producer; formatted by the writer thread
+    struct Record {
+        int64_t time_ms;
+        uint64_t frame;
+        int32_t id;
+        int32_t session;
+        float x, y, angle, confidence;
+        uint32_t count;
+        RecordType type;
+        MarkerEventKind kind;
+    };
+
+    MarkerEventLogConfig config_;
+
+    // SPSC ring: the producer owns tail_, the writer owns head_
+    std::vector<Record> ring_;
+    size_t ring_mask_;
+    alignas(64) std::atomic<size_t> head_;
+    alignas(64) std::atomic<size_t> tail_;
+
+    // Writer thread
+    std::thread writer_thread_;
+    std::atomic<bool> running_;
+    std::atomic<int> producers_;  // logFrame/logEvent calls in flight; close() waits for them
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cv_;
+
+    // Output
+    FILE* file_;
+    bool rotatable_;
+    std::vector<char> write_buffer_;
+    size_t file_bytes_;
+    std::chrono::steady_clock::time_point file_opened_;
+    std::chrono::steady_clock::time_point last_flush_;
+
+    // Statistics
+    uint64_t next_frame_;
+    std::atomic<uint64_t> frames_logged_;
+    std::atomic<uint64_t> events_logged_;
+    std::atomic<uint64_t> frames_dropped_;
+    std::atomic<uint64_t> events_dropped_;
+    std::atomic<uint64_t> bytes_written_;
+    std::atomic<uint64_t> files_rotated_;
+
+    bool openOutput();
+    void closeOutput();
+    void rotate();
+    void writerLoop();
+    size_t drain();
+    void writeLine(const char* line, size_t length);
+};
+
+} // namespace CodiceCam
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "MarkerStreamCodec.h"
+
+namespace CodiceCam {
+
+/**
+ * @brief One stored marker observation
+ */
+struct HistoryRow {
+    int64_t time_ms;    // Unix time in milliseconds
+    int id;             // Codice marker ID
+    float x, y;         // Normalized position (0.0-1.0)
+    float angle;        // Rotation angle in radians
+    float confidence;   // Detection confidence (0.0-1.0)
+};
+
+/**
+ * @brief History store configuration
+ */
+struct MarkerHistoryConfig {
+    std::string directory = "marker_history";  // Segment directory (must exist)
+    uint64_t segment_rows = 1 << 20;           // Rows per segment file (~28 MiB)
+    size_t max_segments = 0;                   // Delete the oldest segments beyond this (0 = keep all)
+};
+
+/**
+ * @brief Append-only columnar store of per-frame marker positions
+ *
+ * Rows are stored in memory-mapped segment files, one column per field
+ * (time, ID, x, y, angle, confidence), each a contiguous array. A segment
+ * file is laid out as:
+ * - 4 KiB header: magic "CMHS", version, capacity, row count, min/max time
+ * - Block index: first timestamp of every BLOCK_ROWS rows
+ * - Columns: int64 time[capacity], int32 id[capacity], float x/y/angle/confidence[capacity]
+ *
+ * Rows are appended in time order, one frame per appendFrame call, and the
+ * row count in the header is advanced once per frame, so a crash loses at
+ * most the frame being written. The time index is two-level: segments are
+ * selected by their min/max time, then the block index and a binary search
+ * of the time column find the first row. Queries only touch the pages of the
+ * columns and row range they scan; closed segments are mapped read-only on
+ * demand.
+ *
+ * appendFrame must be called from one thread at a time; queries may run
+ * concurrently from other threads. POSIX only (mmap).
+ */
+class MarkerHistoryStore {
+public:
+    static constexpr uint64_t BLOCK_ROWS = 4096;
+
+    /**
+     * @brief Constructor
+     * @param config Store configuration
+     */
+    explicit MarkerHistoryStore(const MarkerHistoryConfig& config = MarkerHistoryConfig());
+
+    /**
+     * @brief Destructor (flushes and unmaps all segments)
+     */
+    ~MarkerHistoryStore();
+
+    MarkerHistoryStore(const MarkerHistoryStore&) = delete;
+    MarkerHistoryStore& operator=(const MarkerHistoryStore&) = delete;
+
+    /**
+     * @brief Open the store and index the existing segments
+     * @return true if opened successfully, false otherwise
+     */
+    bool open();
+
+    /**
+     * @brief Flush and close the store
+     */
+    void close();
+
+    /**
+     * @brief Check if the store is open
+     * @return true if open
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Append one frame of markers
+     * @param time_ms Unix time of the frame in milliseconds (non-decreasing)
+     * @param markers Markers of the frame
+     * @param count Number of markers
+     * @return true if appended, false otherwise
+     */
+    bool appendFrame(int64_t time_ms, const StreamMarker* markers, size_t count);
+
+    /**
+     * @brief Query rows of one marker (or all markers) in a time range
+     * @param marker_id Codice marker ID, or -1 for all markers
+     * @param t0_ms Range start (inclusive, Unix ms)
+     * @param t1_ms Range end (inclusive, Unix ms)
+     * @param rows Output rows in time order (appended)
+     * @return Number of rows found
+     */
+    size_t query(int marker_id, int64_t t0_ms, int64_t t1_ms, std::vector<HistoryRow>& rows) const;
+
+    /**
+     * @brief Accumulate a position heatmap over a time range
+     *
+     * Scans only the time, ID, x and y columns.
+     * @param marker_id Codice marker ID, or -1 for all markers
+     * @param t0_ms Range start (inclusive, Unix ms)
+     * @param t1_ms Range end (inclusive, Unix ms)
+     * @param grid_width Heatmap columns
+     * @param grid_height Heatmap rows
+     * @param heatmap Output counts, row-major grid_width x grid_height (resized and added to)
+     * @return Number of rows counted
+     */
+    size_t buildHeatmap(int marker_id, int64_t t0_ms, int64_t t1_ms,
+                        int grid_width, int grid_height, std::vector<uint32_t>& heatmap) const;
+
+    /**
+     * @brief Ask the OS to write dirty pages back (asynchronous)
+     */
+    void flush();
+
+    /**
+     * @brief Get statistics
+     * @return Statistics string
+     */
+    std::string getStatistics() const;
+
+private:
+    struct Segment;
+
+    // Column views of one segment, valid for rows [0, row_count)
+    struct ColumnView {
+        const int64_t* time;
+        const int32_t* id;
+        const float* x;
+        const float* y;
+        const float* angle;
+        const float* confidence;
+        const int64_t* block_index;
+        uint64_t row_count;
+    };
+
+    using RowVisitor = std::function<void(const ColumnView& view, uint64_t begin, uint64_t end)>;
+
+    MarkerHistoryConfig config_;
+    mutable std::mutex mutex_;
+    bool open_;
+
+    std::vector<std::shared_ptr<Segment>> segments_;  // Ordered by time; the last one is active
+    uint64_t rows_appended_;
+    uint64_t frames_appended_;
+
+    std::shared_ptr<Segment> createSegment(int64_t first_time_ms);
+    bool mapSegment(Segment& segment, bool writable) const;
+    void enforceRetention();
+    void scanRange(int64_t t0_ms, int64_t t1_ms, const RowVisitor& visitor) const;
+};
+
+} // namespace CodiceCam
@@ -0,0 +1,242 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace CodiceCam {
+
+/**
+ * @brief Marker state carried by the compact binary stream
+ *
+ * Positions are normalized (0.0-1.0) and angles are in radians, matching
+ * the values handed to TUIO.
+ */
+struct StreamMarker {
+    int id;             // Codice marker ID (0-4095)
+    float x, y;         // Normalized position (0.0-1.0)
+    float angle;        // Rotation angle in radians
+    float confidence;   // Detection confidence (0.0-1.0)
+
+    StreamMarker() : id(0), x(0.0f), y(0.0f), angle(0.0f), confidence(0.0f) {}
+};
+
+/**
+ * @brief Compact binary marker stream protocol
+ *
+ * An optional native alternative to TUIO for bandwidth-constrained links
+ * (enabled by TUIOStreamingConfig::enable_compression).
+ *
+ * ## Wire Format
+ * Every packet starts with the magic bytes 'C' 'M' and a packet type byte.
+ * Integers marked "varint" are LEB128, signed values are zigzag encoded,
+ * fixed-point values are little-endian uint16.
+ *
+ * - KEYFRAME: seq(varint) time_ms(varint) count(varint), then per marker
+ *   sorted by ID: id_gap(varint) x(u16) y(u16) angle(u16) confidence(u8)
+ * - DELTA: seq(varint) base_seq(varint) time_ms(varint)
+ *   removed_count(varint) removed id_gaps(varint...)
+ *   entry_count(varint), then per changed marker: id_gap(varint) flags(u8)
+ *   followed by x/y/angle as u16 (FLAG_ABSOLUTE) or zigzag varint deltas
+ *   against the base keyframe, and confidence(u8) when FLAG_CONFIDENCE is set.
+ *   Markers of the base keyframe that are neither removed nor listed are
+ *   unchanged.
+ * - ACK (receiver -> sender): keyframe_seq(varint)
+ *
+ * Deltas always reference the last keyframe the receiver acknowledged, so a
+ * lost delta never corrupts later frames.
+ */
+namespace MarkerStream {
+    constexpr uint8_t MAGIC_0 = 'C';
+    constexpr uint8_t MAGIC_1 = 'M';
+
+    constexpr uint8_t PACKET_KEYFRAME = 1;
+    constexpr uint8_t PACKET_DELTA = 2;
+    constexpr uint8_t PACKET_ACK = 3;
+
+    constexpr uint8_t FLAG_ABSOLUTE = 0x01;
+    constexpr uint8_t FLAG_CONFIDENCE = 0x02;
+
+    /**
+     * @brief Quantized marker state (fixed-point)
+     */
+    struct QuantizedMarker {
+        uint16_t x;
+        uint16_t y;
+        uint16_t angle;
+        uint8_t confidence;
+    };
+
+    using Snapshot = std::map<int, QuantizedMarker>;
+
+    QuantizedMarker quantize(const StreamMarker& marker);
+    StreamMarker dequantize(int id, const QuantizedMarker& quantized);
+
+    /**
+     * @brief Size in bytes of one TUIO 1.1 /tuio/2Dobj bundle
+     * @param alive_count Number of objects in the alive message
+     * @param updated_count Number of set messages in the bundle
+     * @return OSC bundle payload size in bytes
+     */
+    size_t tuio11BundleBytes(size_t alive_count, size_t updated_count);
+
+    /**
+     * @brief Size in bytes of one TUIO 1.1 2Dobj set message (incl. bundle element size)
+     */
+    size_t tuio11SetMessageBytes();
+}
+
+/**
+ * @brief Encodes marker frames into keyframe/delta packets
+ */
+class MarkerStreamEncoder {
+public:
+    /**
+     * @brief Constructor
+     * @param keyframe_interval Maximum number of frames between keyframes
+     */
+    explicit MarkerStreamEncoder(int keyframe_interval = 30);
+
+    /**
+     * @brief Encode one frame of markers
+     * @param markers Markers visible in this frame
+     * @param timestamp_ms Frame timestamp in milliseconds
+     * @return Encoded packet (valid until the next call)
+     */
+    const std::vector<uint8_t>& encode(const std::vector<StreamMarker>& markers, uint32_t timestamp_ms);
+
+    /**
+     * @brief Mark a keyframe as received by the remote decoder
+     * @param keyframe_seq Sequence number of the keyframe
+     * @return true if the keyframe was pending, false otherwise
+     */
+    bool acknowledge(uint32_t keyframe_seq);
+
+    /**
+     * @brief Handle a raw ACK packet from the remote decoder
+     * @param data Packet data
+     * @param size Packet size
+     * @return true if a pending keyframe was acknowledged
+     */
+    bool processAckPacket(const uint8_t* data, size_t size);
+
+    /**
+     * @brief Treat every keyframe as delivered as soon as it is sent
+     *
+     * Used when there is no back channel for ACKs. A lost keyframe then
+     * makes the receiver drop deltas until the next keyframe interval.
+     * @param enable true to assume delivery
+     */
+    void setAssumeDelivered(bool enable);
+
+    /**
+     * @brief Force the next frame to be a keyframe
+     */
+    void requestKeyframe();
+
+    /**
+     * @brief Get statistics
+     * @return Statistics string
+     */
+    std::string getStatistics() const;
+
+    uint64_t getBytesEncoded() const { return total_bytes_; }
+    uint64_t getMarkersEncoded() const { return total_markers_; }
+
+private:
+    int keyframe_interval_;
+    bool assume_delivered_;
+    bool force_keyframe_;
+    uint32_t next_seq_;
+    int frames_since_keyframe_;
+
+    bool has_acked_keyframe_;
+    uint32_t acked_seq_;
+    MarkerStream::Snapshot acked_snapshot_;
+    std::map<uint32_t, MarkerStream::Snapshot> pending_keyframes_;
+
+    std::vector<uint8_t> packet_;
+
+    // Statistics
+    uint64_t total_keyframes_;
+    uint64_t total_deltas_;
+    uint64_t total_bytes_;
+    uint64_t total_markers_;
+
+    void encodeKeyframe(uint32_t seq, uint32_t timestamp_ms, const MarkerStream::Snapshot& snapshot);
+    void encodeDelta(uint32_t seq, uint32_t timestamp_ms, const MarkerStream::Snapshot& snapshot);
+};
+
+/**
+ * @brief Reference decoder for the compact binary marker stream
+ */
+class MarkerStreamDecoder {
+public:
+    MarkerStreamDecoder();
+
+    /**
+     * @brief Decode one packet
+     * @param data Packet data
+     * @param size Packet size
+     * @param markers Output markers of the decoded frame
+     * @param timestamp_ms Output frame timestamp
+     * @return true if a frame was decoded, false if the packet is malformed
+     *         or references a keyframe this decoder has not received
+     */
+    bool decode(const uint8_t* data, size_t size, std::vector<StreamMarker>& markers, uint32_t& timestamp_ms);
+
+    /**
+     * @brief Check whether a keyframe is waiting to be acknowledged
+     */
+    bool hasPendingAck() const;
+
+    /**
+     * @brief Build the ACK packet for the latest keyframe and clear the pending flag
+     * @return ACK packet bytes
+     */
+    std::vector<uint8_t> takeAckPacket();
+
+    /**
+     * @brief Get statistics
+     * @return Statistics string
+     */
+    std::string getStatistics() const;
+
+private:
+    std::map<uint32_t, MarkerStream::Snapshot> keyframes_;
+    bool ack_pending_;
+    uint32_t ack_seq_;
+
+    uint64_t frames_decoded_;
+    uint64_t frames_rejected_;
+};
+
+/**
+ * @brief Bandwidth comparison between the binary stream and TUIO 1.1
+ */
+struct MarkerStreamBenchmarkResult {
+    int marker_count = 0;
+    int frames = 0;
+    double binary_bytes_per_marker = 0.0;
+    double tuio_bytes_per_marker = 0.0;
+    double compression_ratio = 0.0;
+    bool round_trip_ok = false;
+
+    std::string toString() const;
+};
+
+/**
+ * @brief Run a synthetic bytes-per-marker benchmark
+ * @param marker_count Number of simultaneously visible markers
+ * @param frames Number of frames to encode
+ * @param moving_fraction Fraction of markers moving in each frame (0.0-1.0)
+ * @param keyframe_interval Keyframe interval used by the encoder
+ * @return Benchmark result (decoded output is verified against the input)
+ */
+MarkerStreamBenchmarkResult benchmarkMarkerStream(int marker_count, int frames,
+                                                  double moving_fraction = 0.25,
+                                                  int keyframe_interval = 30);
+
+} // namespace CodiceCam
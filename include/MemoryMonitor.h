@@ -0,0 +1,101 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace CodiceCam {
+
+/**
+ * @brief Process memory report: RSS, peak RSS and per-subsystem usage against a target budget
+ *
+ * RSS and peak RSS (high-water mark) are read from /proc/self/status.
+ * Subsystems register a callback returning the bytes they currently hold
+ * (frame buffers, scratch buffers); the report lists each one next to the
+ * process totals and the target budget for the frame size.
+ *
+ * Target budget (low-memory mode): a fixed base for code, OpenCV, TUIO and
+ * the display client, plus per-pixel bytes for the camera (raw buffer and
+ * Y plane) and for each frame in flight (Y plane, preprocessed, edges and
+ * tracer labels, one byte per pixel each):
+ *
+ *     budget = BASE_BYTES + pixels * (CAMERA_BYTES_PER_PIXEL + frames_in_flight * FRAME_BYTES_PER_PIXEL)
+ *
+ * | Resolution | 1 frame in flight | 4 frames in flight |
+ * |------------|-------------------|--------------------|
+ * | 1280x720   | 69 MiB            | 80 MiB             |
+ * | 1920x1080  | 76 MiB            | 100 MiB            |
+ * | 3840x2160  | 111 MiB           | 206 MiB            |
+ *
+ * On systems without /proc, RSS reads as 0 and only subsystems are listed.
+ */
+class MemoryMonitor {
+public:
+    static constexpr size_t BASE_BYTES = 64 * 1024 * 1024;
+    static constexpr size_t CAMERA_BYTES_PER_PIXEL = 2;
+    static constexpr size_t FRAME_BYTES_PER_PIXEL = 4;
+
+    using BytesFunction = std::function<size_t()>;
+
+    /**
+     * @brief Constructor
+     * @param frame_size Frame size the budget is computed for
+     * @param frames_in_flight Frames being processed at once
+     */
+    MemoryMonitor(const cv::Size& frame_size, int frames_in_flight = 1);
+
+    /**
+     * @brief Register a subsystem
+     * @param name Subsystem name in the report
+     * @param bytes Returns the bytes the subsystem currently holds (called from getStatistics)
+     */
+    void addSubsystem(const std::string& name, BytesFunction bytes);
+
+    /**
+     * @brief Get the target budget for the configured frame size
+     * @return Budget in bytes
+     */
+    size_t getTargetBytes() const;
+
+    /**
+     * @brief Get statistics (RSS, peak RSS, budget and subsystems)
+     * @return Statistics string
+     */
+    std::string getStatistics() const;
+
+    /**
+     * @brief Get the target budget for a frame size
+     * @param frame_size Frame size
+     * @param frames_in_flight Frames being processed at once
+     * @return Budget in bytes
+     */
+    static size_t targetBytes(const cv::Size& frame_size, int frames_in_flight);
+
+    /**
+     * @brief Read the current resident set size
+     * @return Bytes, or 0 if unknown
+     */
+    static size_t readRssBytes();
+
+    /**
+     * @brief Read the peak resident set size
+     * @return Bytes, or 0 if unknown
+     */
+    static size_t readPeakRssBytes();
+
+private:
+    struct Subsystem {
+        std::string name;
+        BytesFunction bytes;
+    };
+
+    cv::Size frame_size_;
+    int frames_in_flight_;
+    mutable std::mutex mutex_;
+    std::vector<Subsystem> subsystems_;
+};
+
+} // namespace CodiceCam
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace CodiceCam {
+
+/**
+ * @brief Snapshot of the hardware counters of the calling thread
+ */
+struct PerfSample {
+    uint64_t cycles = 0;
+    uint64_t instructions = 0;
+    uint64_t cache_misses = 0;
+    uint64_t branch_misses = 0;
+};
+
+/**
+ * @brief Hardware performance counters of one thread (Linux perf_event_open)
+ *
+ * Opens cycles, instructions, cache-misses and branch-misses as one event
+ * group so all four are scheduled together, and scales the values when the
+ * kernel multiplexes the PMU. Counters only count the thread that called
+ * open(). In containers and VMs perf_event_open is often denied
+ * (perf_event_paranoid, seccomp) or has no PMU; open() then fails and
+ * getUnavailableReason() says why. Events the CPU does not support are
+ * skipped individually and read as 0.
+ */
+class PerfCounters {
+public:
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    /**
+     * @brief Open and enable the counter group for the calling thread
+     * @return true if at least the cycle counter is available
+     */
+    bool open();
+
+    /**
+     * @brief Close the counter group
+     */
+    void close();
+
+    /**
+     * @brief Check whether the counters are open
+     * @return true if open
+     */
+    bool isAvailable() const;
+
+    /**
+     * @brief Get the reason the counters are unavailable
+     * @return Reason string (empty if available)
+     */
+    const std::string& getUnavailableReason() const;
+
+    /**
+     * @brief Read the current counter values
+     * @param sample Output counter values (cumulative since open)
+     * @return true if read successfully
+     */
+    bool read(PerfSample& sample) const;
+
+private:
+    enum Event { CYCLES, INSTRUCTIONS, CACHE_MISSES, BRANCH_MISSES, EVENT_COUNT };
+
+    int fds_[EVENT_COUNT];
+    int slots_[EVENT_COUNT];  // Position of each event in the group read, -1 if not opened
+    int group_size_;
+    std::string unavailable_reason_;
+};
+
+/**
+ * @brief Aggregates wall-clock time and hardware counters per pipeline stage
+ *
+ * Stages are measured with the Scope guard. Hardware counters are opened
+ * lazily by the first thread that measures a stage. Once a scope is entered
+ * from another thread (a detector driven from several threads), counters
+ * are off for the profiler's lifetime and every stage records wall-clock
+ * time only, as when counters are unavailable: one thread's counts divided
+ * by every thread's frames would be meaningless. The counts exclude work a
+ * stage hands to the worker pool (OpenCV parallel_for), which the report
+ * states; wall time includes it.
+ * Stages should not nest, otherwise the outer stage includes the inner one.
+ * Thread-safe.
+ */
+class StageProfiler {
+public:
+    /**
+     * @brief Measures one stage for the lifetime of the guard
+     */
+    class Scope {
+    public:
+        Scope(StageProfiler* profiler, const char* stage);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        StageProfiler* profiler_;
+        const char* stage_;
+        bool has_counters_;
+        PerfSample start_counters_;
+        std::chrono::steady_clock::time_point start_time_;
+    };
+
+    /**
+     * @brief Constructor
+     * @param use_hardware_counters true to try perf_event_open, false for wall-clock only
+     */
+    explicit StageProfiler(bool use_hardware_counters = true);
+
+    /**
+     * @brief Mark the end of a frame (per-frame figures divide by this count)
+     */
+    void endFrame();
+
+    /**
+     * @brief Check whether hardware counters are being collected
+     * @return true if counters are open and only one thread has measured stages
+     */
+    bool hasHardwareCounters() const;
+
+    /**
+     * @brief Get the per-stage report
+     *
+     * Per stage: calls, wall time, cycles, IPC, cache misses and branch
+     * misses, each per frame.
+     * @return Report string
+     */
+    std::string getReport() const;
+
+    /**
+     * @brief Reset all stage totals
+     */
+    void reset();
+
+private:
+    struct StageTotals {
+        uint64_t calls = 0;
+        double wall_ms = 0.0;
+        PerfSample counters;
+    };
+
+    bool use_hardware_counters_;
+    bool counters_tried_;
+    bool multiple_threads_;  // A second thread measured a stage: wall-clock only from then on
+    std::thread::id counter_thread_;
+    PerfCounters counters_;
+
+    mutable std::mutex mutex_;
+    std::vector<std::pair<std::string, StageTotals>> stages_;  // In first-seen order
+    uint64_t frames_;
+
+    bool beginCounters(PerfSample& sample);
+    void record(const char* stage, double wall_ms, const PerfSample* start);
+};
+
+} // namespace CodiceCam
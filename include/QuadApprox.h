@@ -0,0 +1,53 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <vector>
+
+namespace CodiceCam {
+
+/**
+ * @brief Quadrilateral test for contours, replacing cv::approxPolyDP on the candidate path
+ *
+ * cv::approxPolyDP builds a general polygon (allocating its output) only
+ * for the caller to check that it has four vertices. QuadApprox answers
+ * that question directly:
+ * - Corners: A is the point farthest from the first contour point, B the
+ *   point farthest from A, C the point farthest from line AB, and D the
+ *   point farthest outside triangle ABC. On a convex quad these are its
+ *   four vertices whatever the rotation or perspective.
+ * - Validation: C and D must lie more than epsilon from the rest of the
+ *   shape (otherwise Douglas-Peucker would not have split there), and every
+ *   contour point must lie within epsilon of the quad edge between its
+ *   neighbouring corners. The deviation is checked in blocks with an early
+ *   exit on the first block that exceeds it.
+ *
+ * Corners are returned in contour order starting from B, where
+ * cv::approxPolyDP starts its output too, so corners[0] -> corners[1] (and
+ * the marker angle taken from it) matches the approxPolyDP path. All passes
+ * are integer loops over the contour (coordinates up to 4096, so cross
+ * products fit in 32 bits) that the compiler can vectorize; nothing is
+ * allocated.
+ */
+class QuadApprox {
+public:
+    /**
+     * @brief Find the four corners of a quadrilateral contour
+     * @param points Contour points (closed)
+     * @param count Number of points
+     * @param epsilon Maximum distance of a contour point from its quad edge
+     * @param corners Output corners in contour order
+     * @return true if the contour is a quadrilateral within epsilon, false otherwise
+     */
+    static bool approximate(const cv::Point* points, int count, double epsilon, cv::Point corners[4]);
+
+    /**
+     * @brief Find the four corners of a quadrilateral contour
+     * @param contour Contour points (closed)
+     * @param epsilon Maximum distance of a contour point from its quad edge
+     * @param corners Output corners in contour order
+     * @return true if the contour is a quadrilateral within epsilon, false otherwise
+     */
+    static bool approximate(const std::vector<cv::Point>& contour, double epsilon, cv::Point corners[4]);
+};
+
+} // namespace CodiceCam
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+#include "MarkerDetector.h"
+
+namespace CodiceCam {
+
+/**
+ * @brief Result of a serial/parallel equivalence check
+ */
+struct EquivalenceReport {
+    size_t frames = 0;                    // Frames replayed through both configurations
+    size_t serial_markers = 0;            // Markers found by the serial run
+    size_t parallel_markers = 0;          // Markers found by the parallel run
+    size_t mismatched_frames = 0;         // Frames whose outputs differ
+    std::vector<std::string> differences; // First differences found (capped)
+
+    bool equivalent() const { return frames > 0 && mismatched_frames == 0; }
+};
+
+/**
+ * @brief Replays a dataset through serial and frame-parallel detection and diffs the output
+ *
+ * The serial run uses one MarkerDetector with OpenCV limited to one
+ * thread; the parallel run uses FrameParallelDetector with one detector per
+ * context. Both run in deterministic mode (no dropped or
+ * skipped frames, size prior frozen), so any difference is a change in what
+ * venues would see. Each frame's markers are compared in output order: ID,
+ * the four corners (exactly) and the TUIO tuple sent for the marker
+ * (ID, normalized position, angle in radians).
+ */
+class SerialEquivalenceChecker {
+public:
+    /**
+     * @brief Constructor
+     */
+    SerialEquivalenceChecker();
+
+    /**
+     * @brief Load a dataset: a directory of images (in file name order) or a video file
+     * @param path Directory or video file
+     * @return true if at least one frame was loaded, false otherwise
+     */
+    bool loadDataset(const std::string& path);
+
+    /**
+     * @brief Append a frame to the dataset
+     * @param frame Camera frame
+     */
+    void addFrame(const cv::Mat& frame);
+
+    /**
+     * @brief Get the number of frames in the dataset
+     * @return Frame count
+     */
+    size_t getFrameCount() const;
+
+    /**
+     * @brief Set the detection parameters used by every detector
+     * @param min_marker_size Minimum marker size in pixels
+     * @param max_marker_size Maximum marker size in pixels
+     * @param min_confidence Minimum detection confidence threshold
+     */
+    void setDetectionParams(int min_marker_size, int max_marker_size, double min_confidence);
+
+    /**
+     * @brief Run the dataset serially and with parallel contexts and compare
+     * @param contexts Detector contexts for the parallel run
+     * @return Equivalence report
+     */
+    EquivalenceReport run(int contexts);
+
+private:
+    std::vector<cv::Mat> frames_;
+    int min_marker_size_;
+    int max_marker_size_;
+    double min_confidence_;
+
+    std::unique_ptr<MarkerDetector> createDetector() const;
+    bool runSerial(std::vector<std::vector<CodiceMarker>>& results);
+    bool runParallel(int contexts, std::vector<std::vector<CodiceMarker>>& results);
+    void compareFrame(size_t index, const std::vector<CodiceMarker>& serial,
+                      const std::vector<CodiceMarker>& parallel, EquivalenceReport& report) const;
+};
+
+} // namespace CodiceCam
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace CodiceCam {
+
+/**
+ * @brief Size prior configuration
+ */
+struct SizePriorConfig {
+    int grid_cols = 16;          // Grid cells across the image
+    int grid_rows = 9;           // Grid cells down the image
+    double tolerance = 0.35;     // Accepted size range: smallest seen / (1 + t) .. largest seen * (1 + t)
+    double plane_tolerance = 1.0;// Tolerance for cells without samples of their own (plane extrapolation)
+    int explore_interval = 10;   // Every Nth rejection in a cell is let through, so the prior can relearn
+    int min_cell_samples = 5;    // Samples before a cell's own estimate is used
+    int min_fit_samples = 20;    // Samples before the plane fit fills cells without data
+    double learning_rate = 0.05; // Weight of each new sample in a cell estimate once warmed up
+};
+
+/**
+ * @brief Expected marker size at each image location, for candidate gating
+ *
+ * With a fixed camera above the table, a marker's pixel size depends on
+ * where it lies in the image. SizePriorMap keeps a coarse grid of expected
+ * sizes (square root of the contour area), learned from accepted detections
+ * or from calibration samples, so candidates whose size does not fit their
+ * location are rejected before corner finding and decoding.
+ *
+ * Each learned cell accepts the range of sizes it has seen (so two marker
+ * sizes can share a location), widened by the tolerance; the range decays
+ * back toward the cell's average as new samples arrive. For a planar
+ * table, the apparent scale is an affine function of image position, so
+ * cells without enough samples of their own use a least-squares plane
+ * fitted to all samples, with the wider plane tolerance. Until that fit
+ * has enough samples, every size is accepted (the global min/max window
+ * still applies).
+ *
+ * The prior only learns from markers that were decoded, so a rejected size
+ * could otherwise never return. Every explore_interval-th rejection in a
+ * cell is accepted instead; if it decodes, the cell's range grows to cover
+ * it.
+ *
+ * Thread-safe: one map can be shared by several detectors.
+ */
+class SizePriorMap {
+public:
+    /**
+     * @brief Constructor
+     * @param config Grid and tolerance configuration
+     */
+    explicit SizePriorMap(const SizePriorConfig& config = SizePriorConfig());
+
+    /**
+     * @brief Set the image size the grid covers (resets the map if it changes)
+     * @param size Image size in pixels
+     */
+    void setImageSize(const cv::Size& size);
+
+    /**
+     * @brief Record the size of an accepted marker (or a calibration sample)
+     * @param center Marker center in pixels
+     * @param size Marker size (square root of its contour area)
+     */
+    void observe(const cv::Point2f& center, double size);
+
+    /**
+     * @brief Check a candidate's size against the prior at its location
+     * @param center Candidate center in pixels
+     * @param size Candidate size (square root of its contour area)
+     * @return true if the size fits or no prior is known there, false otherwise
+     */
+    bool accepts(const cv::Point2f& center, double size) const;
+
+    /**
+     * @brief Get the expected marker size at a location
+     * @param center Location in pixels
+     * @param size Output expected size
+     * @return true if a prior is known there, false otherwise
+     */
+    bool expectedSize(const cv::Point2f& center, double& size) const;
+
+    /**
+     * @brief Forget all samples
+     */
+    void reset();
+
+    /**
+     * @brief Save the learned map (e.g. after a calibration session)
+     * @param filename Output file
+     * @return true if saved, false otherwise
+     */
+    bool saveToFile(const std::string& filename) const;
+
+    /**
+     * @brief Load a saved map
+     * @param filename Input file
+     * @return true if loaded, false otherwise
+     */
+    bool loadFromFile(const std::string& filename);
+
+    /**
+     * @brief Get statistics
+     * @return Statistics string
+     */
+    std::string getStatistics() const;
+
+private:
+    struct Cell {
+        double size = 0.0;      // Average size
+        double min_size = 0.0;  // Smallest recent size (decays toward the average)
+        double max_size = 0.0;  // Largest recent size (decays toward the average)
+        uint64_t samples = 0;
+    };
+
+    SizePriorConfig config_;
+    mutable std::mutex mutex_;
+    cv::Size image_size_;
+    std::vector<Cell> cells_;
+
+    // Normal equations for size = a * u + b * v + c (u, v normalized to 0..1)
+    double sums_[9];  // uu, uv, u, vv, v, n, us, vs, s
+    double plane_[3];
+    bool plane_valid_;
+
+    mutable std::vector<uint64_t> cell_rejections_;  // Per cell, drives exploration
+    mutable uint64_t checked_;
+    mutable uint64_t rejected_;
+    mutable uint64_t explored_;
+
+    int cellIndexLocked(const cv::Point2f& center) const;
+    bool expectedSizeLocked(const cv::Point2f& center, double& size) const;
+    bool acceptedRangeLocked(const cv::Point2f& center, double& min_size, double& max_size) const;
+    void solvePlaneLocked();
+    void resetLocked();
+};
+
+} // namespace CodiceCam
@@ -7,15 +7,27 @@
 #include <chrono>
 #include <functional>
 #include <list>
+#include <mutex>
+#include <thread>
 #include "TUIOConfig.h"
+#include "MarkerStreamCodec.h"
+#include "MarkerEventLog.h"
+#include "MarkerHistoryStore.h"
+#include "ZoneRouter.h"
 
 // Include TUIO headers
 #include "TuioServer.h"
 #include "TuioObject.h"
 #include "TuioTime.h"
 
+// oscpack sockets used by the compact binary stream
+class UdpTransmitSocket;
+class UdpListeningReceiveSocket;
+
 namespace CodiceCam {
 
+class BinaryStreamAckListener;
+
 /**
  * @brief Represents the lifecycle state of a Codice marker
  */
@@ -52,6 +64,25 @@ struct CodiceMarker {
  * - Session IDs are generated using TUIO's internal session management
  * - Object lifecycle: ADD -> UPDATE -> REMOVE
  * - Position coordinates are normalized (0.0-1.0) for TUIO compatibility
+ *
+ * ## Frame Budget
+ * With frame_budget_bytes set, each TUIO bundle is kept within the budget.
+ * Adds, removals and the alive list are always sent; the remaining bytes
+ * go to set messages for the markers whose last sent state is most stale
+ * (position error plus weighted angle error since the last send), so
+ * moving tokens update first. A small per-frame age term refreshes parked
+ * markers round-robin.
+ *
+ * ## Lifecycle Events
+ * DETECTED and LOST reach the lifecycle callback, history and event log
+ * the frame they happen. UPDATED is coalesced per marker: it is delivered
+ * only once the marker has moved update_event_distance or rotated
+ * update_event_angle since its last notified state, and at most
+ * update_event_max_rate times per second, so a parked token raises no
+ * events and callback volume follows real activity. A move held back by
+ * the rate limit is delivered when the window expires, so the last
+ * notified state is where the token came to rest. TUIO set messages are
+ * not affected.
  */
 class TUIOBridge {
 public:
@@ -153,6 +184,12 @@ public:
      */
     std::string getMarkerLifecycleHistory(int marker_id) const;
     
+    /**
+     * @brief Set how many lifecycle history entries are kept per marker
+     * @param entries Entries per marker (default 10, at least 1)
+     */
+    void setLifecycleHistoryLimit(size_t entries);
+    
     /**
      * @brief Force marker state transition
      * @param marker_id Codice marker ID
@@ -200,6 +237,60 @@ public:
      * @return List of available profile names
      */
     std::vector<std::string> getAvailableProfiles() const;
+    
+    /**
+     * @brief Check if the compact binary stream is active
+     * @return true if binary packets are being sent alongside TUIO
+     */
+    bool isBinaryStreamActive() const;
+    
+    /**
+     * @brief Route markers inside a zone to a dedicated TUIO sink
+     *
+     * Markers inside the zone are remapped to the zone's 0.0-1.0 space and
+     * sent only to the zone sink; markers outside every zone stay on this
+     * bridge's own server.
+     * @param zone Zone definition
+     * @return true if the zone was added and its sink initialized, false otherwise
+     */
+    bool addZone(const TUIOZone& zone);
+    
+    /**
+     * @brief Load zones from a zone file
+     * @param config_file Path to zone file (see ZoneRouter::loadFromFile)
+     * @return true if at least one zone was added, false otherwise
+     */
+    bool loadZonesFromFile(const std::string& config_file);
+    
+    /**
+     * @brief Remove all zones and stop their sinks
+     */
+    void clearZones();
+    
+    /**
+     * @brief Get the number of configured zones
+     * @return Zone count
+     */
+    size_t getZoneCount() const;
+    
+    /**
+     * @brief Write frames and lifecycle events to an NDJSON event log
+     *
+     * Frames are logged with all markers before zone routing; lifecycle
+     * events are logged by this bridge and every zone sink. The log must be
+     * open; pass nullptr to detach it.
+     * @param event_log Event log to write to
+     */
+    void setEventLog(std::shared_ptr<MarkerEventLog> event_log);
+    
+    /**
+     * @brief Append every frame to a columnar marker history store
+     *
+     * Frames are stored with all markers before zone routing. The store
+     * must be open; pass nullptr to detach it.
+     * @param history_store History store to append to
+     */
+    void setHistoryStore(std::shared_ptr<MarkerHistoryStore> history_store);
 
 private:
     std::unique_ptr<TUIO::TuioServer> tuio_server_;
@@ -215,18 +306,63 @@ private:
     int total_objects_created_;
     int total_objects_updated_;
     int total_objects_removed_;
+    uint64_t total_updates_deferred_;
     std::chrono::steady_clock::time_point start_time_;
     
     // Lifecycle management
     std::function<void(int marker_id, MarkerState state, const CodiceMarker& marker)> lifecycle_callback_;
     std::map<int, std::list<std::pair<MarkerState, std::chrono::steady_clock::time_point>>> marker_history_;
     std::map<int, MarkerState> marker_states_;
+    size_t lifecycle_history_limit_;
     int total_detected_;
     int total_lost_;
     
+    // Coalesced UPDATED events: state at the last DETECTED/UPDATED event per marker ID
+    struct NotifiedState {
+        float x, y, angle;
+        std::chrono::steady_clock::time_point time;
+        bool pending;  // Moved within the rate-limit window; delivered once it expires
+    };
+    std::map<int, NotifiedState> notified_states_;
+    uint64_t total_updates_coalesced_;
+    
     // Configuration management
     TUIOConfigManager config_manager_;
     
+    // Compact binary stream (enable_compression)
+    std::unique_ptr<MarkerStreamEncoder> binary_encoder_;
+    std::unique_ptr<UdpTransmitSocket> binary_socket_;
+    std::unique_ptr<BinaryStreamAckListener> binary_ack_listener_;
+    std::unique_ptr<UdpListeningReceiveSocket> binary_ack_socket_;
+    std::thread binary_ack_thread_;
+    mutable std::mutex binary_mutex_;
+    
+    // Zone routing (one sink per zone, index matches the router's zones)
+    ZoneRouter zone_router_;
+    std::vector<std::unique_ptr<TUIOBridge>> zone_sinks_;
+    
+    // NDJSON event log (zone sinks log lifecycle events only)
+    std::shared_ptr<MarkerEventLog> event_log_;
+    bool event_log_frames_;
+    
+    // Columnar marker history (main bridge only)
+    std::shared_ptr<MarkerHistoryStore> history_store_;
+    std::vector<StreamMarker> frame_markers_;  // Frame copy for the log and history, reused
+    
+    // Frame budget: last state sent per marker ID, and this frame's update candidates (reused)
+    struct SentState {
+        float x, y, angle;
+        uint64_t frame;
+    };
+    struct PendingUpdate {
+        TUIO::TuioObject* object;
+        const CodiceMarker* marker;
+        double priority;
+    };
+    std::map<int, SentState> sent_states_;
+    std::vector<PendingUpdate> pending_updates_;
+    uint64_t output_frame_;
+    
     /**
      * @brief Generate unique session ID for a marker
      * @param marker_id Codice marker ID
@@ -268,6 +404,18 @@ private:
      */
     void handleStateTransition(int marker_id, MarkerState new_state, const CodiceMarker& marker);
     
+    /**
+     * @brief Check whether a tracked marker has changed enough for an UPDATED event
+     *
+     * A change suppressed only by the rate limit is kept pending and made
+     * due on the first frame after the window expires, even if the marker
+     * has stopped moving by then, so its final position is always notified.
+     * @param marker Marker in the current frame
+     * @param now Current time
+     * @return true if the event is due, false if it is coalesced
+     */
+    bool isUpdateEventDue(const CodiceMarker& marker, std::chrono::steady_clock::time_point now);
+    
     /**
      * @brief Add marker to history
      * @param marker_id Codice marker ID
@@ -282,6 +430,57 @@ private:
      */
     std::string getStateName(MarkerState state) const;
     
+    /**
+     * @brief Open the binary stream sockets if enabled in the configuration
+     * @return true if the stream is disabled or started successfully
+     */
+    bool startBinaryStream();
+    
+    /**
+     * @brief Close the binary stream sockets
+     */
+    void stopBinaryStream();
+    
+    /**
+     * @brief Encode and send one frame on the binary stream
+     * @param markers Markers committed in this frame
+     */
+    void sendBinaryFrame(const std::vector<CodiceMarker>& markers);
+    
+    /**
+     * @brief Send one frame of markers to this bridge's own TUIO server
+     * @param markers Markers for this sink
+     */
+    void commitMarkers(const std::vector<CodiceMarker>& markers);
+    
+    /**
+     * @brief Send a set message for a marker and record it as sent
+     * @param object TUIO object of the marker
+     * @param marker Marker state to send
+     */
+    void sendUpdate(TUIO::TuioObject* object, const CodiceMarker& marker);
+    
+    /**
+     * @brief Staleness of a marker's last sent state
+     * @param marker Current marker state
+     * @return Priority (higher = more stale)
+     */
+    double updatePriority(const CodiceMarker& marker) const;
+    
+    /**
+     * @brief Send the most stale pending updates that fit the frame budget
+     * @param budget_bytes Frame budget in bytes
+     * @param added_count Set messages already sent for new objects this frame
+     */
+    void sendBudgetedUpdates(int budget_bytes, size_t added_count);
+    
+    /**
+     * @brief Split markers by zone and update every zone sink
+     * @param markers All markers of the frame
+     * @param unzoned Output markers outside every zone
+     */
+    void routeToZones(const std::vector<CodiceMarker>& markers, std::vector<CodiceMarker>& unzoned);
+    
 
 };
 
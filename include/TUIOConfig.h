@@ -20,11 +20,20 @@ struct TUIOStreamingConfig {
     int max_fps = 30;
     bool enable_compression = false;
     int buffer_size = 1024;
+    int frame_budget_bytes = 0;          // TUIO bundle bytes per frame (0 = unlimited), see TUIOBridge
+    
+    // Compact binary stream (used when enable_compression is set)
+    int binary_stream_port = 3334;
+    int binary_ack_port = 0;             // 0 = no back channel, keyframes assumed delivered
+    int binary_keyframe_interval = 30;
     
     // Marker configuration
     int marker_timeout_ms = 1000;
     double min_confidence = 0.5;
     int max_markers = 10;
+    double update_event_distance = 0.005;  // Movement (normalized) before a lifecycle UPDATED event
+    double update_event_angle = 0.035;     // Rotation (radians) before a lifecycle UPDATED event
+    int update_event_max_rate = 10;        // Lifecycle UPDATED events per second per marker (0 = unlimited)
     
     // TUIO protocol settings
     bool enable_tuio_1_1 = true;
@@ -51,7 +60,6 @@ struct TUIOStreamingConfig {
     bool fromJson(const std::string& json);
     
     // Configuration management
-    void merge(const TUIOStreamingConfig& other);
     TUIOStreamingConfig getProfile(const std::string& profile_name) const;
     std::vector<std::string> getAvailableProfiles() const;
 };
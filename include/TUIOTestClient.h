@@ -6,6 +6,15 @@
 #include <chrono>
 #include <string>
 #include <memory>
+#include <mutex>
+#include <atomic>
+
+// Batched rendering uses SDL_RenderGeometry (SDL 2.0.18+)
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+#define CODICE_SDL_RENDER_GEOMETRY 1
+#else
+#define CODICE_SDL_RENDER_GEOMETRY 0
+#endif
 
 namespace CodiceCam {
 
@@ -47,6 +56,10 @@ public:
     
     /**
      * @brief Start the test client main loop
+     *
+     * The loop sleeps on SDL events and renders only when the object table
+     * changed, on input, or on the heartbeat interval, so an idle client
+     * uses almost no CPU.
      * @return true if started successfully, false otherwise
      */
     bool start();
@@ -95,34 +108,98 @@ public:
      * @param debug Enable debug mode
      */
     void setDebugMode(bool debug);
+    
+    /**
+     * @brief Enable batched rendering
+     *
+     * Batched rendering builds one vertex array for all objects and one for
+     * the grid and submits each with a single SDL_RenderGeometry call; the
+     * statistics overlay is drawn from a cached texture. Enabled by default
+     * when SDL supports it. Disable to use the per-object draw path.
+     * @param enable true to enable batched rendering
+     */
+    void setBatchedRendering(bool enable);
+    
+    /**
+     * @brief Set the idle heartbeat interval
+     * @param interval_ms Maximum time between two rendered frames when nothing changes
+     */
+    void setHeartbeatInterval(int interval_ms);
 
 private:
     SDL_Window* window_;
     SDL_Renderer* renderer_;
-    bool running_;
+    std::atomic<bool> running_;
     bool debug_mode_;
     int window_width_;
     int window_height_;
     
-    // TUIO objects
+    // TUIO objects (updated from the TUIO receiver thread)
     std::map<int, TUIOObject> objects_;
+    mutable std::mutex objects_mutex_;
+    
+    // Snapshot of objects_ drawn by the render thread
+    std::vector<TUIOObject> render_objects_;
+    int render_updates_received_;
     
     // Statistics
     int total_objects_received_;
     int total_updates_received_;
     int total_objects_removed_;
+    int total_frames_rendered_;
     std::chrono::steady_clock::time_point start_time_;
     
+    // Event-driven rendering
+    Uint32 wake_event_type_;              // SDL user event pushed when objects change
+    std::atomic<bool> objects_dirty_;
+    std::atomic<bool> wake_pending_;      // A wake event is already queued
+    bool redraw_requested_;               // Input or window event needs a redraw
+    int heartbeat_interval_ms_;
+    
     // Colors for different markers
     std::vector<SDL_Color> marker_colors_;
     
+    // Batched rendering
+    bool batched_rendering_;
+#if CODICE_SDL_RENDER_GEOMETRY
+    std::vector<SDL_Vertex> object_vertices_;
+    std::vector<int> object_indices_;
+    std::vector<SDL_Vertex> grid_vertices_;
+    std::vector<int> grid_indices_;
+    int grid_width_;                  // Window size the grid vertices were built for
+    int grid_height_;
+    std::vector<float> circle_cos_;   // Unit circle for marker triangle fans
+    std::vector<float> circle_sin_;
+#endif
+    
+    // Cached statistics overlay
+    SDL_Texture* stats_texture_;
+    std::string stats_text_;
+    std::chrono::steady_clock::time_point last_stats_refresh_;
+    
     // Event handling
-    void handleEvents();
+    void handleEvent(const SDL_Event& event);
+    void wakeRenderLoop();
     void render();
     void renderObject(const TUIOObject& obj);
     void renderStatistics();
     void renderGrid();
     
+    // Batched rendering
+#if CODICE_SDL_RENDER_GEOMETRY
+    void renderObjectsBatched();
+    void renderGridBatched();
+    void appendQuad(std::vector<SDL_Vertex>& vertices, std::vector<int>& indices,
+                    float x0, float y0, float x1, float y1, SDL_Color color) const;
+    void appendLine(std::vector<SDL_Vertex>& vertices, std::vector<int>& indices,
+                    float x0, float y0, float x1, float y1, float width, SDL_Color color) const;
+    void appendRectOutline(std::vector<SDL_Vertex>& vertices, std::vector<int>& indices,
+                           float x, float y, float w, float h, SDL_Color color) const;
+#endif
+    void renderStatisticsCached();
+    std::string buildStatisticsText() const;
+    void drawStatistics(const std::string& stats_text, int origin_x, int origin_y);
+    
     // Utility functions
     SDL_Color getMarkerColor(int symbol_id) const;
     void initializeColors();
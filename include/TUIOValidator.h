@@ -183,6 +183,12 @@ public:
      */
     TUIOValidationResult testConfigurationIntegration();
     
+    /**
+     * @brief Compare binary stream bandwidth against TUIO 1.1
+     * @return Bandwidth test results
+     */
+    TUIOValidationResult testBinaryStreamBandwidth();
+    
     /**
      * @brief Generate test report
      * @return Comprehensive test report
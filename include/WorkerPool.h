@@ -0,0 +1,134 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace CodiceCam {
+
+/**
+ * @brief Fixed-size thread pool shared by the pipeline and OpenCV
+ *
+ * Runs parallel loops on (concurrency - 1) worker threads plus the calling
+ * thread, so a pool sized to the core count never has more runnable
+ * threads than cores. A parallel loop started from inside another loop's
+ * body runs inline on the current thread instead of queueing, which keeps
+ * nested OpenCV calls (e.g. cvtColor inside a parallel detection task)
+ * from oversubscribing the CPU or deadlocking.
+ *
+ * installOpenCVBackend() registers the shared pool as OpenCV's parallel_for
+ * backend (OpenCV 4.5.2+), so cvtColor, GaussianBlur, Canny and
+ * warpPerspective use these threads instead of OpenCV's own pool.
+ */
+class WorkerPool {
+public:
+    using RangeBody = std::function<void(int begin, int end)>;
+
+    /**
+     * @brief Constructor
+     * @param concurrency Total threads including the caller (0 = effective CPU count, see CpuQuota)
+     */
+    explicit WorkerPool(int concurrency = 0);
+
+    /**
+     * @brief Destructor (waits for the workers to exit)
+     */
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /**
+     * @brief Run body over [0, tasks) split into chunks across the pool
+     *
+     * Blocks until every chunk has run. The calling thread executes chunks
+     * too. The first exception thrown by the body is rethrown here.
+     * @param tasks Number of tasks
+     * @param body Function called with [begin, end) task ranges
+     */
+    void parallelFor(int tasks, const RangeBody& body);
+
+    /**
+     * @brief Get the total thread count (workers + caller)
+     * @return Concurrency
+     */
+    int getConcurrency() const;
+
+    /**
+     * @brief Get the index of the calling thread within the pool
+     * @return 1..concurrency-1 for workers, 0 for any other thread
+     */
+    int getThreadIndex() const;
+
+    /**
+     * @brief Get statistics
+     * @return Statistics string
+     */
+    std::string getStatistics() const;
+
+    /**
+     * @brief Get the process-wide pool (sized to the effective CPU count)
+     * @return Shared pool
+     */
+    static std::shared_ptr<WorkerPool> shared();
+
+    /**
+     * @brief Size the process-wide pool before its first use
+     *
+     * Callers that run several detection contexts, each on its own thread,
+     * should leave those threads their cores: with C contexts the pool gets
+     * effective CPU count - C + 1 threads, so contexts and pool workers
+     * together never exceed the CPU count.
+     * @param concurrency Total threads including the caller (0 = effective CPU count)
+     * @return true if applied, false if the shared pool already exists
+     */
+    static bool setSharedConcurrency(int concurrency);
+
+    /**
+     * @brief Make OpenCV's parallel loops run on the shared pool
+     *
+     * Uses the cv::parallel backend API when OpenCV is 4.5.2 or newer.
+     * Older OpenCV builds have no backend API; OpenCV keeps its own pool,
+     * capped at the shared pool's concurrency. Safe to call repeatedly.
+     * @return true if the pool is OpenCV's backend, false if only capped
+     */
+    static bool installOpenCVBackend();
+
+private:
+    struct Job {
+        const RangeBody* body;
+        int tasks;
+        int chunk_size;
+        int chunk_count;
+        std::atomic<int> next_chunk;
+        std::atomic<int> completed_chunks;
+        std::exception_ptr error;
+        std::mutex error_mutex;
+    };
+
+    int concurrency_;
+    std::vector<std::thread> workers_;
+
+    std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable done_cv_;
+    std::deque<std::shared_ptr<Job>> jobs_;
+    bool stopping_;
+
+    // Statistics
+    std::atomic<uint64_t> loops_run_;
+    std::atomic<uint64_t> loops_inline_;
+
+    void workerLoop(int index);
+    void runChunks(Job& job);
+};
+
+} // namespace CodiceCam
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <utility>
+
+namespace CodiceCam {
+
+/**
+ * @brief A region of the camera surface served by its own TUIO sink
+ */
+struct TUIOZone {
+    std::string name;
+    std::vector<std::pair<float, float>> polygon;  // Vertices in surface coordinates (0.0-1.0)
+    std::string host = "localhost";
+    int port = 3333;
+};
+
+/**
+ * @brief Classifies markers into zones and remaps them to zone coordinates
+ *
+ * Zones are polygons in normalized surface coordinates. Classification is a
+ * batched point-in-polygon pass: every zone edge is tested against all
+ * points of the frame in one tight loop, so the cost is
+ * O(total edges x markers) with no per-marker branching on zone layout.
+ * When zones overlap the first zone wins.
+ *
+ * Each zone remaps its bounding box to 0.0-1.0 so stations receive
+ * coordinates relative to their own display.
+ */
+class ZoneRouter {
+public:
+    ZoneRouter();
+    ~ZoneRouter();
+
+    /**
+     * @brief Add a zone
+     * @param zone Zone definition (at least 3 vertices inside 0.0-1.0)
+     * @return true if the zone is valid and was added, false otherwise
+     */
+    bool addZone(const TUIOZone& zone);
+
+    /**
+     * @brief Remove all zones
+     */
+    void clearZones();
+
+    /**
+     * @brief Get the number of zones
+     * @return Zone count
+     */
+    size_t getZoneCount() const;
+
+    /**
+     * @brief Get a zone definition
+     * @param index Zone index
+     * @return Zone definition
+     */
+    const TUIOZone& getZone(size_t index) const;
+
+    /**
+     * @brief Classify a batch of points
+     * @param xs X coordinates (normalized)
+     * @param ys Y coordinates (normalized)
+     * @param zone_indices Output zone index per point, -1 if outside all zones
+     */
+    void classify(const std::vector<float>& xs, const std::vector<float>& ys, std::vector<int>& zone_indices) const;
+
+    /**
+     * @brief Remap a surface point into zone coordinates
+     * @param zone_index Zone index
+     * @param x Surface X coordinate
+     * @param y Surface Y coordinate
+     * @param zone_x Output X coordinate in the zone (0.0-1.0)
+     * @param zone_y Output Y coordinate in the zone (0.0-1.0)
+     */
+    void remap(size_t zone_index, float x, float y, float& zone_x, float& zone_y) const;
+
+    /**
+     * @brief Load zones from a text file
+     *
+     * One zone per line: `zone <name> <host> <port> x1,y1 x2,y2 x3,y3 ...`
+     * Lines starting with '#' are ignored.
+     * @param config_file Path to zone file
+     * @return true if at least one zone was loaded, false otherwise
+     */
+    bool loadFromFile(const std::string& config_file);
+
+private:
+    /**
+     * @brief Precomputed edge data for the batched point-in-polygon test
+     */
+    struct ZoneGeometry {
+        std::vector<float> edge_x0;
+        std::vector<float> edge_y0;
+        std::vector<float> edge_y1;
+        std::vector<float> edge_slope;  // dx/dy of each non-horizontal edge
+        float min_x, min_y, max_x, max_y;
+    };
+
+    std::vector<TUIOZone> zones_;
+    std::vector<ZoneGeometry> geometry_;
+
+    // Scratch buffer reused across frames
+    mutable std::vector<unsigned char> inside_;
+};
+
+} // namespace CodiceCam
@@ -3,16 +3,45 @@
 #include <thread>
 #include <chrono>
 #include <iomanip>
+#include <algorithm>
 
 namespace CodiceCam {
 
+namespace {
+    int fourcc(char c1, char c2, char c3, char c4) {
+        return cv::VideoWriter::fourcc(c1, c2, c3, c4);
+    }
+
+    // Raw formats whose Y plane retrieveFrame() can take without a color conversion
+    bool isPlanarYuv(int code) {
+        return code == fourcc('I', '4', '2', '0') || code == fourcc('Y', 'U', '1', '2') ||
+               code == fourcc('Y', 'V', '1', '2') || code == fourcc('N', 'V', '1', '2') ||
+               code == fourcc('N', 'V', '2', '1');
+    }
+
+    bool isKnownRawFormat(int code) {
+        return isPlanarYuv(code) || code == fourcc('Y', 'U', 'Y', 'V') || code == fourcc('Y', 'U', 'Y', '2') ||
+               code == fourcc('U', 'Y', 'V', 'Y') || code == fourcc('G', 'R', 'E', 'Y') ||
+               code == fourcc('Y', '8', '0', '0') || code == fourcc('Y', '1', '6', ' ') ||
+               code == fourcc('M', 'J', 'P', 'G');
+    }
+}
+
 CameraManager::CameraManager(int device_id, int width, int height)
     : device_id_(device_id)
     , width_(width)
     , height_(height)
     , cap_(nullptr)
+    , scheduler_source_(-1)
+    , frame_period_ms_(0.0)
     , capturing_(false)
     , initialized_(false)
+    , low_memory_mode_(false)
+    , luma_channel_(0)
+    , planar_yuv_(false)
+    , capture_bytes_(0)
+    , handoff_ready_(false)
+    , processor_idle_(true)
 {
 }
 
@@ -46,60 +75,179 @@ bool CameraManager::initialize() {
     // Set target FPS to 15 for higher resolution processing
     cap_->set(cv::CAP_PROP_FPS, 15.0);
 
+    // Keep the driver queue minimal; the capture thread drains it with grab()
+    if (!cap_->set(cv::CAP_PROP_BUFFERSIZE, 1)) {
+        std::cout << "⚠️ Camera backend ignores CAP_PROP_BUFFERSIZE, relying on continuous grab()" << std::endl;
+    }
+
+    // Low-memory mode: take the raw frames and keep only their Y plane
+    if (low_memory_mode_) {
+        if (!cap_->set(cv::CAP_PROP_CONVERT_RGB, 0)) {
+            std::cout << "⚠️ Camera backend ignores CAP_PROP_CONVERT_RGB, converting BGR frames to gray" << std::endl;
+        }
+        int code = static_cast<int>(cap_->get(cv::CAP_PROP_FOURCC));
+        if (!isKnownRawFormat(code)) {
+            // The raw layout cannot be told apart from gray; let the backend convert to BGR
+            std::cout << "⚠️ Unknown camera FOURCC " << code << ", converting BGR frames to gray" << std::endl;
+            cap_->set(cv::CAP_PROP_CONVERT_RGB, 1);
+        }
+        luma_channel_ = code == fourcc('U', 'Y', 'V', 'Y') ? 1 : 0;
+        planar_yuv_ = isPlanarYuv(code);
+    }
+
     // Verify actual dimensions and FPS
     int actual_width = static_cast<int>(cap_->get(cv::CAP_PROP_FRAME_WIDTH));
     int actual_height = static_cast<int>(cap_->get(cv::CAP_PROP_FRAME_HEIGHT));
     double actual_fps = cap_->get(cv::CAP_PROP_FPS);
 
     std::cout << "📹 Camera initialized: " << actual_width << "x" << actual_height
-              << " @ " << std::fixed << std::setprecision(1) << actual_fps << " FPS" << std::endl;
+              << " @ " << std::fixed << std::setprecision(1) << actual_fps << " FPS"
+              << (low_memory_mode_ ? " (Y plane)" : "") << std::endl;
 
     // Update dimensions to actual values
     width_ = actual_width;
     height_ = actual_height;
+    frame_period_ms_ = actual_fps > 0.0 ? 1000.0 / actual_fps : 0.0;
 
     initialized_ = true;
     return true;
 }
 
 bool CameraManager::startCapture(FrameCallback callback) {
-    if (!initialized_) {
-        std::cerr << "❌ Camera not initialized. Call initialize() first." << std::endl;
+    if (!callback) {
+        std::cerr << "❌ Invalid callback function." << std::endl;
         return false;
     }
 
-    if (capturing_) {
-        std::cerr << "⚠️ Camera already capturing." << std::endl;
+    // Frames handed to a plain callback count as delivered unless it throws
+    return startCapture([callback](const cv::Mat& frame, const FrameInfo&) {
+        callback(frame);
+        return FrameStatus::DELIVERED;
+    });
+}
+
+bool CameraManager::startCapture(AccountedFrameCallback callback) {
+    if (!callback) {
+        std::cerr << "❌ Invalid callback function." << std::endl;
         return false;
     }
 
+    if (!canStart()) {
+        return false;
+    }
+
+    frame_callback_ = callback;
+    deferred_callback_ = nullptr;
+    return startThreads();
+}
+
+bool CameraManager::startDeferredCapture(DeferredFrameCallback callback) {
     if (!callback) {
         std::cerr << "❌ Invalid callback function." << std::endl;
         return false;
     }
 
-    frame_callback_ = callback;
+    if (!canStart()) {
+        return false;
+    }
+
+    frame_callback_ = nullptr;
+    deferred_callback_ = callback;
+    return startThreads();
+}
+
+bool CameraManager::canStart() {
+    if (!initialized_) {
+        std::cerr << "❌ Camera not initialized. Call initialize() first." << std::endl;
+        return false;
+    }
+
+    if (capturing_) {
+        std::cerr << "⚠️ Camera already capturing." << std::endl;
+        return false;
+    }
+
+    // Threads left over from a capture loop that stopped on a camera error
+    stopCapture();
+    return true;
+}
+
+bool CameraManager::startThreads() {
+    handoff_ready_ = false;
+    processor_idle_ = true;
     capturing_ = true;
 
-    // Start capture loop in separate thread
-    std::thread capture_thread(&CameraManager::captureLoop, this);
-    capture_thread.detach();
+    if (capture_scheduler_) {
+        scheduler_source_ = capture_scheduler_->addSource("Camera " + std::to_string(device_id_), frame_period_ms_);
+    }
+
+    processing_thread_ = std::thread(&CameraManager::processingLoop, this);
+    capture_thread_ = std::thread(&CameraManager::captureLoop, this);
 
     std::cout << "🎥 Camera capture started" << std::endl;
     return true;
 }
 
 void CameraManager::stopCapture() {
-    if (!capturing_) {
+    bool was_capturing = capturing_.exchange(false);
+
+    {
+        std::lock_guard<std::mutex> lock(handoff_mutex_);
+    }
+    handoff_cv_.notify_all();
+
+    if (capture_thread_.joinable()) {
+        capture_thread_.join();
+    }
+    if (processing_thread_.joinable()) {
+        // Stopping from inside the callback: the loop exits after it returns
+        if (processing_thread_.get_id() == std::this_thread::get_id()) {
+            processing_thread_.detach();
+        } else {
+            processing_thread_.join();
+        }
+    }
+
+    if (capture_scheduler_ && scheduler_source_ >= 0) {
+        capture_scheduler_->removeSource(scheduler_source_);
+        scheduler_source_ = -1;
+    }
+
+    if (was_capturing) {
+        std::cout << "🛑 Camera capture stopped" << std::endl;
+    }
+}
+
+FrameAccounting& CameraManager::getFrameAccounting() {
+    return frame_accounting_;
+}
+
+void CameraManager::setIdleMonitor(std::shared_ptr<IdleMonitor> idle_monitor) {
+    if (capturing_) {
+        std::cerr << "❌ Cannot change the idle monitor while capturing." << std::endl;
         return;
     }
+    idle_monitor_ = std::move(idle_monitor);
+}
 
-    capturing_ = false;
+void CameraManager::setCaptureScheduler(std::shared_ptr<CaptureScheduler> capture_scheduler) {
+    if (capturing_) {
+        std::cerr << "❌ Cannot change the capture scheduler while capturing." << std::endl;
+        return;
+    }
+    capture_scheduler_ = std::move(capture_scheduler);
+}
 
-    // Wait a bit for the capture loop to finish
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+void CameraManager::setLowMemoryMode(bool enable) {
+    if (initialized_) {
+        std::cerr << "❌ Low-memory mode must be set before the camera is initialized." << std::endl;
+        return;
+    }
+    low_memory_mode_ = enable;
+}
 
-    std::cout << "🛑 Camera capture stopped" << std::endl;
+size_t CameraManager::getMemoryBytes() const {
+    return capture_bytes_;
 }
 
 bool CameraManager::isCapturing() const {
@@ -154,38 +302,150 @@ bool CameraManager::isAvailable() const {
 
 void CameraManager::captureLoop() {
     cv::Mat frame;
-    auto last_frame_time = std::chrono::steady_clock::now();
-    const auto target_frame_duration = std::chrono::milliseconds(67); // ~15 FPS (1000ms/15fps = 66.67ms)
 
+    // grab() blocks until the camera delivers the next frame, so the loop
+    // runs at the camera frame rate and the driver queue stays empty
     while (capturing_) {
-        auto frame_start_time = std::chrono::steady_clock::now();
-
-        if (!cap_->read(frame)) {
-            std::cerr << "❌ Failed to read frame from camera" << std::endl;
+        if (!cap_->grab()) {
+            std::cerr << "❌ Failed to grab frame from camera" << std::endl;
             break;
         }
 
-        if (frame.empty()) {
+        FrameInfo frame_info = frame_accounting_.beginFrame();
+
+        // Idle: only the periodic motion-check frames are retrieved
+        bool check_due = idle_monitor_ && idle_monitor_->isCheckDue(frame_info.capture_time);
+        bool idle = idle_monitor_ && idle_monitor_->isIdle(frame_info.capture_time);
+        if (idle && !check_due) {
+            frame_accounting_.finishFrame(frame_info, FrameStatus::SKIPPED_STATIC, "idle");
+            continue;
+        }
+
+        bool processor_ready;
+        {
+            std::lock_guard<std::mutex> lock(handoff_mutex_);
+            processor_ready = processor_idle_ && !handoff_ready_;
+        }
+
+        // The processor is busy; the frame is superseded by the next grab and never decoded
+        if (!processor_ready) {
+            frame_accounting_.finishFrame(frame_info, FrameStatus::DROPPED_STALE, "not_retrieved");
+            continue;
+        }
+
+        if (!retrieveFrame(frame) || frame.empty()) {
             std::cerr << "⚠️ Received empty frame" << std::endl;
+            frame_accounting_.finishFrame(frame_info, FrameStatus::PROCESSING_ERROR, "empty_frame");
             continue;
         }
 
-        // Call the callback with the frame
-        if (frame_callback_) {
-            frame_callback_(frame);
+        // Motion wakes an idle table on this very frame
+        if (check_due && !idle_monitor_->checkFrame(frame, frame_info.capture_time) && idle) {
+            frame_accounting_.finishFrame(frame_info, FrameStatus::SKIPPED_STATIC, "idle_static");
+            continue;
+        }
+
+        capture_bytes_ = raw_frame_.total() * raw_frame_.elemSize() + 2 * frame.total() * frame.elemSize();
+
+        {
+            std::lock_guard<std::mutex> lock(handoff_mutex_);
+            std::swap(handoff_frame_, frame);
+            handoff_info_ = frame_info;
+            handoff_ready_ = true;
+            processor_idle_ = false;
+        }
+        handoff_cv_.notify_one();
+    }
+
+    // Stop the processing thread too if the camera failed
+    capturing_ = false;
+    {
+        std::lock_guard<std::mutex> lock(handoff_mutex_);
+    }
+    handoff_cv_.notify_all();
+}
+
+bool CameraManager::retrieveFrame(cv::Mat& frame) {
+    if (!low_memory_mode_) {
+        return cap_->retrieve(frame);
+    }
+
+    if (!cap_->retrieve(raw_frame_) || raw_frame_.empty()) {
+        return false;
+    }
+    if (raw_frame_.depth() == CV_16U) {
+        // Y16 and other 16-bit sensors: keep the high byte
+        raw_frame_.convertTo(raw_frame_, CV_8U, 1.0 / 256.0);
+    } else if (raw_frame_.depth() != CV_8U) {
+        std::cerr << "❌ Unsupported camera frame depth " << raw_frame_.depth() << std::endl;
+        return false;
+    }
+
+    if (raw_frame_.channels() == 2) {
+        // YUYV / UYVY: every pixel has its Y sample in one channel
+        cv::extractChannel(raw_frame_, frame, luma_channel_);
+    } else if (raw_frame_.channels() == 3) {
+        cv::cvtColor(raw_frame_, frame, cv::COLOR_BGR2GRAY);
+    } else if (raw_frame_.channels() == 4) {
+        cv::cvtColor(raw_frame_, frame, cv::COLOR_BGRA2GRAY);
+    } else if (raw_frame_.rows == 1) {
+        // Compressed MJPEG: decode the luma component only
+        cv::imdecode(raw_frame_, cv::IMREAD_GRAYSCALE, &frame);
+    } else if (planar_yuv_) {
+        // I420 / YV12 / NV12 / NV21: height x 3/2 rows, the Y plane is the first height rows
+        int luma_rows = std::min(height_, raw_frame_.rows);
+        // Copy: the next retrieve() reuses raw_frame_ while the consumer holds frame
+        raw_frame_.rowRange(0, luma_rows).copyTo(frame);
+    } else {
+        std::swap(raw_frame_, frame);  // Already a gray frame
+    }
+    return !frame.empty();
+}
+
+void CameraManager::processingLoop() {
+    cv::Mat frame;
+    FrameInfo frame_info;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(handoff_mutex_);
+            handoff_cv_.wait(lock, [this]() { return handoff_ready_ || !capturing_; });
+            if (!handoff_ready_) {
+                break;
+            }
+            std::swap(frame, handoff_frame_);
+            frame_info = handoff_info_;
+            handoff_ready_ = false;
         }
 
-        // Calculate frame processing time
-        auto frame_end_time = std::chrono::steady_clock::now();
-        auto frame_duration = std::chrono::duration_cast<std::chrono::milliseconds>(frame_end_time - frame_start_time);
+        // Wait for this camera's slot; the capture thread keeps grabbing meanwhile
+        if (capture_scheduler_) {
+            std::this_thread::sleep_until(capture_scheduler_->dispatchTime(scheduler_source_, frame_info.capture_time));
+        }
 
-        // Sleep to maintain target FPS
-        if (frame_duration < target_frame_duration) {
-            auto sleep_duration = target_frame_duration - frame_duration;
-            std::this_thread::sleep_for(sleep_duration);
+        // Call the callback with the frame
+        if (deferred_callback_) {
+            try {
+                deferred_callback_(frame, frame_info);
+            } catch (const std::exception& e) {
+                std::cerr << "❌ Error in frame callback: " << e.what() << std::endl;
+                frame_accounting_.finishFrame(frame_info, FrameStatus::PROCESSING_ERROR, "callback_exception");
+            }
+            // The consumer may still hold the buffer; retrieve() must not write into it
+            frame.release();
+        } else if (frame_callback_) {
+            try {
+                frame_accounting_.finishFrame(frame_info, frame_callback_(frame, frame_info));
+            } catch (const std::exception& e) {
+                std::cerr << "❌ Error in frame callback: " << e.what() << std::endl;
+                frame_accounting_.finishFrame(frame_info, FrameStatus::PROCESSING_ERROR, "callback_exception");
+            }
+        } else {
+            frame_accounting_.finishFrame(frame_info, FrameStatus::DELIVERED);
         }
 
-        last_frame_time = frame_end_time;
+        std::lock_guard<std::mutex> lock(handoff_mutex_);
+        processor_idle_ = true;
     }
 }
 
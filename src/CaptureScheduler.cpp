@@ -0,0 +1,192 @@
+#include "CaptureScheduler.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+namespace CodiceCam {
+
+namespace {
+    // Period used when neither the configuration nor the sources give one (30 FPS)
+    const double DEFAULT_FRAME_PERIOD_MS = 1000.0 / 30.0;
+
+    // Two sources swap slots only when their phases cross by this fraction of the slot spacing
+    const double ORDER_HYSTERESIS = 0.2;
+
+    // Frames past their slot by less than this fraction of the period are on time (jitter)
+    const double LATE_TOLERANCE = 0.05;
+
+    // Wrap to [0, period)
+    double wrapPhase(double value, double period) {
+        double wrapped = std::fmod(value, period);
+        return wrapped < 0.0 ? wrapped + period : wrapped;
+    }
+
+    // Wrap to [-period / 2, period / 2)
+    double wrapDifference(double value, double period) {
+        return wrapPhase(value + period / 2.0, period) - period / 2.0;
+    }
+}
+
+CaptureScheduler::CaptureScheduler(const CaptureSchedulerConfig& config)
+    : config_(config)
+    , epoch_(std::chrono::steady_clock::now())
+    , next_source_(0)
+    , has_anchor_(false)
+    , anchor_phase_ms_(0.0)
+{
+    config_.phase_smoothing = std::min(1.0, std::max(0.001, config_.phase_smoothing));
+    config_.max_delay_fraction = std::min(1.0, std::max(0.0, config_.max_delay_fraction));
+}
+
+int CaptureScheduler::addSource(const std::string& name, double frame_period_ms) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int source = next_source_++;
+    Source& entry = sources_[source];
+    entry.name = name;
+    entry.frame_period_ms = frame_period_ms > 0.0 ? frame_period_ms : DEFAULT_FRAME_PERIOD_MS;
+    entry.has_phase = false;
+    entry.phase_ms = 0.0;
+    entry.slot_ms = 0.0;
+    entry.rank = sources_.size();
+    entry.frames = 0;
+    entry.total_delay_ms = 0.0;
+    entry.max_delay_ms = 0.0;
+    entry.late_frames = 0;
+    std::cout << "⚙️ Capture scheduler: " << name << " added (" << sources_.size() << " sources)" << std::endl;
+    return source;
+}
+
+void CaptureScheduler::removeSource(int source) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sources_.erase(source);
+}
+
+std::chrono::steady_clock::time_point CaptureScheduler::dispatchTime(int source,
+                                                                     std::chrono::steady_clock::time_point capture_time) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sources_.find(source);
+    if (it == sources_.end()) {
+        return capture_time;
+    }
+    Source& entry = it->second;
+
+    double period = periodLocked();
+    double phase = wrapPhase(std::chrono::duration<double, std::milli>(capture_time - epoch_).count(), period);
+    if (entry.has_phase) {
+        entry.phase_ms = wrapPhase(entry.phase_ms + config_.phase_smoothing * wrapDifference(phase - entry.phase_ms, period),
+                                   period);
+    } else {
+        entry.phase_ms = phase;
+        entry.has_phase = true;
+    }
+    assignSlotsLocked(period);
+
+    // Hold until the slot; a frame just past its slot would wait a whole period
+    double delay = wrapPhase(entry.slot_ms - phase, period);
+    if (delay > config_.max_delay_fraction * period) {
+        if (period - delay > LATE_TOLERANCE * period) {
+            entry.late_frames++;
+        }
+        delay = 0.0;
+    }
+
+    entry.frames++;
+    entry.total_delay_ms += delay;
+    entry.max_delay_ms = std::max(entry.max_delay_ms, delay);
+    return capture_time + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double, std::milli>(delay));
+}
+
+double CaptureScheduler::periodLocked() const {
+    if (config_.frame_period_ms > 0.0) {
+        return config_.frame_period_ms;
+    }
+    double period = 0.0;
+    for (const auto& [id, entry] : sources_) {
+        period = std::max(period, entry.frame_period_ms);
+    }
+    return period > 0.0 ? period : DEFAULT_FRAME_PERIOD_MS;
+}
+
+void CaptureScheduler::assignSlotsLocked(double period) {
+    // Sources in phase order; those without a phase yet keep slot 0 and wait nothing
+    std::vector<Source*> ordered;
+    for (auto& [id, entry] : sources_) {
+        if (entry.has_phase) {
+            ordered.push_back(&entry);
+        } else {
+            entry.slot_ms = 0.0;
+        }
+    }
+    if (ordered.empty()) {
+        return;
+    }
+    size_t count = ordered.size();
+    double spacing = period / count;
+
+    // Keep the previous order unless two neighbours' phases have clearly crossed. Phases are measured
+    // from half a slot before the previous anchor, so a source near the wrap point of [0, period)
+    // keeps its place in the cyclic order
+    std::sort(ordered.begin(), ordered.end(),
+              [](const Source* a, const Source* b) { return a->rank < b->rank; });
+    double origin = (has_anchor_ ? anchor_phase_ms_ : ordered[0]->phase_ms) - spacing / 2.0;
+    auto position = [origin, period](const Source* entry) { return wrapPhase(entry->phase_ms - origin, period); };
+    double margin = ORDER_HYSTERESIS * spacing;
+    bool swapped = true;
+    while (swapped) {
+        swapped = false;
+        for (size_t k = 0; k + 1 < count; k++) {
+            if (position(ordered[k]) > position(ordered[k + 1]) + margin) {
+                std::swap(ordered[k], ordered[k + 1]);
+                swapped = true;
+            }
+        }
+    }
+
+    // Evenly spaced slots anchored at one source's phase, choosing the anchor with the shortest longest
+    // hold; the previous anchor (first in the order) stays unless another is shorter by the margin
+    size_t best_anchor = 0;
+    double best_max = period;
+    for (size_t anchor = 0; anchor < count; anchor++) {
+        double max_delay = 0.0;
+        for (size_t k = 0; k < count; k++) {
+            const Source* entry = ordered[(anchor + k) % count];
+            double slot = wrapPhase(ordered[anchor]->phase_ms + k * spacing, period);
+            double delay = wrapPhase(slot - entry->phase_ms, period);
+            max_delay = std::max(max_delay, delay);
+        }
+        if (anchor == 0) {
+            best_max = max_delay - margin;
+        } else if (max_delay < best_max) {
+            best_anchor = anchor;
+            best_max = max_delay;
+        }
+    }
+
+    for (size_t k = 0; k < count; k++) {
+        Source* entry = ordered[(best_anchor + k) % count];
+        entry->rank = k;
+        entry->slot_ms = wrapPhase(ordered[best_anchor]->phase_ms + k * spacing, period);
+    }
+    anchor_phase_ms_ = ordered[best_anchor]->phase_ms;
+    has_anchor_ = true;
+}
+
+std::string CaptureScheduler::getStatistics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1);
+    oss << "Capture Scheduler:\n";
+    oss << "  Frame period: " << periodLocked() << " ms, " << sources_.size() << " sources\n";
+    for (const auto& [id, entry] : sources_) {
+        oss << "  " << entry.name << ": phase " << entry.phase_ms << " ms, slot " << entry.slot_ms << " ms, hold "
+            << (entry.frames > 0 ? entry.total_delay_ms / entry.frames : 0.0) << " ms avg / "
+            << entry.max_delay_ms << " ms max, " << entry.late_frames << " late\n";
+    }
+    return oss.str();
+}
+
+} // namespace CodiceCam
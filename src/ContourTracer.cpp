@@ -0,0 +1,202 @@
+#include "ContourTracer.h"
+#include <algorithm>
+#include <climits>
+
+namespace CodiceCam {
+
+namespace {
+    const int8_t FOREGROUND = 1;
+    const int8_t TRACED = 2;
+    const int8_t RIGHT_BOUND = static_cast<int8_t>(TRACED | -128);  // Border pixel with background to its right
+    const int8_t ABANDONED = -127;
+
+    // Freeman chain code steps: E, NE, N, NW, W, SW, S, SE (y grows downward)
+    const cv::Point CODE_DELTAS[8] = {
+        cv::Point(1, 0), cv::Point(1, -1), cv::Point(0, -1), cv::Point(-1, -1),
+        cv::Point(-1, 0), cv::Point(-1, 1), cv::Point(0, 1), cv::Point(1, 1)
+    };
+}
+
+BoundedContourTracer::BoundedContourTracer()
+    : max_extent_(0)
+    , max_length_(0)
+    , stride_(0)
+    , traced_(0)
+    , abandoned_(0)
+{
+    std::fill(deltas_, deltas_ + 16, 0);
+}
+
+void BoundedContourTracer::setLimits(int max_extent, int max_length) {
+    max_extent_ = max_extent;
+    max_length_ = max_length;
+}
+
+bool BoundedContourTracer::trace(const cv::Mat& binary, std::vector<std::vector<cv::Point>>& contours) {
+    contours.clear();
+    if (binary.empty() || binary.type() != CV_8UC1) {
+        return false;
+    }
+
+    // One pixel of background around the image, like findContours
+    int width = binary.cols;
+    int height = binary.rows;
+    stride_ = width + 2;
+    labels_.assign(static_cast<size_t>(stride_) * (height + 2), 0);
+    for (int y = 0; y < height; y++) {
+        const uint8_t* src = binary.ptr<uint8_t>(y);
+        int8_t* dst = labels_.data() + (y + 1) * stride_ + 1;
+        for (int x = 0; x < width; x++) {
+            dst[x] = src[x] != 0 ? FOREGROUND : 0;
+        }
+    }
+
+    const int steps[8] = {1, -stride_ + 1, -stride_, -stride_ - 1, -1, stride_ - 1, stride_, stride_ + 1};
+    for (int i = 0; i < 16; i++) {
+        deltas_[i] = steps[i & 7];
+    }
+
+    int8_t* labels = labels_.data();
+    for (int y = 0; y < height; y++) {
+        int row = (y + 1) * stride_ + 1;
+        int prev = 0;
+        int lnbd = row - 1;  // Last border pixel to the left on this row (starts at the padding)
+
+        for (int x = 0; x < width; x++) {
+            int p = labels[row + x];
+            if (p == prev) {
+                continue;
+            }
+
+            // Outer border start, unless the last border to the left encloses it
+            if (prev == 0 && p == FOREGROUND && labels[lnbd] <= 0) {
+                int start = row + x;
+                if (followBorder(start, cv::Point(x, y))) {
+                    traced_++;
+                    contours.emplace_back(points_.begin(), points_.end());
+                } else {
+                    abandoned_++;
+                    abandonComponent(start);
+                }
+                // The start pixel is relabeled but does not move lnbd, as in findContours
+                prev = labels[start];
+                continue;
+            }
+
+            prev = p;
+            if (p & -2) {
+                lnbd = row + x;
+            }
+        }
+    }
+
+    return true;
+}
+
+uint64_t BoundedContourTracer::getTracedCount() const {
+    return traced_;
+}
+
+uint64_t BoundedContourTracer::getAbandonedCount() const {
+    return abandoned_;
+}
+
+size_t BoundedContourTracer::getMemoryBytes() const {
+    return labels_.capacity() * sizeof(int8_t) + points_.capacity() * sizeof(cv::Point) +
+           fill_stack_.capacity() * sizeof(int);
+}
+
+bool BoundedContourTracer::followBorder(int start, cv::Point origin) {
+    int8_t* labels = labels_.data();
+    points_.clear();
+
+    // First neighbour, searching clockwise from the background pixel to the west
+    int s = 4;
+    int s_end = 4;
+    int first;
+    do {
+        s = (s - 1) & 7;
+        first = start + deltas_[s];
+    } while (labels[first] == 0 && s != s_end);
+
+    if (s == s_end) {
+        // Isolated pixel
+        labels[start] = RIGHT_BOUND;
+        points_.push_back(origin);
+        return true;
+    }
+
+    int max_extent = max_extent_ > 0 ? max_extent_ : INT_MAX;
+    int max_length = max_length_ > 0 ? max_length_ : INT_MAX;
+    int min_x = origin.x, max_x = origin.x;
+    int min_y = origin.y, max_y = origin.y;
+    int length = 0;
+
+    int current = start;
+    int prev_s = s ^ 4;
+    cv::Point point = origin;
+
+    while (true) {
+        // Next border pixel, searching counterclockwise from the one we came from
+        s_end = s;
+        int next = current;
+        while (s < 15) {
+            next = current + deltas_[++s];
+            if (labels[next] != 0) {
+                break;
+            }
+        }
+        s &= 7;
+
+        // The search passed the eastern neighbour: background lies to the right
+        if (static_cast<unsigned>(s - 1) < static_cast<unsigned>(s_end)) {
+            labels[current] = RIGHT_BOUND;
+        } else if (labels[current] == FOREGROUND) {
+            labels[current] = TRACED;
+        }
+
+        // CHAIN_APPROX_SIMPLE: keep only points where the direction changes
+        if (s != prev_s) {
+            points_.push_back(point);
+            prev_s = s;
+        }
+        point += CODE_DELTAS[s];
+
+        min_x = std::min(min_x, point.x);
+        max_x = std::max(max_x, point.x);
+        min_y = std::min(min_y, point.y);
+        max_y = std::max(max_y, point.y);
+        if (max_x - min_x > max_extent || max_y - min_y > max_extent || ++length > max_length) {
+            return false;
+        }
+
+        if (next == start && current == first) {
+            return true;
+        }
+
+        current = next;
+        s = (s + 4) & 7;
+    }
+}
+
+void BoundedContourTracer::abandonComponent(int start) {
+    int8_t* labels = labels_.data();
+
+    // 8-connected flood fill; the padding stops it at the image edge
+    fill_stack_.clear();
+    labels[start] = ABANDONED;
+    fill_stack_.push_back(start);
+    while (!fill_stack_.empty()) {
+        int index = fill_stack_.back();
+        fill_stack_.pop_back();
+        for (int d = 0; d < 8; d++) {
+            int neighbour = index + deltas_[d];
+            if (labels[neighbour] != 0 && labels[neighbour] != ABANDONED) {
+                labels[neighbour] = ABANDONED;
+                fill_stack_.push_back(neighbour);
+            }
+        }
+    }
+}
+
+} // namespace CodiceCam
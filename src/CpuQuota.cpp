@@ -0,0 +1,211 @@
+#include "CpuQuota.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace CodiceCam {
+
+namespace {
+    // cgroup v2 entry in /proc/self/cgroup: "0::<path>"
+    const std::string UNIFIED_PREFIX = "0::";
+
+    bool readFirstLine(const std::string& path, std::string& line) {
+        std::ifstream file(path);
+        return file.is_open() && static_cast<bool>(std::getline(file, line));
+    }
+
+    int hardwareCpuCount() {
+        return static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+
+    // "max 100000" = unlimited, "150000 100000" = 1.5 CPUs
+    double readQuotaCpus(const std::string& dir) {
+        std::string line;
+        if (!readFirstLine(dir + "/cpu.max", line)) {
+            return 0.0;
+        }
+        std::istringstream iss(line);
+        std::string quota;
+        double period = 0.0;
+        if (!(iss >> quota >> period) || quota == "max" || period <= 0.0) {
+            return 0.0;
+        }
+        double quota_usec = std::atof(quota.c_str());
+        return quota_usec > 0.0 ? quota_usec / period : 0.0;
+    }
+}
+
+CpuQuota::CpuQuota(const std::string& cgroup_root, const std::string& proc_cgroup)
+    : cgroup_root_(cgroup_root)
+    , proc_cgroup_(proc_cgroup)
+    , quota_cpus_(0.0)
+    , cpuset_count_(0)
+    , affinity_count_(1)
+    , effective_count_(1)
+{
+    refresh();
+}
+
+bool CpuQuota::refresh() {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    affinity_count_ = sched_getaffinity(0, sizeof(set), &set) == 0 ? CPU_COUNT(&set) : hardwareCpuCount();
+#else
+    affinity_count_ = hardwareCpuCount();
+#endif
+    affinity_count_ = std::max(1, affinity_count_);
+    effective_count_ = affinity_count_;
+    quota_cpus_ = 0.0;
+    cpuset_count_ = 0;
+    cgroup_path_.clear();
+
+    // Locate the process's cgroup under the v2 mount
+    std::ifstream file(proc_cgroup_);
+    std::string line;
+    bool found = false;
+    while (std::getline(file, line)) {
+        if (line.compare(0, UNIFIED_PREFIX.size(), UNIFIED_PREFIX) == 0) {
+            std::string relative = line.substr(UNIFIED_PREFIX.size());
+            cgroup_path_ = cgroup_root_ + (relative == "/" ? "" : relative);
+            found = true;
+            break;
+        }
+    }
+    if (!found) {
+        return false;
+    }
+
+    std::string cpus;
+    if (readFirstLine(cgroup_path_ + "/cpuset.cpus.effective", cpus)) {
+        cpuset_count_ = parseCpuList(cpus);
+    }
+
+    // The tightest quota among the cgroup and its ancestors applies
+    std::string dir = cgroup_path_;
+    while (true) {
+        double quota = readQuotaCpus(dir);
+        if (quota > 0.0 && (quota_cpus_ == 0.0 || quota < quota_cpus_)) {
+            quota_cpus_ = quota;
+        }
+        size_t slash = dir.find_last_of('/');
+        if (dir.size() <= cgroup_root_.size() || slash == std::string::npos || slash < cgroup_root_.size()) {
+            break;
+        }
+        dir.erase(slash);
+    }
+
+    if (cpuset_count_ > 0) {
+        effective_count_ = std::min(effective_count_, cpuset_count_);
+    }
+    if (quota_cpus_ > 0.0) {
+        // Rounded down: a partial CPU of threads would run into the quota every period
+        int quota_count = std::max(1, static_cast<int>(std::floor(quota_cpus_)));
+        effective_count_ = std::min(effective_count_, quota_count);
+    }
+    return true;
+}
+
+int CpuQuota::getEffectiveCpuCount() const {
+    return effective_count_;
+}
+
+double CpuQuota::getQuotaCpus() const {
+    return quota_cpus_;
+}
+
+int CpuQuota::getCpusetCount() const {
+    return cpuset_count_;
+}
+
+int CpuQuota::getAffinityCount() const {
+    return affinity_count_;
+}
+
+bool CpuQuota::readThrottling(CpuThrottling& throttling) const {
+    if (cgroup_path_.empty()) {
+        return false;
+    }
+    std::ifstream file(cgroup_path_ + "/cpu.stat");
+    if (!file.is_open()) {
+        return false;
+    }
+
+    throttling = CpuThrottling();
+    std::string key;
+    uint64_t value;
+    while (file >> key >> value) {
+        if (key == "nr_periods") {
+            throttling.periods = value;
+        } else if (key == "nr_throttled") {
+            throttling.throttled = value;
+        } else if (key == "throttled_usec") {
+            throttling.throttled_usec = value;
+        }
+    }
+    return true;
+}
+
+const std::string& CpuQuota::getCgroupPath() const {
+    return cgroup_path_;
+}
+
+std::string CpuQuota::getStatistics() const {
+    std::ostringstream oss;
+    oss << "CPU Quota:\n";
+    oss << "  Effective CPUs: " << effective_count_ << " (affinity " << affinity_count_ << ", cpuset ";
+    if (cpuset_count_ > 0) {
+        oss << cpuset_count_;
+    } else {
+        oss << "-";
+    }
+    oss << ", quota ";
+    if (quota_cpus_ > 0.0) {
+        oss << std::fixed << std::setprecision(2) << quota_cpus_;
+    } else {
+        oss << "max";
+    }
+    oss << ")\n";
+
+    CpuThrottling throttling;
+    if (readThrottling(throttling)) {
+        double ratio = throttling.periods > 0 ? 100.0 * throttling.throttled / throttling.periods : 0.0;
+        oss << "  Throttled periods: " << throttling.throttled << " / " << throttling.periods << " ("
+            << std::fixed << std::setprecision(1) << ratio << "%)\n";
+        oss << "  Throttled time: " << throttling.throttled_usec / 1000 << " ms\n";
+    }
+    return oss.str();
+}
+
+int CpuQuota::effectiveCpuCount() {
+    static const int count = CpuQuota().getEffectiveCpuCount();
+    return count;
+}
+
+int CpuQuota::parseCpuList(const std::string& list) {
+    int count = 0;
+    std::istringstream iss(list);
+    std::string range;
+    while (std::getline(iss, range, ',')) {
+        if (range.empty()) {
+            continue;
+        }
+        size_t dash = range.find('-');
+        int first = std::atoi(range.c_str());
+        int last = dash == std::string::npos ? first : std::atoi(range.c_str() + dash + 1);
+        if (last >= first) {
+            count += last - first + 1;
+        }
+    }
+    return count;
+}
+
+} // namespace CodiceCam
@@ -0,0 +1,226 @@
+#include "FastBlur.h"
+#include "FrameQuality.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+namespace CodiceCam {
+
+namespace {
+    // cvtColor BGR2GRAY fixed-point coefficients (Q14)
+    const int GRAY_B = 1868;
+    const int GRAY_G = 9617;
+    const int GRAY_R = 4899;
+    const int GRAY_SHIFT = 14;
+
+    inline int reflect101(int i, int n) {
+        if (i < 0) {
+            return -i;
+        }
+        if (i >= n) {
+            return 2 * n - 2 - i;
+        }
+        return i;
+    }
+}
+
+FastBlur::FastBlur(int kernel_size)
+    : kernel_size_(5)
+    , lut_alpha_(1.0)
+    , lut_beta_(0.0)
+{
+    for (int i = 0; i < 256; i++) {
+        lut_[i] = static_cast<uint8_t>(i);
+    }
+    if (!setKernelSize(kernel_size)) {
+        buildKernel();
+    }
+}
+
+bool FastBlur::setKernelSize(int kernel_size) {
+    if (kernel_size < 3 || kernel_size > MAX_KERNEL_SIZE || kernel_size % 2 == 0) {
+        return false;
+    }
+    if (kernel_size != kernel_size_ || kernel_.empty()) {
+        kernel_size_ = kernel_size;
+        buildKernel();
+    }
+    return true;
+}
+
+int FastBlur::getKernelSize() const {
+    return kernel_size_;
+}
+
+const std::vector<uint16_t>& FastBlur::getKernel() const {
+    return kernel_;
+}
+
+bool FastBlur::supports(const cv::Mat& frame, int kernel_size) {
+    if (kernel_size < 3 || kernel_size > MAX_KERNEL_SIZE || kernel_size % 2 == 0) {
+        return false;
+    }
+    if (frame.depth() != CV_8U || (frame.channels() != 1 && frame.channels() != 3)) {
+        return false;
+    }
+    int radius = kernel_size / 2;
+    return frame.rows > radius && frame.cols > radius;
+}
+
+bool FastBlur::apply(const cv::Mat& input, cv::Mat& output, double alpha, double beta, FrameQualityMap* quality) {
+    if (!supports(input, kernel_size_)) {
+        return false;
+    }
+    if (alpha != lut_alpha_ || beta != lut_beta_) {
+        buildLut(alpha, beta);
+    }
+
+    const int width = input.cols;
+    const int height = input.rows;
+    const int ksize = kernel_size_;
+    const int radius = ksize / 2;
+
+    output.create(height, width, CV_8UC1);
+    gray_ring_.resize(static_cast<size_t>(ksize) * width);
+    column_sums_.resize(static_cast<size_t>(width) + 2 * radius);
+    row_acc_.resize(width);
+
+    const uint16_t* weights = kernel_.data();
+    uint16_t* sums = column_sums_.data() + radius;
+    uint32_t* row_acc = row_acc_.data();
+    int next_gray_row = 0;
+    if (quality) {
+        quality->begin(input.size());
+    }
+
+    for (int y = 0; y < height; y++) {
+        // Convert the rows entering the window; older rows stay in the ring
+        int last_needed = std::min(y + radius, height - 1);
+        while (next_gray_row <= last_needed) {
+            convertRow(input, next_gray_row, &gray_ring_[static_cast<size_t>(next_gray_row % ksize) * width]);
+            // The ring holds at least 3 rows, so the row above the new one and its upper neighbour are still there
+            if (quality && next_gray_row >= 2) {
+                quality->addRow(next_gray_row - 1,
+                                &gray_ring_[static_cast<size_t>((next_gray_row - 2) % ksize) * width],
+                                &gray_ring_[static_cast<size_t>((next_gray_row - 1) % ksize) * width],
+                                &gray_ring_[static_cast<size_t>(next_gray_row % ksize) * width]);
+            }
+            next_gray_row++;
+        }
+
+        // Vertical pass: Q8.8 column sums in 16-bit lanes (max 255 * 256)
+        for (int k = 0; k < ksize; k++) {
+            const uint8_t* gray = &gray_ring_[static_cast<size_t>(reflect101(y - radius + k, height) % ksize) * width];
+            const uint16_t w = weights[k];
+            if (k == 0) {
+                for (int x = 0; x < width; x++) {
+                    sums[x] = static_cast<uint16_t>(w * gray[x]);
+                }
+            } else {
+                for (int x = 0; x < width; x++) {
+                    sums[x] = static_cast<uint16_t>(sums[x] + w * gray[x]);
+                }
+            }
+        }
+
+        // Reflect-101 padding for the horizontal pass
+        for (int i = 1; i <= radius; i++) {
+            sums[-i] = sums[i];
+            sums[width - 1 + i] = sums[width - 1 - i];
+        }
+
+        // Horizontal pass: Q16 accumulation in 32-bit lanes
+        std::fill(row_acc, row_acc + width, 1u << 15);
+        for (int k = 0; k < ksize; k++) {
+            const uint16_t* src = sums - radius + k;
+            const uint32_t w = weights[k];
+            for (int x = 0; x < width; x++) {
+                row_acc[x] += w * src[x];
+            }
+        }
+
+        // Round, then contrast/brightness
+        uint8_t* dst = output.ptr<uint8_t>(y);
+        for (int x = 0; x < width; x++) {
+            dst[x] = lut_[row_acc[x] >> 16];
+        }
+    }
+
+    if (quality) {
+        quality->end();
+    }
+    return true;
+}
+
+size_t FastBlur::getMemoryBytes() const {
+    return gray_ring_.capacity() * sizeof(uint8_t) + column_sums_.capacity() * sizeof(uint16_t) +
+           row_acc_.capacity() * sizeof(uint32_t);
+}
+
+std::string FastBlur::getInfo() const {
+    std::ostringstream oss;
+    oss << "FastBlur " << kernel_size_ << "x" << kernel_size_ << " Q8 [";
+    for (size_t i = 0; i < kernel_.size(); i++) {
+        oss << (i > 0 ? " " : "") << kernel_[i];
+    }
+    oss << "]/256";
+    return oss.str();
+}
+
+void FastBlur::buildKernel() {
+    switch (kernel_size_) {
+        // Binomial kernels, identical to OpenCV's fixed kernels for sigma = 0
+        case 3: kernel_ = {64, 128, 64}; return;
+        case 5: kernel_ = {16, 64, 96, 64, 16}; return;
+        case 7: kernel_ = {8, 28, 56, 72, 56, 28, 8}; return;
+        default: break;
+    }
+
+    // Sampled Gaussian with OpenCV's default sigma for this size
+    const int radius = kernel_size_ / 2;
+    const double sigma = 0.3 * ((kernel_size_ - 1) * 0.5 - 1) + 0.8;
+    std::vector<double> gaussian(kernel_size_);
+    double total = 0.0;
+    for (int i = 0; i < kernel_size_; i++) {
+        double d = i - radius;
+        gaussian[i] = std::exp(-(d * d) / (2.0 * sigma * sigma));
+        total += gaussian[i];
+    }
+
+    kernel_.resize(kernel_size_);
+    int quantized_total = 0;
+    for (int i = 0; i < kernel_size_; i++) {
+        kernel_[i] = static_cast<uint16_t>(std::lround(gaussian[i] / total * 256.0));
+        quantized_total += kernel_[i];
+    }
+
+    // Put the rounding residue on the center tap so weights sum to exactly 256
+    kernel_[radius] = static_cast<uint16_t>(kernel_[radius] + (256 - quantized_total));
+}
+
+void FastBlur::buildLut(double alpha, double beta) {
+    for (int i = 0; i < 256; i++) {
+        lut_[i] = cv::saturate_cast<uchar>(alpha * i + beta);
+    }
+    lut_alpha_ = alpha;
+    lut_beta_ = beta;
+}
+
+void FastBlur::convertRow(const cv::Mat& input, int y, uint8_t* gray_row) const {
+    const uint8_t* src = input.ptr<uint8_t>(y);
+    const int width = input.cols;
+
+    if (input.channels() == 1) {
+        std::memcpy(gray_row, src, width);
+        return;
+    }
+
+    for (int x = 0; x < width; x++) {
+        const uint8_t* bgr = src + 3 * x;
+        gray_row[x] = static_cast<uint8_t>(
+            (bgr[0] * GRAY_B + bgr[1] * GRAY_G + bgr[2] * GRAY_R + (1 << (GRAY_SHIFT - 1))) >> GRAY_SHIFT);
+    }
+}
+
+} // namespace CodiceCam
@@ -0,0 +1,177 @@
+#include "FrameAccounting.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace CodiceCam {
+
+FrameAccounting::FrameAccounting()
+    : start_time_(std::chrono::steady_clock::now())
+    , next_sequence_(0)
+    , captured_(0)
+    , latency_budget_ms_(0)
+    , total_latency_ms_(0.0)
+    , max_latency_ms_(0.0)
+    , latency_samples_(0)
+{
+    counts_.fill(0);
+    for (auto& status_buckets : buckets_) {
+        status_buckets.fill(0);
+    }
+    bucket_second_.fill(-1);
+}
+
+FrameInfo FrameAccounting::beginFrame() {
+    FrameInfo frame;
+    frame.capture_time = std::chrono::steady_clock::now();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    frame.sequence = next_sequence_++;
+    captured_++;
+    return frame;
+}
+
+FrameStatus FrameAccounting::finishFrame(const FrameInfo& frame, FrameStatus status, const std::string& detail) {
+    auto now = std::chrono::steady_clock::now();
+    double latency_ms = std::chrono::duration<double, std::milli>(now - frame.capture_time).count();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (status == FrameStatus::DELIVERED || status == FrameStatus::OVER_BUDGET) {
+        total_latency_ms_ += latency_ms;
+        max_latency_ms_ = std::max(max_latency_ms_, latency_ms);
+        latency_samples_++;
+        if (latency_budget_ms_ > 0 && latency_ms > latency_budget_ms_) {
+            status = FrameStatus::OVER_BUDGET;
+        }
+    }
+
+    int index = static_cast<int>(status);
+    counts_[index]++;
+    if (!detail.empty()) {
+        details_[detail]++;
+    }
+
+    // Recycle the bucket if it still holds an older second
+    int64_t second = currentSecond();
+    int slot = static_cast<int>(second % RATE_WINDOW_SECONDS);
+    if (bucket_second_[slot] != second) {
+        bucket_second_[slot] = second;
+        for (auto& status_buckets : buckets_) {
+            status_buckets[slot] = 0;
+        }
+    }
+    buckets_[index][slot]++;
+
+    return status;
+}
+
+void FrameAccounting::setLatencyBudget(int budget_ms) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    latency_budget_ms_ = std::max(budget_ms, 0);
+}
+
+uint64_t FrameAccounting::getCount(FrameStatus status) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return counts_[static_cast<int>(status)];
+}
+
+double FrameAccounting::getRate(FrameStatus status) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return rateLocked(static_cast<int>(status), currentSecond());
+}
+
+uint64_t FrameAccounting::getInFlight() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t finished = 0;
+    for (uint64_t count : counts_) {
+        finished += count;
+    }
+    return captured_ > finished ? captured_ - finished : 0;
+}
+
+uint64_t FrameAccounting::getCaptured() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return captured_;
+}
+
+std::string FrameAccounting::getStatistics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int64_t now_second = currentSecond();
+
+    uint64_t finished = 0;
+    for (uint64_t count : counts_) {
+        finished += count;
+    }
+
+    std::ostringstream oss;
+    oss << "Frame Accounting:\n";
+    oss << "  Captured: " << captured_ << " (in flight: " << (captured_ > finished ? captured_ - finished : 0) << ")\n";
+    for (int i = 0; i < FRAME_STATUS_COUNT; i++) {
+        oss << "  " << getStatusName(static_cast<FrameStatus>(i)) << ": " << counts_[i]
+            << " (" << std::fixed << std::setprecision(1) << rateLocked(i, now_second) << "/s)\n";
+    }
+    if (latency_samples_ > 0) {
+        oss << "  Latency: avg " << std::fixed << std::setprecision(1) << (total_latency_ms_ / latency_samples_)
+            << "ms, max " << max_latency_ms_ << "ms";
+        if (latency_budget_ms_ > 0) {
+            oss << " (budget " << latency_budget_ms_ << "ms)";
+        }
+        oss << "\n";
+    }
+    if (!details_.empty()) {
+        oss << "  Reasons:\n";
+        for (const auto& [detail, count] : details_) {
+            oss << "    " << detail << ": " << count << "\n";
+        }
+    }
+    return oss.str();
+}
+
+void FrameAccounting::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    start_time_ = std::chrono::steady_clock::now();
+    captured_ = 0;
+    counts_.fill(0);
+    details_.clear();
+    for (auto& status_buckets : buckets_) {
+        status_buckets.fill(0);
+    }
+    bucket_second_.fill(-1);
+    total_latency_ms_ = 0.0;
+    max_latency_ms_ = 0.0;
+    latency_samples_ = 0;
+}
+
+const char* FrameAccounting::getStatusName(FrameStatus status) {
+    switch (status) {
+        case FrameStatus::DELIVERED: return "DELIVERED";
+        case FrameStatus::DROPPED_STALE: return "DROPPED_STALE";
+        case FrameStatus::DROPPED_QUEUE_FULL: return "DROPPED_QUEUE_FULL";
+        case FrameStatus::PROCESSING_ERROR: return "PROCESSING_ERROR";
+        case FrameStatus::OVER_BUDGET: return "OVER_BUDGET";
+        case FrameStatus::SKIPPED_STATIC: return "SKIPPED_STATIC";
+        default: return "UNKNOWN";
+    }
+}
+
+int64_t FrameAccounting::currentSecond() const {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::steady_clock::now() - start_time_).count();
+}
+
+double FrameAccounting::rateLocked(int status_index, int64_t now_second) const {
+    // Average over completed seconds of the window, excluding the current one
+    uint64_t total = 0;
+    int seconds = 0;
+    for (int64_t second = now_second - 1; second >= 0 && second > now_second - RATE_WINDOW_SECONDS; second--) {
+        int slot = static_cast<int>(second % RATE_WINDOW_SECONDS);
+        if (bucket_second_[slot] == second) {
+            total += buckets_[status_index][slot];
+        }
+        seconds++;
+    }
+    return seconds > 0 ? static_cast<double>(total) / seconds : 0.0;
+}
+
+} // namespace CodiceCam
@@ -0,0 +1,63 @@
+#include "FrameDataset.h"
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+
+namespace CodiceCam {
+
+bool FrameDataset::load(const std::string& path, std::vector<cv::Mat>& frames) {
+    std::error_code error;
+    if (std::filesystem::is_directory(path, error)) {
+        std::vector<std::string> files;
+        for (const auto& entry : std::filesystem::directory_iterator(path, error)) {
+            if (entry.is_regular_file()) {
+                files.push_back(entry.path().string());
+            }
+        }
+        std::sort(files.begin(), files.end());
+
+        for (const auto& file : files) {
+            cv::Mat frame = cv::imread(file, cv::IMREAD_COLOR);
+            if (frame.empty()) {
+                std::cerr << "⚠️  Skipping unreadable image: " << file << std::endl;
+                continue;
+            }
+            frames.push_back(frame);
+        }
+    } else {
+        cv::VideoCapture video(path);
+        if (!video.isOpened()) {
+            std::cerr << "❌ Failed to open dataset: " << path << std::endl;
+            return false;
+        }
+        cv::Mat frame;
+        while (video.read(frame)) {
+            frames.push_back(frame.clone());
+        }
+    }
+
+    if (frames.empty()) {
+        std::cerr << "❌ No frames in dataset: " << path << std::endl;
+        return false;
+    }
+    std::cout << "✅ Loaded " << frames.size() << " frames from " << path << std::endl;
+    return true;
+}
+
+MismatchLog::MismatchLog(size_t max_printed)
+    : max_printed_(max_printed)
+    , count_(0)
+{
+}
+
+void MismatchLog::add(size_t frame, const std::string& problem) {
+    if (count_++ < max_printed_) {
+        std::cout << "    frame " << frame << ": " << problem << std::endl;
+    }
+}
+
+size_t MismatchLog::getCount() const {
+    return count_;
+}
+
+} // namespace CodiceCam
@@ -0,0 +1,285 @@
+#include "FrameParallelDetector.h"
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+
+namespace CodiceCam {
+
+FrameParallelDetector::FrameParallelDetector(const ParallelDetectionConfig& config)
+    : config_(config)
+    , accounting_(nullptr)
+    , running_(false)
+    , submitted_(0)
+    , committed_(0)
+    , dropped_in_flight_(0)
+    , skipped_late_(0)
+    , detection_errors_(0)
+    , commit_errors_(0)
+    , max_depth_(0)
+{
+    config_.contexts = std::max(1, config_.contexts);
+    if (config_.max_in_flight <= 0) {
+        config_.max_in_flight = 2 * config_.contexts;
+    }
+    config_.max_in_flight = std::max(config_.max_in_flight, config_.contexts);
+    if (config_.deterministic) {
+        config_.max_lateness_ms = 0;
+    }
+}
+
+FrameParallelDetector::~FrameParallelDetector() {
+    stop();
+}
+
+bool FrameParallelDetector::start(DetectFunction detect, CommitFunction commit, FrameAccounting* accounting) {
+    if (!detect || !commit) {
+        std::cerr << "❌ Invalid detect or commit function." << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) {
+        std::cerr << "⚠️ Parallel detector already running." << std::endl;
+        return false;
+    }
+
+    detect_ = detect;
+    commit_ = commit;
+    accounting_ = accounting;
+    running_ = true;
+    for (int i = 0; i < config_.contexts; i++) {
+        contexts_.emplace_back(&FrameParallelDetector::contextLoop, this, i);
+    }
+
+    std::cout << "⚙️ Frame-parallel detection: " << config_.contexts << " contexts, "
+              << config_.max_in_flight << " frames in flight"
+              << (config_.deterministic ? " (deterministic)" : "") << std::endl;
+    return true;
+}
+
+void FrameParallelDetector::stop() {
+    std::deque<std::shared_ptr<Slot>> dropped;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+
+        // Queued frames never reach a context; take them out of the reorder buffer too
+        dropped.swap(pending_);
+        for (const auto& slot : dropped) {
+            window_.erase(std::find(window_.begin(), window_.end(), slot));
+        }
+    }
+    work_cv_.notify_all();
+    room_cv_.notify_all();
+
+    for (const auto& slot : dropped) {
+        finish(slot->info, FrameStatus::DROPPED_STALE, "shutdown");
+    }
+    for (auto& context : contexts_) {
+        if (context.joinable()) {
+            context.join();
+        }
+    }
+    contexts_.clear();
+
+    // Frames that finished detection after the last commit pass
+    commitReady();
+}
+
+bool FrameParallelDetector::submit(const cv::Mat& frame, const FrameInfo& info) {
+    auto slot = std::make_shared<Slot>();
+    slot->info = info;
+    slot->frame = frame;
+
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (config_.deterministic) {
+            room_cv_.wait(lock, [this]() {
+                return !running_ || window_.size() < static_cast<size_t>(config_.max_in_flight);
+            });
+        }
+        if (!running_ || window_.size() >= static_cast<size_t>(config_.max_in_flight)) {
+            dropped_in_flight_++;
+            slot.reset();
+        } else {
+            window_.push_back(slot);
+            pending_.push_back(slot);
+            max_depth_ = std::max(max_depth_, window_.size());
+        }
+    }
+
+    if (!slot) {
+        finish(info, FrameStatus::DROPPED_QUEUE_FULL, "in_flight_limit");
+        return false;
+    }
+
+    submitted_++;
+    work_cv_.notify_one();
+    return true;
+}
+
+void FrameParallelDetector::drain() {
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        room_cv_.wait(lock, [this]() { return !running_ || window_.empty(); });
+    }
+    // The last frame leaves the window before its commit returns
+    std::lock_guard<std::mutex> commit_lock(commit_mutex_);
+}
+
+int FrameParallelDetector::getContextCount() const {
+    return config_.contexts;
+}
+
+size_t FrameParallelDetector::getInFlightBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t bytes = 0;
+    for (const auto& slot : window_) {
+        bytes += slot->frame.total() * slot->frame.elemSize();
+    }
+    return bytes;
+}
+
+std::string FrameParallelDetector::getStatistics() const {
+    size_t depth;
+    size_t max_depth;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        depth = window_.size();
+        max_depth = max_depth_;
+    }
+
+    std::ostringstream oss;
+    oss << "Frame-Parallel Detection:\n";
+    oss << "  Contexts: " << config_.contexts << "\n";
+    oss << "  In flight: " << depth << "/" << config_.max_in_flight << " (max " << max_depth << ")\n";
+    oss << "  Submitted: " << submitted_.load() << "\n";
+    oss << "  Committed: " << committed_.load() << "\n";
+    oss << "  Dropped at in-flight limit: " << dropped_in_flight_.load() << "\n";
+    oss << "  Skipped as late: " << skipped_late_.load() << "\n";
+    oss << "  Detection errors: " << detection_errors_.load() << "\n";
+    oss << "  Commit errors: " << commit_errors_.load() << "\n";
+    return oss.str();
+}
+
+void FrameParallelDetector::contextLoop(int index) {
+    while (true) {
+        std::shared_ptr<Slot> slot;
+        bool late = false;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_cv_.wait(lock, [this]() { return !running_ || !pending_.empty(); });
+            if (pending_.empty()) {
+                return;
+            }
+            slot = pending_.front();
+            pending_.pop_front();
+
+            // Waited too long while newer frames queued behind it
+            auto age = std::chrono::steady_clock::now() - slot->info.capture_time;
+            if (config_.max_lateness_ms > 0 && !pending_.empty() &&
+                age > std::chrono::milliseconds(config_.max_lateness_ms)) {
+                window_.erase(std::find(window_.begin(), window_.end(), slot));
+                late = true;
+            }
+        }
+
+        if (late) {
+            skipped_late_++;
+            finish(slot->info, FrameStatus::DROPPED_STALE, "late_dispatch");
+            // The head of the reorder buffer may now be committable
+            commitReady();
+            continue;
+        }
+
+        bool ok = false;
+        try {
+            ok = detect_(index, slot->frame, slot->info, slot->markers);
+        } catch (const std::exception& e) {
+            std::cerr << "❌ Error in detector context " << index << ": " << e.what() << std::endl;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            slot->done = true;
+            slot->ok = ok;
+        }
+        commitReady();
+    }
+}
+
+void FrameParallelDetector::commitReady() {
+    std::lock_guard<std::mutex> commit_lock(commit_mutex_);
+
+    while (true) {
+        std::shared_ptr<Slot> slot;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            skipLateHeadLocked(std::chrono::steady_clock::now());
+            if (window_.empty() || !window_.front()->done) {
+                return;
+            }
+            slot = window_.front();
+            window_.pop_front();
+        }
+        room_cv_.notify_all();
+
+        if (!slot->ok) {
+            detection_errors_++;
+            finish(slot->info, FrameStatus::PROCESSING_ERROR, "detection_failed");
+            continue;
+        }
+
+        FrameStatus status;
+        std::string detail;
+        try {
+            status = commit_(slot->frame, slot->info, slot->markers);
+            committed_++;
+        } catch (const std::exception& e) {
+            std::cerr << "❌ Error in commit function: " << e.what() << std::endl;
+            commit_errors_++;
+            status = FrameStatus::PROCESSING_ERROR;
+            detail = "commit_exception";
+        }
+        finish(slot->info, status, detail);
+    }
+}
+
+void FrameParallelDetector::skipLateHeadLocked(std::chrono::steady_clock::time_point now) {
+    if (config_.max_lateness_ms <= 0) {
+        return;
+    }
+
+    // Skip unfinished head frames only when a newer frame could be committed instead
+    while (!window_.empty() && !window_.front()->done) {
+        auto ready = std::find_if(window_.begin(), window_.end(),
+                                  [](const std::shared_ptr<Slot>& slot) { return slot->done; });
+        std::shared_ptr<Slot> head = window_.front();
+        if (ready == window_.end() ||
+            now - head->info.capture_time <= std::chrono::milliseconds(config_.max_lateness_ms)) {
+            return;
+        }
+
+        // A context already detecting it finishes and its result is discarded
+        skipped_late_++;
+        finish(head->info, FrameStatus::DROPPED_STALE, "late_frame");
+        window_.pop_front();
+
+        // A skipped frame still waiting for a context is not detected at all
+        auto queued = std::find(pending_.begin(), pending_.end(), head);
+        if (queued != pending_.end()) {
+            pending_.erase(queued);
+        }
+    }
+}
+
+void FrameParallelDetector::finish(const FrameInfo& info, FrameStatus status, const std::string& detail) {
+    if (accounting_) {
+        accounting_->finishFrame(info, status, detail);
+    }
+}
+
+} // namespace CodiceCam
@@ -0,0 +1,308 @@
+#include "FramePoolAllocator.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <sstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CODICE_FRAME_POOL_MMAP 1
+#include <sys/mman.h>
+#else
+#define CODICE_FRAME_POOL_MMAP 0
+#endif
+
+// From OpenCV's C API headers, which opencv.hpp no longer includes
+#ifndef CV_AUTOSTEP
+#define CV_AUTOSTEP 0x7fffffff
+#endif
+
+namespace CodiceCam {
+
+namespace {
+    // Cache line / widest SIMD load
+    const size_t BUFFER_ALIGNMENT = 64;
+
+    // x86-64 and AArch64 huge page size; regions are multiples of it
+    const size_t HUGE_PAGE_BYTES = 2 * 1024 * 1024;
+
+    // Touch stride when prefaulting a region
+    const size_t SMALL_PAGE_BYTES = 4096;
+
+    // Buffers up to this size use power-of-two classes, larger ones 64 KiB steps
+    const size_t SMALL_CLASS_LIMIT = 64 * 1024;
+    const size_t LARGE_CLASS_STEP = 64 * 1024;
+
+    // Marks a UMatData that lives in a pool block header
+    const int POOLED_BLOCK = 1;
+
+    size_t alignUp(size_t value, size_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    size_t sizeClass(size_t bytes) {
+        if (bytes > SMALL_CLASS_LIMIT) {
+            return alignUp(bytes, LARGE_CLASS_STEP);
+        }
+        size_t result = BUFFER_ALIGNMENT;
+        while (result < bytes) {
+            result <<= 1;
+        }
+        return result;
+    }
+}
+
+FramePoolAllocator::FramePoolAllocator(const FramePoolConfig& config)
+    : config_(config)
+    , mapped_bytes_(0)
+    , reused_(0)
+    , carved_(0)
+    , fallback_(0)
+    , in_use_(0)
+{
+}
+
+FramePoolAllocator::~FramePoolAllocator() {
+    for (const Region& region : regions_) {
+        unmapRegion(region);
+    }
+}
+
+cv::UMatData* FramePoolAllocator::allocate(int dims, const int* sizes, int type, void* data, size_t* step,
+                                           cv::AccessFlag flags, cv::UMatUsageFlags usage_flags) const {
+    (void)flags;
+    (void)usage_flags;
+
+    // Same step computation as OpenCV's standard allocator
+    size_t total = CV_ELEM_SIZE(type);
+    for (int i = dims - 1; i >= 0; i--) {
+        if (step) {
+            if (data && step[i] != CV_AUTOSTEP) {
+                total = step[i];
+            } else {
+                step[i] = total;
+            }
+        }
+        total *= sizes[i];
+    }
+
+    if (!data && total >= config_.min_pooled_bytes) {
+        BlockHeader* block = acquireBlock(sizeClass(total));
+        if (block) {
+            // The UMatData slot follows the block header, the buffer follows the slot
+            char* base = reinterpret_cast<char*>(block);
+            cv::UMatData* u = new (base + slotOffset()) cv::UMatData(this);
+            u->data = u->origdata = reinterpret_cast<uchar*>(base + headerBytes());
+            u->size = total;
+            u->allocatorFlags_ = POOLED_BLOCK;
+            in_use_++;
+            return u;
+        }
+    }
+
+    fallback_++;
+    cv::UMatData* u = new cv::UMatData(this);
+    u->data = u->origdata = data ? static_cast<uchar*>(data) : static_cast<uchar*>(cv::fastMalloc(total));
+    u->size = total;
+    if (data) {
+        u->flags |= cv::UMatData::USER_ALLOCATED;
+    }
+    return u;
+}
+
+bool FramePoolAllocator::allocate(cv::UMatData* data, cv::AccessFlag access_flags, cv::UMatUsageFlags usage_flags) const {
+    (void)access_flags;
+    (void)usage_flags;
+    return data != nullptr;
+}
+
+void FramePoolAllocator::deallocate(cv::UMatData* u) const {
+    if (!u) {
+        return;
+    }
+    CV_Assert(u->urefcount == 0);
+    CV_Assert(u->refcount == 0);
+
+    if (u->allocatorFlags_ & POOLED_BLOCK) {
+        BlockHeader* block = reinterpret_cast<BlockHeader*>(reinterpret_cast<char*>(u) - slotOffset());
+        u->~UMatData();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        BlockHeader*& head = free_lists_[block->class_bytes];
+        block->next_free = head;
+        head = block;
+        in_use_--;
+        return;
+    }
+
+    if (!(u->flags & cv::UMatData::USER_ALLOCATED)) {
+        cv::fastFree(u->origdata);
+        u->origdata = nullptr;
+    }
+    delete u;
+}
+
+std::string FramePoolAllocator::getStatistics() const {
+    size_t region_count;
+    size_t huge_regions = 0;
+    size_t mapped_bytes;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        region_count = regions_.size();
+        mapped_bytes = mapped_bytes_;
+        for (const Region& region : regions_) {
+            if (region.huge_pages) {
+                huge_regions++;
+            }
+        }
+    }
+
+    std::ostringstream oss;
+    oss << "Frame Pool:\n";
+    oss << "  Regions: " << region_count << " (" << mapped_bytes / (1024 * 1024) << " MiB, "
+        << huge_regions << " on explicit huge pages)\n";
+    oss << "  Buffers reused: " << reused_.load() << "\n";
+    oss << "  Buffers carved: " << carved_.load() << "\n";
+    oss << "  Buffers in use: " << in_use_.load() << "\n";
+    oss << "  System allocator fallbacks: " << fallback_.load() << "\n";
+    return oss.str();
+}
+
+FramePoolAllocator* FramePoolAllocator::installAsDefault(const FramePoolConfig& config) {
+    static std::once_flag once;
+    static FramePoolAllocator* pool = nullptr;
+
+    std::call_once(once, [&config]() {
+        // Never destroyed: pooled Mats may be released after main() returns
+        pool = new FramePoolAllocator(config);
+        cv::Mat::setDefaultAllocator(pool);
+        std::cout << "🗄️ Frame pool allocator installed (" << config.region_bytes / (1024 * 1024)
+                  << " MiB regions, huge pages " << (config.huge_pages ? "requested" : "off") << ")" << std::endl;
+    });
+
+    return pool;
+}
+
+FramePoolAllocator::BlockHeader* FramePoolAllocator::acquireBlock(size_t class_bytes) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = free_lists_.find(class_bytes);
+    if (it != free_lists_.end() && it->second) {
+        BlockHeader* block = it->second;
+        it->second = block->next_free;
+        reused_++;
+        return block;
+    }
+
+    BlockHeader* block = carveBlock(class_bytes);
+    if (block) {
+        carved_++;
+    }
+    return block;
+}
+
+FramePoolAllocator::BlockHeader* FramePoolAllocator::carveBlock(size_t class_bytes) const {
+    size_t block_bytes = headerBytes() + class_bytes;
+
+    if (regions_.empty() || regions_.back().bytes - regions_.back().used < block_bytes) {
+        // The tail of the previous region stays unused
+        if (!mapRegion(std::max(config_.region_bytes, block_bytes))) {
+            return nullptr;
+        }
+    }
+
+    Region& region = regions_.back();
+    BlockHeader* block = reinterpret_cast<BlockHeader*>(region.base + region.used);
+    region.used += block_bytes;
+    block->class_bytes = class_bytes;
+    block->next_free = nullptr;
+    return block;
+}
+
+bool FramePoolAllocator::mapRegion(size_t bytes) const {
+    bytes = alignUp(bytes, HUGE_PAGE_BYTES);
+    if (mapped_bytes_ + bytes > config_.max_pool_bytes) {
+        return false;
+    }
+
+    Region region{nullptr, bytes, 0, false};
+
+#if CODICE_FRAME_POOL_MMAP
+#ifdef MAP_HUGETLB
+    if (config_.huge_pages) {
+        int populate = 0;
+#ifdef MAP_POPULATE
+        populate = MAP_POPULATE;
+#endif
+        // Fails unless huge pages are reserved (vm.nr_hugepages)
+        void* mapped = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | populate, -1, 0);
+        if (mapped != MAP_FAILED) {
+            region.base = static_cast<char*>(mapped);
+            region.huge_pages = true;
+        }
+    }
+#endif
+
+    if (!region.base) {
+        // Over-map by one huge page so the region starts on a 2 MiB boundary
+        size_t span = bytes + HUGE_PAGE_BYTES;
+        void* mapped = mmap(nullptr, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mapped == MAP_FAILED) {
+            std::cerr << "⚠️ Frame pool failed to map " << bytes / (1024 * 1024) << " MiB region ("
+                      << std::strerror(errno) << "), using the system allocator" << std::endl;
+            return false;
+        }
+
+        char* raw = static_cast<char*>(mapped);
+        char* aligned = reinterpret_cast<char*>(alignUp(reinterpret_cast<uintptr_t>(raw), HUGE_PAGE_BYTES));
+        size_t head = static_cast<size_t>(aligned - raw);
+        if (head > 0) {
+            munmap(raw, head);
+        }
+        if (span - head > bytes) {
+            munmap(aligned + bytes, span - head - bytes);
+        }
+
+#ifdef MADV_HUGEPAGE
+        if (config_.huge_pages) {
+            // Transparent huge pages; ignored when THP is disabled
+            madvise(aligned, bytes, MADV_HUGEPAGE);
+        }
+#endif
+
+        // Fault the region in now so steady-state frames never page-fault
+        for (size_t offset = 0; offset < bytes; offset += SMALL_PAGE_BYTES) {
+            aligned[offset] = 0;
+        }
+        region.base = aligned;
+    }
+#else
+    region.base = static_cast<char*>(cv::fastMalloc(bytes));
+#endif
+
+    regions_.push_back(region);
+    mapped_bytes_ += bytes;
+    std::cout << "🗄️ Frame pool region " << regions_.size() << ": " << bytes / (1024 * 1024) << " MiB"
+              << (region.huge_pages ? " (huge pages)" : "") << std::endl;
+    return true;
+}
+
+size_t FramePoolAllocator::slotOffset() {
+    return alignUp(sizeof(BlockHeader), alignof(cv::UMatData));
+}
+
+size_t FramePoolAllocator::headerBytes() {
+    return alignUp(slotOffset() + sizeof(cv::UMatData), BUFFER_ALIGNMENT);
+}
+
+void FramePoolAllocator::unmapRegion(const Region& region) {
+#if CODICE_FRAME_POOL_MMAP
+    munmap(region.base, region.bytes);
+#else
+    cv::fastFree(region.base);
+#endif
+}
+
+} // namespace CodiceCam
@@ -0,0 +1,141 @@
+#include "FrameQuality.h"
+#include <algorithm>
+
+namespace CodiceCam {
+
+namespace {
+    double variance(int64_t sum, int64_t sq, uint64_t n) {
+        if (n == 0) {
+            return 0.0;
+        }
+        double mean = static_cast<double>(sum) / n;
+        return std::max(0.0, static_cast<double>(sq) / n - mean * mean);
+    }
+}
+
+FrameQualityMap::FrameQualityMap(const FrameQualityConfig& config)
+    : cols_(0)
+    , rows_(0)
+    , valid_(false)
+{
+    setConfig(config);
+}
+
+void FrameQualityMap::setConfig(const FrameQualityConfig& config) {
+    config_ = config;
+    config_.tile_size = std::max(4, config_.tile_size);
+    config_.sample_step = std::max(1, std::min(config_.sample_step, config_.tile_size));
+    valid_ = false;
+}
+
+const FrameQualityConfig& FrameQualityMap::getConfig() const {
+    return config_;
+}
+
+bool FrameQualityMap::estimate(const cv::Mat& frame) {
+    valid_ = false;
+    if (frame.empty() || frame.depth() != CV_8U || (frame.channels() != 1 && frame.channels() != 3)) {
+        return false;
+    }
+
+    const cv::Mat* gray = &frame;
+    if (frame.channels() == 3) {
+        cv::cvtColor(frame, gray_, cv::COLOR_BGR2GRAY);
+        gray = &gray_;
+    }
+
+    begin(gray->size());
+    for (int y = 1; y < gray->rows - 1; y++) {
+        addRow(y, gray->ptr<uchar>(y - 1), gray->ptr<uchar>(y), gray->ptr<uchar>(y + 1));
+    }
+    end();
+    return true;
+}
+
+void FrameQualityMap::begin(cv::Size frame_size) {
+    int tile = config_.tile_size;
+    frame_size_ = frame_size;
+    cols_ = (frame_size.width + tile - 1) / tile;
+    rows_ = (frame_size.height + tile - 1) / tile;
+    tiles_.assign(static_cast<size_t>(cols_) * rows_, Tile());
+    valid_ = false;
+}
+
+void FrameQualityMap::addRow(int y, const uchar* above, const uchar* row, const uchar* below) {
+    int step = config_.sample_step;
+    if (y < 1 || y >= frame_size_.height - 1 || (y - 1) % step != 0) {
+        return;
+    }
+
+    int tile = config_.tile_size;
+    int clip_low = config_.clip_low;
+    int clip_high = config_.clip_high;
+    Tile* tile_row = &tiles_[static_cast<size_t>(y / tile) * cols_];
+
+    // Second differences at every step-th pixel, from its direct neighbours
+    for (int x = 1; x < frame_size_.width - 1; x += step) {
+        int c = row[x];
+        int dxx = 2 * c - row[x - 1] - row[x + 1];
+        int dyy = 2 * c - above[x] - below[x];
+
+        Tile& t = tile_row[x / tile];
+        t.samples++;
+        t.clipped += (c <= clip_low || c >= clip_high) ? 1 : 0;
+        t.sum_xx += dxx;
+        t.sq_xx += dxx * dxx;
+        t.sum_yy += dyy;
+        t.sq_yy += dyy * dyy;
+    }
+}
+
+void FrameQualityMap::end() {
+    valid_ = true;
+}
+
+bool FrameQualityMap::isValid() const {
+    return valid_;
+}
+
+RegionQuality FrameQualityMap::measure(const cv::Rect& region) const {
+    RegionQuality quality;
+    cv::Rect bounds = region & cv::Rect(0, 0, frame_size_.width, frame_size_.height);
+    if (!valid_ || bounds.area() <= 0) {
+        return quality;
+    }
+
+    int tile = config_.tile_size;
+    Tile total;
+    for (int ty = bounds.y / tile; ty <= (bounds.y + bounds.height - 1) / tile; ty++) {
+        for (int tx = bounds.x / tile; tx <= (bounds.x + bounds.width - 1) / tile; tx++) {
+            const Tile& t = tiles_[static_cast<size_t>(ty) * cols_ + tx];
+            total.samples += t.samples;
+            total.clipped += t.clipped;
+            total.sum_xx += t.sum_xx;
+            total.sq_xx += t.sq_xx;
+            total.sum_yy += t.sum_yy;
+            total.sq_yy += t.sq_yy;
+        }
+    }
+
+    quality.samples = total.samples;
+    if (total.samples > 0) {
+        quality.sharpness = std::min(variance(total.sum_xx, total.sq_xx, total.samples),
+                                     variance(total.sum_yy, total.sq_yy, total.samples));
+        quality.clipped_ratio = static_cast<double>(total.clipped) / total.samples;
+    }
+    return quality;
+}
+
+bool FrameQualityMap::isDecodable(const cv::Rect& region) const {
+    RegionQuality quality = measure(region);
+    if (quality.samples == 0) {
+        return true;
+    }
+    return !quality.isBlurred(config_) && !quality.isClipped(config_);
+}
+
+size_t FrameQualityMap::getMemoryBytes() const {
+    return tiles_.capacity() * sizeof(Tile) + gray_.total() * gray_.elemSize();
+}
+
+} // namespace CodiceCam
@@ -0,0 +1,101 @@
+#include "IdleMonitor.h"
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+
+namespace CodiceCam {
+
+IdleMonitor::IdleMonitor(const IdleConfig& config)
+    : config_(config)
+    , last_activity_(std::chrono::steady_clock::now().time_since_epoch().count())
+    , idle_(false)
+    , idle_entries_(0)
+    , wakeups_(0)
+    , checks_(0)
+    , idle_ms_(0)
+    , idle_now_(false)
+{
+    config_.downscale = std::max(1, config_.downscale);
+}
+
+void IdleMonitor::reportMarkers(size_t marker_count) {
+    if (marker_count > 0) {
+        last_activity_ = std::chrono::steady_clock::now().time_since_epoch().count();
+    }
+}
+
+bool IdleMonitor::checkFrame(const cv::Mat& frame, std::chrono::steady_clock::time_point now) {
+    last_check_ = now;
+    if (frame.empty()) {
+        return false;
+    }
+    checks_++;
+
+    cv::Size small_size(std::max(1, frame.cols / config_.downscale), std::max(1, frame.rows / config_.downscale));
+    cv::resize(frame, small_, small_size, 0, 0, cv::INTER_AREA);
+    if (small_.channels() == 3) {
+        cv::cvtColor(small_, small_, cv::COLOR_BGR2GRAY);
+    }
+
+    bool motion;
+    if (reference_.empty() || reference_.size() != small_.size() || reference_.type() != small_.type()) {
+        motion = true;  // Nothing to compare with yet
+    } else {
+        cv::absdiff(small_, reference_, diff_);
+        cv::threshold(diff_, diff_, config_.pixel_threshold, 255, cv::THRESH_BINARY);
+        int changed = cv::countNonZero(diff_);
+        motion = changed > config_.motion_fraction * static_cast<double>(diff_.total());
+    }
+    std::swap(reference_, small_);
+
+    if (motion) {
+        markActivity(now);
+    }
+    return motion;
+}
+
+bool IdleMonitor::isCheckDue(std::chrono::steady_clock::time_point now) const {
+    return now - last_check_ >= std::chrono::milliseconds(config_.check_interval_ms);
+}
+
+bool IdleMonitor::isIdle(std::chrono::steady_clock::time_point now) {
+    if (idle_) {
+        return true;
+    }
+
+    std::chrono::steady_clock::time_point last_activity{std::chrono::steady_clock::duration(last_activity_.load())};
+    if (now - last_activity < std::chrono::milliseconds(config_.idle_after_ms)) {
+        return false;
+    }
+
+    idle_ = true;
+    idle_now_ = true;
+    idle_since_ = now;
+    idle_entries_++;
+    std::cout << "💤 No markers or motion for " << config_.idle_after_ms / 1000 << "s, entering idle mode ("
+              << 1000 / std::max(1, config_.check_interval_ms) << " FPS motion check)" << std::endl;
+    return true;
+}
+
+std::string IdleMonitor::getStatistics() const {
+    std::ostringstream oss;
+    oss << "Idle Monitor:\n";
+    oss << "  State: " << (idle_now_ ? "idle" : "active") << "\n";
+    oss << "  Idle periods: " << idle_entries_.load() << " (" << wakeups_.load() << " woken by motion)\n";
+    oss << "  Time idle: " << idle_ms_.load() / 1000 << " s\n";
+    oss << "  Motion checks: " << checks_.load() << "\n";
+    return oss.str();
+}
+
+void IdleMonitor::markActivity(std::chrono::steady_clock::time_point now) {
+    last_activity_ = now.time_since_epoch().count();
+    if (idle_) {
+        idle_ = false;
+        idle_now_ = false;
+        wakeups_++;
+        idle_ms_ += std::chrono::duration_cast<std::chrono::milliseconds>(now - idle_since_).count();
+        std::cout << "⏰ Motion detected, leaving idle mode" << std::endl;
+    }
+}
+
+} // namespace CodiceCam
@@ -1,9 +1,18 @@
 #include "ImageProcessor.h"
+#include "QuadApprox.h"
 #include <iostream>
 #include <algorithm>
+#include <cmath>
 
 namespace CodiceCam {
 
+namespace {
+    // Bounded tracing limits, relative to the largest marker side
+    const double CONTOUR_SIZE_SLACK = 1.25;  // Perspective and blur
+    const int CONTOUR_EXTENT_MARGIN = 8;     // Edge thickness
+    const int CONTOUR_LENGTH_FACTOR = 6;     // Border steps per extent, for jagged edges
+}
+
 ImageProcessor::ImageProcessor()
     : blur_kernel_size_(5)
     , contrast_alpha_(1.2)
@@ -13,6 +22,16 @@ ImageProcessor::ImageProcessor()
     , min_contour_area_(1000)
     , max_contour_area_(50000)
     , min_contour_perimeter_(100)
+    , fast_blur_(5)
+    , fast_blur_enabled_(false)
+    , bounded_tracing_enabled_(true)
+    , max_marker_size_(0)
+    , quality_gating_enabled_(false)
+    , contrast_lut_alpha_(1.0)
+    , contrast_lut_beta_(0)
+    , profiler_(nullptr)
+    , truncated_frames_(0)
+    , truncated_contours_(0)
 {
 }
 
@@ -32,16 +51,23 @@ bool ImageProcessor::processFrame(const cv::Mat& input_frame, cv::Mat& processed
 
     try {
         // Step 1: Preprocess the frame (grayscale, blur, contrast)
-        cv::Mat preprocessed = preprocessFrame(input_frame);
+        cv::Mat preprocessed;
+        {
+            StageProfiler::Scope stage(profiler_, "preprocess");
+            preprocessed = preprocessFrame(input_frame);
+        }
 
         // Step 2: Detect edges
-        cv::Mat edges = detectEdges(preprocessed);
-
-        // Store the processed frame (edges for contour detection)
-        processed_frame = edges.clone();
+        cv::Mat edges;
+        {
+            StageProfiler::Scope stage(profiler_, "detectEdges");
+            edges = detectEdges(preprocessed);
+        }
 
-        // Store the preprocessed frame for pattern reading
-        preprocessed_frame_ = preprocessed.clone();
+        // Hand over the edges (for contour detection) and keep the preprocessed frame
+        // (for pattern reading); both are fresh buffers, so no copies are needed
+        processed_frame = edges;
+        preprocessed_frame_ = preprocessed;
 
         return true;
     } catch (const cv::Exception& e) {
@@ -57,16 +83,38 @@ bool ImageProcessor::findMarkerContours(const cv::Mat& processed_frame, std::vec
     }
 
     try {
+        StageProfiler::Scope stage(profiler_, "findContours");
+
+        if (size_prior_) {
+            size_prior_->setImageSize(processed_frame.size());
+        }
+
         // Find all contours
-        std::vector<cv::Vec4i> hierarchy;
-        cv::findContours(processed_frame, contours, hierarchy, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
-        
+        if (bounded_tracing_enabled_ && processed_frame.type() == CV_8UC1) {
+            // Largest side any marker could have, with slack for perspective
+            double max_side = std::sqrt(max_contour_area_);
+            if (max_marker_size_ > 0) {
+                max_side = std::min(max_side, static_cast<double>(max_marker_size_));
+            }
+            max_side *= CONTOUR_SIZE_SLACK;
+
+            // A rotated square spans side * sqrt(2); its border is about four sides long
+            int max_extent = static_cast<int>(std::ceil(max_side * std::sqrt(2.0))) + CONTOUR_EXTENT_MARGIN;
+            contour_tracer_.setLimits(max_extent, max_extent * CONTOUR_LENGTH_FACTOR);
+            contour_tracer_.trace(processed_frame, contours);
+        } else {
+            std::vector<cv::Vec4i> hierarchy;
+            cv::findContours(processed_frame, contours, hierarchy, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+        }
+
         std::cout << "🔍 [DEBUG] Found " << contours.size() << " raw contours" << std::endl;
 
         // Limit the number of contours to process to prevent hanging
         const int MAX_CONTOURS_TO_PROCESS = 1000;
         if (contours.size() > MAX_CONTOURS_TO_PROCESS) {
             std::cout << "⚠️ [DEBUG] Too many contours (" << contours.size() << "), limiting to " << MAX_CONTOURS_TO_PROCESS << std::endl;
+            truncated_frames_++;
+            truncated_contours_ += contours.size() - MAX_CONTOURS_TO_PROCESS;
             contours.resize(MAX_CONTOURS_TO_PROCESS);
         }
 
@@ -105,6 +153,24 @@ void ImageProcessor::setPreprocessingParams(int blur_kernel_size, double contras
               << ", contrast=" << contrast_alpha_ << ", brightness=" << brightness_beta_ << std::endl;
 }
 
+void ImageProcessor::setFastBlurEnabled(bool enable) {
+    fast_blur_enabled_ = enable;
+    std::cout << "⚙️ Fast blur " << (enable ? "enabled" : "disabled") << std::endl;
+}
+
+void ImageProcessor::setBoundedTracingEnabled(bool enable) {
+    bounded_tracing_enabled_ = enable;
+    std::cout << "⚙️ Bounded contour tracing " << (enable ? "enabled" : "disabled") << std::endl;
+}
+
+void ImageProcessor::setSizePrior(std::shared_ptr<SizePriorMap> size_prior) {
+    size_prior_ = std::move(size_prior);
+}
+
+void ImageProcessor::setMaxMarkerSize(int max_marker_size) {
+    max_marker_size_ = max_marker_size;
+}
+
 void ImageProcessor::setEdgeDetectionParams(int low_threshold, int high_threshold) {
     canny_low_threshold_ = low_threshold;
     canny_high_threshold_ = high_threshold;
@@ -122,11 +188,19 @@ void ImageProcessor::setContourFilterParams(double min_area, double max_area, do
               << "," << max_contour_area_ << "], min_perimeter=" << min_contour_perimeter_ << std::endl;
 }
 
+void ImageProcessor::setProfiler(StageProfiler* profiler) {
+    profiler_ = profiler;
+}
+
 std::string ImageProcessor::getParameterInfo() const {
     std::string info = "ImageProcessor Parameters:\n";
     info += "  Preprocessing: blur=" + std::to_string(blur_kernel_size_) +
             ", contrast=" + std::to_string(contrast_alpha_) +
             ", brightness=" + std::to_string(brightness_beta_) + "\n";
+    if (blur_kernel_size_ > 1) {
+        bool fused = fast_blur_enabled_ && blur_kernel_size_ <= FastBlur::MAX_KERNEL_SIZE;
+        info += std::string("  Blur: ") + (fused ? "fused fixed-point" : "cv::GaussianBlur") + "\n";
+    }
     info += "  Edge Detection: low=" + std::to_string(canny_low_threshold_) +
             ", high=" + std::to_string(canny_high_threshold_) + "\n";
     info += "  Contour Filter: area=[" + std::to_string(min_contour_area_) +
@@ -137,27 +211,91 @@ std::string ImageProcessor::getParameterInfo() const {
 
 cv::Mat ImageProcessor::preprocessFrame(const cv::Mat& input_frame) {
     cv::Mat processed;
+    // The quality estimate reads the gray rows of the pass that already streams them
+    FrameQualityMap* quality = quality_gating_enabled_ ? &quality_map_ : nullptr;
+
+    // Fused path: grayscale, fixed-point blur and contrast in one pass
+    if (fast_blur_enabled_ && blur_kernel_size_ > 1 &&
+        FastBlur::supports(input_frame, blur_kernel_size_) &&
+        fast_blur_.setKernelSize(blur_kernel_size_) &&
+        fast_blur_.apply(input_frame, processed, contrast_alpha_, brightness_beta_, quality)) {
+        return processed;
+    }
 
-    // Convert to grayscale
+    // Convert to grayscale; a grayscale (Y plane) frame is read directly by the next step
+    cv::Mat gray;
+    const cv::Mat* source = &input_frame;
     if (input_frame.channels() == 3) {
-        cv::cvtColor(input_frame, processed, cv::COLOR_BGR2GRAY);
-    } else {
-        processed = input_frame.clone();
+        cv::cvtColor(input_frame, gray, cv::COLOR_BGR2GRAY);
+        source = &gray;
     }
 
-    // Apply Gaussian blur to reduce noise
-    if (blur_kernel_size_ > 0) {
-        cv::GaussianBlur(processed, processed, cv::Size(blur_kernel_size_, blur_kernel_size_), 0);
+    // Apply Gaussian blur to reduce noise (kernel size 1 is a no-op)
+    if (blur_kernel_size_ > 1) {
+        // Quality is measured before the blur, which leaves no pass of ours over the unblurred rows
+        if (quality) {
+            quality_map_.estimate(*source);
+            quality = nullptr;
+        }
+        cv::GaussianBlur(*source, gray, cv::Size(blur_kernel_size_, blur_kernel_size_), 0);
+        source = &gray;
     }
 
-    // Enhance contrast and brightness
+    // Enhance contrast and brightness, estimating quality from the same rows
+    if (source->type() == CV_8UC1 && (quality || contrast_alpha_ != 1.0 || brightness_beta_ != 0)) {
+        applyContrast(*source, processed, quality);
+        return processed;
+    }
+    if (quality) {
+        quality_map_.estimate(*source);
+    }
     if (contrast_alpha_ != 1.0 || brightness_beta_ != 0) {
-        processed.convertTo(processed, -1, contrast_alpha_, brightness_beta_);
+        source->convertTo(processed, -1, contrast_alpha_, brightness_beta_);
+        source = &processed;
+    }
+
+    // Nothing written: the result is kept, so it must not share the camera's buffer
+    if (source == &input_frame) {
+        processed = input_frame.clone();
+    } else if (source != &processed) {
+        processed = *source;
     }
 
     return processed;
 }
 
+void ImageProcessor::applyContrast(const cv::Mat& gray, cv::Mat& output, FrameQualityMap* quality) {
+    // Table built by convertTo itself, so the output matches source.convertTo(alpha, beta)
+    if (contrast_lut_.empty() || contrast_lut_alpha_ != contrast_alpha_ || contrast_lut_beta_ != brightness_beta_) {
+        cv::Mat ramp(1, 256, CV_8UC1);
+        for (int i = 0; i < 256; i++) {
+            ramp.at<uchar>(0, i) = static_cast<uchar>(i);
+        }
+        ramp.convertTo(contrast_lut_, -1, contrast_alpha_, brightness_beta_);
+        contrast_lut_alpha_ = contrast_alpha_;
+        contrast_lut_beta_ = brightness_beta_;
+    }
+    const uchar* lut = contrast_lut_.ptr<uchar>(0);
+
+    output.create(gray.size(), CV_8UC1);
+    if (quality) {
+        quality->begin(gray.size());
+    }
+    for (int y = 0; y < gray.rows; y++) {
+        const uchar* src = gray.ptr<uchar>(y);
+        uchar* dst = output.ptr<uchar>(y);
+        for (int x = 0; x < gray.cols; x++) {
+            dst[x] = lut[src[x]];
+        }
+        if (quality && y >= 2) {
+            quality->addRow(y - 1, gray.ptr<uchar>(y - 2), gray.ptr<uchar>(y - 1), src);
+        }
+    }
+    if (quality) {
+        quality->end();
+    }
+}
+
 cv::Mat ImageProcessor::detectEdges(const cv::Mat& grayscale_frame) {
     cv::Mat edges;
 
@@ -183,23 +321,28 @@ bool ImageProcessor::filterContour(const std::vector<cv::Point>& contour) const
         return false;
     }
 
+    // Size must fit the expected marker size at this location
+    cv::Rect bounding_rect = cv::boundingRect(contour);
+    if (size_prior_) {
+        cv::Point2f center(bounding_rect.x + bounding_rect.width * 0.5f, bounding_rect.y + bounding_rect.height * 0.5f);
+        if (!size_prior_->accepts(center, std::sqrt(area))) {
+            return false;
+        }
+    }
+
     // Calculate contour perimeter
     double perimeter = cv::arcLength(contour, true);
     if (perimeter < min_contour_perimeter_) {
         return false;
     }
 
-    // Check if contour is roughly rectangular (for Codice markers)
-    std::vector<cv::Point> approx;
-    cv::approxPolyDP(contour, approx, 0.02 * perimeter, true);
-
     // Codice markers are ALWAYS perfect squares with EXACTLY 4 corners
-    if (approx.size() != 4) {
+    cv::Point approx[4];
+    if (!QuadApprox::approximate(contour, 0.02 * perimeter, approx)) {
         return false; // Reject all multi-corner shapes - markers are always square
     }
 
     // Check aspect ratio (must be very close to square)
-    cv::Rect bounding_rect = cv::boundingRect(contour);
     double aspect_ratio = static_cast<double>(bounding_rect.width) / bounding_rect.height;
     if (aspect_ratio < 0.8 || aspect_ratio > 1.25) {
         return false; // Much stricter square requirement
@@ -263,4 +406,42 @@ const cv::Mat& ImageProcessor::getPreprocessedFrame() const {
     return preprocessed_frame_;
 }
 
+uint64_t ImageProcessor::getTruncatedFrameCount() const {
+    return truncated_frames_;
+}
+
+uint64_t ImageProcessor::getTruncatedContourCount() const {
+    return truncated_contours_;
+}
+
+uint64_t ImageProcessor::getAbandonedContourCount() const {
+    return contour_tracer_.getAbandonedCount();
+}
+
+void ImageProcessor::setQualityGating(bool enable, const FrameQualityConfig& config) {
+    quality_gating_enabled_ = enable;
+    quality_map_.setConfig(config);
+}
+
+bool ImageProcessor::isQualityGatingEnabled() const {
+    return quality_gating_enabled_;
+}
+
+bool ImageProcessor::estimateQuality(const cv::Mat& input_frame) {
+    if (!quality_gating_enabled_) {
+        return false;
+    }
+    StageProfiler::Scope stage(profiler_, "estimateQuality");
+    return quality_map_.estimate(input_frame);
+}
+
+const FrameQualityMap& ImageProcessor::getQualityMap() const {
+    return quality_map_;
+}
+
+size_t ImageProcessor::getMemoryBytes() const {
+    return preprocessed_frame_.total() * preprocessed_frame_.elemSize() +
+           contour_tracer_.getMemoryBytes() + fast_blur_.getMemoryBytes() + quality_map_.getMemoryBytes();
+}
+
 } // namespace CodiceCam
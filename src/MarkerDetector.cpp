@@ -1,4 +1,6 @@
 #include "MarkerDetector.h"
+#include "WorkerPool.h"
+#include "QuadApprox.h"
 #include <iostream>
 #include <algorithm>
 #include <cmath>
@@ -30,48 +32,114 @@ MarkerDetector::MarkerDetector()
     , min_marker_size_(40)
     , max_marker_size_(200)
     , min_confidence_(0.7)
+    , size_prior_(nullptr)
+    , deterministic_mode_(false)
     , debug_mode_(false)
     , debug_window_enabled_(false)
     , verbose_mode_(false)
+    , low_memory_mode_(false)
+    , benchmark_mode_(false)
     , total_frames_processed_(0)
     , total_markers_detected_(0)
     , total_detection_attempts_(0)
+    , total_processing_errors_(0)
+    , total_capture_latency_ms_(0.0)
+    , capture_latency_samples_(0)
+    , max_coast_ms_(250)
+    , total_candidates_skipped_(0)
+    , total_markers_coasted_(0)
     , location_change_threshold_(30.0)  // 30 pixels minimum change to save new debug set
 {
+    // Run OpenCV's parallel loops on the shared worker pool
+    WorkerPool::installOpenCVBackend();
+
     // Configure image processor for marker detection
     image_processor_->setPreprocessingParams(1, 1.3, 20);  // NO blur (kernel=1), enhanced contrast
     image_processor_->setEdgeDetectionParams(30, 100);     // Lower thresholds for better detection
     image_processor_->setContourFilterParams(500, 100000, 80);  // Larger area range for markers
+    image_processor_->setMaxMarkerSize(max_marker_size_);      // Bounds the contours traced to completion
 }
 
 MarkerDetector::~MarkerDetector() {
 }
 
+FrameInput FrameInput::fromCamera(const cv::Mat& frame, std::chrono::steady_clock::time_point capture_time) {
+    FrameInput input;
+    input.frame = frame;
+    input.format = frame.channels() == 1 ? FrameFormat::GRAY : FrameFormat::BGR;
+    input.capture_time = capture_time;
+    return input;
+}
+
+FrameInput FrameInput::fromPreprocessed(const cv::Mat& frame, const cv::Mat& preprocessed, const cv::Mat& edges,
+                                        std::chrono::steady_clock::time_point capture_time) {
+    FrameInput input = fromCamera(frame, capture_time);
+    input.preprocessed = preprocessed;
+    input.edges = edges;
+    return input;
+}
+
 bool MarkerDetector::detectMarkers(const cv::Mat& frame, std::vector<CodiceMarker>& markers) {
-    VERBOSE_OUT("🔍 [DEBUG] detectMarkers called with frame size: " << frame.cols << "x" << frame.rows << std::endl);
+    return detectMarkers(FrameInput::fromCamera(frame), markers);
+}
 
-    if (frame.empty()) {
+bool MarkerDetector::validateInput(const FrameInput& input) const {
+    if (input.frame.empty()) {
         std::cerr << "❌ Input frame is empty" << std::endl;
         return false;
     }
+    int expected_channels = input.format == FrameFormat::GRAY ? 1 : 3;
+    if (input.frame.channels() != expected_channels) {
+        std::cerr << "❌ Input frame has " << input.frame.channels() << " channels, format expects "
+                  << expected_channels << std::endl;
+        return false;
+    }
+    if (input.edges.empty() != input.preprocessed.empty()) {
+        std::cerr << "❌ Preprocessed frame and edges must be supplied together" << std::endl;
+        return false;
+    }
+    if (input.isPreprocessed() &&
+        (input.edges.size() != input.frame.size() || input.preprocessed.size() != input.frame.size() ||
+         input.edges.type() != CV_8UC1)) {
+        std::cerr << "❌ Edges must be 8-bit single-channel and match the frame size" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool MarkerDetector::detectMarkers(const FrameInput& input, std::vector<CodiceMarker>& markers) {
+    const cv::Mat& frame = input.frame;
+    VERBOSE_OUT("🔍 [DEBUG] detectMarkers called with frame size: " << frame.cols << "x" << frame.rows
+                << (input.isPreprocessed() ? " (preprocessed)" : "") << std::endl);
 
-    total_frames_processed_++;
     markers.clear();
+    if (!validateInput(input)) {
+        total_processing_errors_++;
+        return false;
+    }
+
+    total_frames_processed_++;
     VERBOSE_OUT("🔍 [DEBUG] Starting marker detection process..." << std::endl);
 
     try {
-        // Step 1: Process frame for contour detection
-        VERBOSE_OUT("🔍 [DEBUG] Step 1: Processing frame..." << std::endl);
-        cv::Mat processed_frame;
-        if (!image_processor_->processFrame(frame, processed_frame)) {
-            std::cerr << "❌ Failed to process frame" << std::endl;
-            return false;
+        // Step 1: Process frame for contour detection, unless the caller already did
+        cv::Mat processed_frame = input.edges;
+        cv::Mat preprocessed_frame = input.preprocessed;
+        low_quality_candidates_.clear();
+        if (input.isPreprocessed()) {
+            image_processor_->estimateQuality(frame);
+        } else {
+            VERBOSE_OUT("🔍 [DEBUG] Step 1: Processing frame..." << std::endl);
+            if (!image_processor_->processFrame(frame, processed_frame)) {
+                std::cerr << "❌ Failed to process frame" << std::endl;
+                total_processing_errors_++;
+                return false;
+            }
+            // Written by the processFrame call above, never left over from an earlier frame
+            preprocessed_frame = image_processor_->getPreprocessedFrame();
         }
-        VERBOSE_OUT("🔍 [DEBUG] Frame processed successfully, size: " << processed_frame.cols << "x" << processed_frame.rows << std::endl);
-
-        // Get the preprocessed frame (for pattern reading)
-        const cv::Mat& preprocessed_frame = image_processor_->getPreprocessedFrame();
-        VERBOSE_OUT("🔍 [DEBUG] Preprocessed frame available, size: " << preprocessed_frame.cols << "x" << preprocessed_frame.rows << std::endl);
+        VERBOSE_OUT("🔍 [DEBUG] Edges " << processed_frame.cols << "x" << processed_frame.rows
+                    << ", preprocessed " << preprocessed_frame.cols << "x" << preprocessed_frame.rows << std::endl);
 
         // Step 2: Find potential marker contours
         VERBOSE_OUT("🔍 [DEBUG] Step 2: Finding contours..." << std::endl);
@@ -105,6 +173,9 @@ bool MarkerDetector::detectMarkers(const cv::Mat& frame, std::vector<CodiceMarke
                         std::cout << "✅ Marker detected with confidence: " << marker.confidence << std::endl;
                     }
                     if (marker.confidence >= min_confidence_) {
+                        if (size_prior_ && !deterministic_mode_) {
+                            size_prior_->observe(marker.center, std::sqrt(cv::contourArea(contours[i])));
+                        }
                         markers.push_back(marker);
                         total_markers_detected_++;
                         marker_index++; // Increment for next marker in this frame
@@ -123,6 +194,10 @@ bool MarkerDetector::detectMarkers(const cv::Mat& frame, std::vector<CodiceMarke
         }
         VERBOSE_OUT("🔍 [DEBUG] Contour processing completed" << std::endl);
 
+        // Keep markers whose region was too blurred or clipped to decode
+        bool has_capture_time = input.capture_time.time_since_epoch().count() != 0;
+        coastTrackedMarkers(markers, has_capture_time ? input.capture_time : std::chrono::steady_clock::now());
+
         // Step 4: Show live debug window if enabled
         if (debug_window_enabled_) {
             drawLiveDebugWindow(frame, contours, markers);
@@ -171,132 +246,21 @@ bool MarkerDetector::detectMarkers(const cv::Mat& frame, std::vector<CodiceMarke
             previous_marker_locations_.push_back(marker.center);
         }
 
-        return true;
-
-    } catch (const cv::Exception& e) {
-        std::cerr << "❌ OpenCV error in detectMarkers: " << e.what() << std::endl;
-        return false;
-    }
-}
-
-bool MarkerDetector::detectMarkers(const cv::Mat& original_frame, const cv::Mat& processed_frame, std::vector<CodiceMarker>& markers) {
-    try {
-        total_frames_processed_++;
-        markers.clear();
-
-        VERBOSE_OUT("🔍 [DEBUG] detectMarkers called with original frame: " << original_frame.cols << "x" << original_frame.rows
-                    << " and processed frame: " << processed_frame.cols << "x" << processed_frame.rows << std::endl);
-
-        if (original_frame.empty() || processed_frame.empty()) {
-            DEBUG_OUT("🔍 [DEBUG] Empty frame(s) received" << std::endl);
-            return false;
-        }
-
-        // Get the preprocessed frame (for pattern reading)
-        const cv::Mat& preprocessed_frame = image_processor_->getPreprocessedFrame();
-        VERBOSE_OUT("🔍 [DEBUG] Preprocessed frame available, size: " << preprocessed_frame.cols << "x" << preprocessed_frame.rows << std::endl);
-
-        // Step 2: Find potential marker contours (use the processed frame passed in)
-        VERBOSE_OUT("🔍 [DEBUG] Step 2: Finding contours..." << std::endl);
-        std::vector<std::vector<cv::Point>> contours;
-        if (!image_processor_->findMarkerContours(processed_frame, contours)) {
-            VERBOSE_OUT("🔍 [DEBUG] No contours found - this is normal" << std::endl);
-            contours.clear(); // Ensure empty contours vector
-        } else {
-            VERBOSE_OUT("🔍 [DEBUG] Found " << contours.size() << " contours, starting processing..." << std::endl);
-        }
-
-        // Step 3: Process each contour to detect markers (if any)
-        VERBOSE_OUT("🔍 [DEBUG] Step 3: Processing " << contours.size() << " contours..." << std::endl);
-        std::string timestamp = generateTimestamp(); // Generate once for this frame
-        int marker_index = 0; // Track marker index for multiple markers
-
-        for (size_t i = 0; i < contours.size(); i++) {
-            VERBOSE_OUT("🔍 [DEBUG] Processing contour " << (i+1) << "/" << contours.size() << " with " << contours[i].size() << " points" << std::endl);
-            try {
-                total_detection_attempts_++;
-
-                if (debug_mode_) {
-                    std::cout << "🔍 Processing contour " << (i+1) << "/" << contours.size() << std::endl;
-                }
-
-                DEBUG_OUT("🔍 [DEBUG] Calling processContour..." << std::endl);
-                CodiceMarker marker;
-                if (processContour(contours[i], original_frame, marker, timestamp, static_cast<int>(i))) {
-                    DEBUG_OUT("🔍 [DEBUG] processContour returned true, confidence: " << marker.confidence << std::endl);
-                    if (debug_mode_) {
-                        std::cout << "✅ Marker detected with confidence: " << marker.confidence << std::endl;
-                    }
-                    if (marker.confidence >= min_confidence_) {
-                        markers.push_back(marker);
-                        total_markers_detected_++;
-                        marker_index++; // Increment for next marker in this frame
-                        DEBUG_OUT("🔍 [DEBUG] Marker added to results" << std::endl);
-                    }
-                } else {
-                    DEBUG_OUT("🔍 [DEBUG] processContour returned false" << std::endl);
-                    if (debug_mode_) {
-                        std::cout << "❌ Contour " << (i+1) << " did not match marker pattern" << std::endl;
-                    }
-                }
-            } catch (const std::exception& e) {
-                std::cerr << "❌ Error processing contour " << (i+1) << ": " << e.what() << std::endl;
-                continue;
-            }
-        }
-        VERBOSE_OUT("🔍 [DEBUG] Contour processing completed" << std::endl);
-
-        // Step 4: Show live debug window if enabled
-        if (debug_window_enabled_) {
-            drawLiveDebugWindow(original_frame, contours, markers);
-        }
-
-        // Step 5: Save debug information to files when debug mode is enabled and location changed
-        // Use the ORIGINAL frame for debug visualization, not the processed frame
-        if (debug_mode_ && hasLocationChanged(markers)) {
-            // Use the same timestamp generated for the frame processing
-            std::cout << "🔍 [DEBUG] Step 5: Saving debug set " << timestamp << " (" << markers.size() << " markers, " << contours.size() << " contours)" << std::endl;
-            std::cout << "🔍 [DEBUG] Location changed, proceeding with file saves..." << std::endl;
-
-            try {
-                cv::Mat debug_frame = original_frame.clone();  // Use ORIGINAL frame
-                std::cout << "🔍 [DEBUG] Debug frame cloned from ORIGINAL, size: " << debug_frame.cols << "x" << debug_frame.rows << std::endl;
-
-                // Draw all contours and detection attempts for debugging
-                drawAllContoursDebug(debug_frame, contours);
-                drawDebugInfo(debug_frame, markers);
-                std::cout << "🔍 [DEBUG] Debug info drawn" << std::endl;
-
-                                // Save only the 4 requested debug images
-                std::string debug_prefix = "debug_output/" + timestamp;
-
-                cv::imwrite(debug_prefix + "_debug_frame.jpg", debug_frame);  // 1. Debug Frame
-                cv::imwrite(debug_prefix + "_processed_frame.jpg", processed_frame);  // 2. Processed for edge detection
-
-                std::cout << "🔍 [DEBUG] Debug set saved with timestamp " << timestamp << std::endl;
-                std::cout << "  - " << debug_prefix << "_debug_frame.jpg (debug frame)" << std::endl;
-                std::cout << "  - " << debug_prefix << "_processed_frame.jpg (edge detection)" << std::endl;
-
-            } catch (const std::exception& e) {
-                std::cerr << "❌ Error in debug visualization: " << e.what() << std::endl;
-            }
-        }
-        VERBOSE_OUT("🔍 [DEBUG] detectMarkers completed successfully" << std::endl);
-
-        if (!markers.empty()) {
-            VERBOSE_OUT("🎯 Detected " << markers.size() << " Codice markers" << std::endl);
+        if (benchmark_mode_) {
+            profiler_->endFrame();
         }
 
-        // Update previous marker locations for next frame comparison
-        previous_marker_locations_.clear();
-        for (const auto& marker : markers) {
-            previous_marker_locations_.push_back(marker.center);
+        if (input.capture_time.time_since_epoch().count() != 0) {
+            total_capture_latency_ms_ += std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - input.capture_time).count();
+            capture_latency_samples_++;
         }
 
         return true;
 
     } catch (const cv::Exception& e) {
         std::cerr << "❌ OpenCV error in detectMarkers: " << e.what() << std::endl;
+        total_processing_errors_++;
         return false;
     }
 }
@@ -306,10 +270,14 @@ bool MarkerDetector::processContour(const std::vector<cv::Point>& contour, const
     try {
         // Approximate contour to get corner points
         DEBUG_OUT("🔍 [DEBUG] Approximating contour..." << std::endl);
-        std::vector<cv::Point> approx;
-        double epsilon = 0.05 * cv::arcLength(contour, true); // More aggressive approximation for squares
-        cv::approxPolyDP(contour, approx, epsilon, true);
-        DEBUG_OUT("🔍 [DEBUG] Contour approximated to " << approx.size() << " points" << std::endl);
+        cv::Point approx[4];
+        bool is_quad;
+        {
+            StageProfiler::Scope stage(benchmark_mode_ ? profiler_.get() : nullptr, "approxQuad");
+            double epsilon = 0.05 * cv::arcLength(contour, true); // More aggressive approximation for squares
+            is_quad = QuadApprox::approximate(contour, epsilon, approx);
+        }
+        DEBUG_OUT("🔍 [DEBUG] Contour " << (is_quad ? "is" : "is not") << " a 4-corner shape" << std::endl);
 
     // Save debug image for any contour attempt (for debugging false positives)
     if (!timestamp.empty() && debug_mode_) {
@@ -324,14 +292,14 @@ bool MarkerDetector::processContour(const std::vector<cv::Point>& contour, const
 
             cv::Mat contour_region = original_frame(bounds).clone();
             cv::imwrite(debug_filename, contour_region);
-            DEBUG_OUT("🔍 [DEBUG] Saved contour attempt to " << debug_filename << " (approx: " << approx.size() << " corners)" << std::endl);
+            DEBUG_OUT("🔍 [DEBUG] Saved contour attempt to " << debug_filename << " (4 corners: " << (is_quad ? "yes" : "no") << ")" << std::endl);
         }
     }
 
     // STRICT: Only process contours with EXACTLY 4 corners (perfect squares)
     // Codice markers are always squares - reject anything else immediately
-    if (approx.size() != 4) {
-        DEBUG_OUT("🔍 [DEBUG] Rejecting " << approx.size() << "-corner contour - markers must be exactly 4 corners" << std::endl);
+    if (!is_quad) {
+        DEBUG_OUT("🔍 [DEBUG] Rejecting non-quadrilateral contour - markers must be exactly 4 corners" << std::endl);
         return false; // Strict filtering for squares only
     }
 
@@ -374,12 +342,26 @@ bool MarkerDetector::processContour(const std::vector<cv::Point>& contour, const
         return false;
     }
 
+    // Skip warp and decode in motion-blurred or clipped regions
+    if (image_processor_->isQualityGatingEnabled() &&
+        !image_processor_->getQualityMap().isDecodable(cv::boundingRect(contour))) {
+        DEBUG_OUT("🔍 [DEBUG] Region too blurred or clipped to decode, skipping" << std::endl);
+        low_quality_candidates_.push_back(ordered_corners);
+        total_candidates_skipped_++;
+        return false;
+    }
+
     // Extract and deskew marker region for pattern decoding
     DEBUG_OUT("🔍 [DEBUG] Extracting and deskewing marker region..." << std::endl);
     cv::Mat marker_region;
     // Use original frame for marker extraction (it contains the actual image data)
     float deskew_angle;
-    if (!extractAndDeskewMarker(original_frame, ordered_corners, marker_region, deskew_angle, timestamp, marker_index)) {
+    bool extracted;
+    {
+        StageProfiler::Scope stage(benchmark_mode_ ? profiler_.get() : nullptr, "extractMarker");
+        extracted = extractAndDeskewMarker(original_frame, ordered_corners, marker_region, deskew_angle, timestamp, marker_index);
+    }
+    if (!extracted) {
         DEBUG_OUT("🔍 [DEBUG] Failed to extract and deskew marker region" << std::endl);
         return false;
     }
@@ -389,7 +371,12 @@ bool MarkerDetector::processContour(const std::vector<cv::Point>& contour, const
     DEBUG_OUT("🔍 [DEBUG] Decoding marker pattern..." << std::endl);
     int marker_id;
     double confidence;
-    if (!decodeMarker(marker_region, marker_id, confidence, timestamp, marker_index)) {
+    bool decoded;
+    {
+        StageProfiler::Scope stage(benchmark_mode_ ? profiler_.get() : nullptr, "decodeMarker");
+        decoded = decodeMarker(marker_region, marker_id, confidence, timestamp, marker_index);
+    }
+    if (!decoded) {
         DEBUG_OUT("🔍 [DEBUG] Failed to decode marker pattern" << std::endl);
         return false;
     }
@@ -426,7 +413,7 @@ std::vector<cv::Point2f> MarkerDetector::sortCornersForMarker(const std::vector<
     }
 
     // SIMPLE APPROACH: Use the same corner order as the debug visualization
-    // The approxPolyDP already gives us a reasonable corner order
+    // QuadApprox already gives us a reasonable corner order (contour order)
     // Don't mess with it - this matches what we see in the yellow debug boxes!
 
     std::vector<cv::Point2f> sorted_corners = corners;
@@ -912,9 +899,15 @@ void MarkerDetector::drawAllContoursDebug(cv::Mat& frame, const std::vector<std:
         const auto& contour = contours[i];
 
         // Approximate contour to check if it could be a 4-corner shape
+        // (same corner test as processContour; approxPolyDP only labels the other shapes)
         std::vector<cv::Point> approx;
         double epsilon = 0.05 * cv::arcLength(contour, true);
-        cv::approxPolyDP(contour, approx, epsilon, true);
+        cv::Point quad[4];
+        if (QuadApprox::approximate(contour, epsilon, quad)) {
+            approx.assign(quad, quad + 4);
+        } else {
+            cv::approxPolyDP(contour, approx, epsilon, true);
+        }
 
         cv::Scalar color;
         std::string label;
@@ -1018,12 +1011,126 @@ void MarkerDetector::setDetectionParams(int min_marker_size, int max_marker_size
     min_marker_size_ = min_marker_size;
     max_marker_size_ = max_marker_size;
     min_confidence_ = min_confidence;
+    image_processor_->setMaxMarkerSize(max_marker_size_);
 
     std::cout << "⚙️ Detection params updated: size=[" << min_marker_size_
               << "," << max_marker_size_ << "], confidence=" << min_confidence_ << std::endl;
 }
 
+void MarkerDetector::setSizePrior(std::shared_ptr<SizePriorMap> size_prior) {
+    size_prior_ = std::move(size_prior);
+    image_processor_->setSizePrior(size_prior_);
+    std::cout << "⚙️ Size prior " << (size_prior_ ? "enabled" : "disabled") << std::endl;
+}
+
+std::shared_ptr<SizePriorMap> MarkerDetector::getSizePrior() const {
+    return size_prior_;
+}
+
+void MarkerDetector::setDeterministicMode(bool enable) {
+    deterministic_mode_ = enable;
+    std::cout << "⚙️ Deterministic mode " << (enable ? "enabled" : "disabled") << std::endl;
+}
+
+void MarkerDetector::setQualityGating(bool enable, const FrameQualityConfig& config, int max_coast_ms) {
+    image_processor_->setQualityGating(enable, config);
+    max_coast_ms_ = std::max(0, max_coast_ms);
+    tracked_markers_.clear();
+    std::cout << "⚙️ Quality gating " << (enable ? "enabled" : "disabled");
+    if (enable) {
+        std::cout << " (min sharpness " << config.min_sharpness << ", max clipped " << config.max_clipped_ratio
+                  << ", coast " << max_coast_ms_ << " ms)";
+    }
+    std::cout << std::endl;
+}
+
+void MarkerDetector::coastTrackedMarkers(std::vector<CodiceMarker>& markers,
+                                         std::chrono::steady_clock::time_point frame_time) {
+    if (deterministic_mode_ || max_coast_ms_ == 0 || !image_processor_->isQualityGatingEnabled()) {
+        tracked_markers_.clear();
+        return;
+    }
+
+    std::vector<TrackedMarker> tracked;
+    for (const auto& marker : markers) {
+        tracked.push_back({marker, frame_time});
+    }
+
+    const FrameQualityMap& quality = image_processor_->getQualityMap();
+    std::vector<bool> used(low_quality_candidates_.size(), false);
+    for (const auto& previous : tracked_markers_) {
+        const CodiceMarker& last = previous.marker;
+        if (frame_time - previous.last_decoded > std::chrono::milliseconds(max_coast_ms_) || last.corners.size() != 4) {
+            continue;
+        }
+        bool decoded = std::any_of(markers.begin(), markers.end(),
+                                   [&](const CodiceMarker& marker) { return marker.id == last.id; });
+        if (decoded) {
+            continue;
+        }
+
+        // Nearest skipped candidate within one marker side of the last position
+        double nearest_distance = cv::norm(last.corners[1] - last.corners[0]);
+        int nearest = -1;
+        cv::Point2f nearest_center;
+        for (size_t i = 0; i < low_quality_candidates_.size(); i++) {
+            if (used[i]) {
+                continue;
+            }
+            cv::Point2f center(0, 0);
+            for (const auto& corner : low_quality_candidates_[i]) {
+                center += corner;
+            }
+            center *= 0.25f;
+            double distance = cv::norm(center - last.center);
+            if (distance < nearest_distance) {
+                nearest_distance = distance;
+                nearest = static_cast<int>(i);
+                nearest_center = center;
+            }
+        }
+
+        CodiceMarker coasted = last;
+        if (nearest >= 0) {
+            used[nearest] = true;
+            cv::Point2f offset = nearest_center - last.center;
+            coasted.center += offset;
+            for (auto& corner : coasted.corners) {
+                corner += offset;
+            }
+        } else if (quality.isDecodable(cv::boundingRect(last.corners))) {
+            // Clear view and nothing there: the marker is gone
+            continue;
+        }
+
+        markers.push_back(coasted);
+        tracked.push_back({coasted, previous.last_decoded});
+        total_markers_coasted_++;
+    }
+    tracked_markers_ = std::move(tracked);
+}
+
+void MarkerDetector::setLowMemoryMode(bool enable) {
+    if (enable) {
+        if (debug_mode_) {
+            setDebugMode(false);
+        }
+        if (debug_window_enabled_) {
+            setDebugWindow(false);
+        }
+    }
+    low_memory_mode_ = enable;
+}
+
+size_t MarkerDetector::getMemoryBytes() const {
+    return image_processor_->getMemoryBytes();
+}
+
 void MarkerDetector::setDebugMode(bool enable) {
+    if (enable && low_memory_mode_) {
+        std::cout << "⚠️ Debug mode is not available in low-memory mode" << std::endl;
+        return;
+    }
     debug_mode_ = enable;
     if (enable) {
         // Only create window if we're not in a headless environment
@@ -1043,6 +1150,10 @@ void MarkerDetector::setDebugMode(bool enable) {
 }
 
 void MarkerDetector::setDebugWindow(bool enable) {
+    if (enable && low_memory_mode_) {
+        std::cout << "⚠️ Debug window is not available in low-memory mode" << std::endl;
+        return;
+    }
     debug_window_enabled_ = enable;
     if (enable) {
         // Create the live debug window
@@ -1073,6 +1184,20 @@ std::string MarkerDetector::getDetectionStats() const {
     stats += "  Frames processed: " + std::to_string(total_frames_processed_) + "\n";
     stats += "  Detection attempts: " + std::to_string(total_detection_attempts_) + "\n";
     stats += "  Markers detected: " + std::to_string(total_markers_detected_) + "\n";
+    stats += "  Processing errors: " + std::to_string(total_processing_errors_) + "\n";
+    stats += "  Contour truncations: " + std::to_string(image_processor_->getTruncatedFrameCount()) + " frames, " +
+             std::to_string(image_processor_->getTruncatedContourCount()) + " contours dropped\n";
+    if (size_prior_) {
+        stats += size_prior_->getStatistics();
+    }
+    if (image_processor_->isQualityGatingEnabled()) {
+        stats += "  Quality gate: " + std::to_string(total_candidates_skipped_) + " candidates not decoded, " +
+                 std::to_string(total_markers_coasted_) + " markers coasted\n";
+    }
+    if (capture_latency_samples_ > 0) {
+        stats += "  Capture-to-detection latency: " +
+                 std::to_string(total_capture_latency_ms_ / capture_latency_samples_).substr(0, 5) + " ms avg\n";
+    }
     if (total_frames_processed_ > 0) {
         double detection_rate = (double)total_markers_detected_ / total_frames_processed_;
         stats += "  Detection rate: " + std::to_string(detection_rate).substr(0, 4) + " markers/frame";
@@ -1080,6 +1205,21 @@ std::string MarkerDetector::getDetectionStats() const {
     return stats;
 }
 
+void MarkerDetector::setBenchmarkMode(bool enable, bool use_hardware_counters) {
+    if (enable) {
+        // Counters are opened by the first thread that runs a stage
+        profiler_ = std::make_unique<StageProfiler>(use_hardware_counters);
+    }
+    benchmark_mode_ = enable;
+    image_processor_->setProfiler(enable ? profiler_.get() : nullptr);
+    std::cout << "⏱️ Benchmark mode " << (enable ? "enabled" : "disabled")
+              << (enable && use_hardware_counters ? " (hardware counters)" : "") << std::endl;
+}
+
+std::string MarkerDetector::getBenchmarkReport() const {
+    return profiler_ ? profiler_->getReport() : std::string();
+}
+
 bool MarkerDetector::testDecodeMarker(const cv::Mat& marker_region, int& marker_id, double& confidence) {
     std::cout << "🧪 [TEST] testDecodeMarker called with region size: " << marker_region.cols << "x" << marker_region.rows << std::endl;
     return decodeMarker(marker_region, marker_id, confidence);
@@ -1103,9 +1243,15 @@ void MarkerDetector::drawLiveDebugWindow(const cv::Mat& frame, const std::vector
             const auto& contour = contours[i];
 
             // Approximate contour to check if it could be a 4-corner shape
+            // (same corner test as processContour; approxPolyDP only labels the other shapes)
             std::vector<cv::Point> approx;
             double epsilon = 0.05 * cv::arcLength(contour, true);
-            cv::approxPolyDP(contour, approx, epsilon, true);
+            cv::Point quad[4];
+            if (QuadApprox::approximate(contour, epsilon, quad)) {
+                approx.assign(quad, quad + 4);
+            } else {
+                cv::approxPolyDP(contour, approx, epsilon, true);
+            }
 
             cv::Scalar color;
             std::string label;
@@ -0,0 +1,385 @@
+#include "MarkerEventLog.h"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <sstream>
+#include <sys/stat.h>
+
+namespace CodiceCam {
+
+namespace {
+    // Writer wake-up interval; the producer never signals the writer
+    const int WRITER_POLL_MS = 20;
+
+    // Longest formatted line for one marker inside a frame line
+    const size_t MAX_MARKER_JSON = 96;
+
+    // Largest coordinate, angle or confidence magnitude logged; keeps each field within MAX_MARKER_JSON
+    const float MAX_LOGGED_VALUE = 1e6f;
+
+    const char* kindName(MarkerEventKind kind) {
+        switch (kind) {
+            case MarkerEventKind::DETECTED: return "DETECTED";
+            case MarkerEventKind::UPDATED: return "UPDATED";
+            case MarkerEventKind::LOST: return "LOST";
+            default: return "UNKNOWN";
+        }
+    }
+
+    int64_t unixTimeMs() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    // snprintf at offset into buffer, clamped to the space left; returns the new length
+    template <typename... Args>
+    size_t appendFormat(std::vector<char>& buffer, size_t offset, const char* format, Args... args) {
+        size_t remaining = buffer.size() - offset;
+        int length = std::snprintf(buffer.data() + offset, remaining, format, args...);
+        if (length < 0) {
+            return offset;
+        }
+        return offset + std::min(static_cast<size_t>(length), remaining - 1);
+    }
+
+    bool isLoggable(float value) {
+        return std::isfinite(value) && std::fabs(value) <= MAX_LOGGED_VALUE;
+    }
+
+    // Counts a producer call in flight. With running_ (both sequentially consistent), either the
+    // producer sees the log closed, or close() sees the producer and waits for it
+    class ProducerGuard {
+    public:
+        explicit ProducerGuard(std::atomic<int>& producers) : producers_(producers) { producers_.fetch_add(1); }
+        ~ProducerGuard() { producers_.fetch_sub(1, std::memory_order_release); }
+
+        ProducerGuard(const ProducerGuard&) = delete;
+        ProducerGuard& operator=(const ProducerGuard&) = delete;
+
+    private:
+        std::atomic<int>& producers_;
+    };
+
+    size_t roundUpPowerOfTwo(size_t value) {
+        size_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+}
+
+MarkerEventLog::MarkerEventLog(const MarkerEventLogConfig& config)
+    : config_(config)
+    , ring_mask_(0)
+    , head_(0)
+    , tail_(0)
+    , running_(false)
+    , producers_(0)
+    , file_(nullptr)
+    , rotatable_(false)
+    , file_bytes_(0)
+    , next_frame_(0)
+    , frames_logged_(0)
+    , events_logged_(0)
+    , frames_dropped_(0)
+    , events_dropped_(0)
+    , bytes_written_(0)
+    , files_rotated_(0)
+{
+    size_t capacity = roundUpPowerOfTwo(std::max<size_t>(config_.queue_records, 64));
+    ring_.resize(capacity);
+    ring_mask_ = capacity - 1;
+}
+
+MarkerEventLog::~MarkerEventLog() {
+    close();
+}
+
+bool MarkerEventLog::open() {
+    if (running_) {
+        return true;
+    }
+    if (!openOutput()) {
+        return false;
+    }
+
+    running_ = true;
+    writer_thread_ = std::thread(&MarkerEventLog::writerLoop, this);
+    std::cout << "📝 Marker event log writing to " << config_.path
+              << (rotatable_ ? "" : " (no rotation)") << std::endl;
+    return true;
+}
+
+void MarkerEventLog::close() {
+    if (!running_) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        running_ = false;
+    }
+
+    // A producer past its running_ check may still be filling the ring
+    while (producers_.load(std::memory_order_acquire) > 0) {
+        std::this_thread::yield();
+    }
+
+    wake_cv_.notify_all();
+    if (writer_thread_.joinable()) {
+        writer_thread_.join();
+    }
+
+    // Anything queued after the writer's last pass
+    drain();
+    closeOutput();
+}
+
+bool MarkerEventLog::isOpen() const {
+    return running_;
+}
+
+const MarkerEventLogConfig& MarkerEventLog::getConfig() const {
+    return config_;
+}
+
+bool MarkerEventLog::logFrame(const StreamMarker* markers, size_t count) {
+    ProducerGuard guard(producers_);
+    if (!running_ || !config_.log_frames) {
+        return false;
+    }
+
+    // Non-finite or huge values would make the line invalid JSON or overflow its buffer
+    for (size_t i = 0; i < count; i++) {
+        if (!isLoggable(markers[i].x) || !isLoggable(markers[i].y) || !isLoggable(markers[i].angle) ||
+            !isLoggable(markers[i].confidence)) {
+            frames_dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+
+    uint64_t frame = next_frame_++;
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    size_t head = head_.load(std::memory_order_acquire);
+    size_t needed = count + 1;
+    if (ring_.size() - (tail - head) < needed) {
+        frames_dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    Record& header = ring_[tail & ring_mask_];
+    header.type = FRAME_HEADER;
+    header.time_ms = unixTimeMs();
+    header.frame = frame;
+    header.count = static_cast<uint32_t>(count);
+
+    for (size_t i = 0; i < count; i++) {
+        Record& record = ring_[(tail + 1 + i) & ring_mask_];
+        record.type = FRAME_MARKER;
+        record.id = markers[i].id;
+        record.x = markers[i].x;
+        record.y = markers[i].y;
+        record.angle = markers[i].angle;
+        record.confidence = markers[i].confidence;
+    }
+
+    // Publish the whole frame at once
+    tail_.store(tail + needed, std::memory_order_release);
+    frames_logged_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool MarkerEventLog::logEvent(MarkerEventKind kind, int marker_id, int session_id, float x, float y, float angle) {
+    ProducerGuard guard(producers_);
+    if (!running_ || !config_.log_lifecycle || (kind == MarkerEventKind::UPDATED && !config_.log_updates)) {
+        return false;
+    }
+    if (!isLoggable(x) || !isLoggable(y) || !isLoggable(angle)) {
+        events_dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    size_t head = head_.load(std::memory_order_acquire);
+    if (tail - head >= ring_.size()) {
+        events_dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    Record& record = ring_[tail & ring_mask_];
+    record.type = LIFECYCLE_EVENT;
+    record.kind = kind;
+    record.time_ms = unixTimeMs();
+    record.id = marker_id;
+    record.session = session_id;
+    record.x = x;
+    record.y = y;
+    record.angle = angle;
+
+    tail_.store(tail + 1, std::memory_order_release);
+    events_logged_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+std::string MarkerEventLog::getStatistics() const {
+    size_t queued = tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+
+    std::ostringstream oss;
+    oss << "Marker Event Log (" << config_.path << "):\n";
+    oss << "  Frames logged: " << frames_logged_.load() << " (dropped: " << frames_dropped_.load() << ")\n";
+    oss << "  Events logged: " << events_logged_.load() << " (dropped: " << events_dropped_.load() << ")\n";
+    oss << "  Queue: " << queued << "/" << ring_.size() << " records\n";
+    oss << "  Bytes written: " << bytes_written_.load() << "\n";
+    oss << "  Files rotated: " << files_rotated_.load() << "\n";
+    return oss.str();
+}
+
+bool MarkerEventLog::openOutput() {
+    rotatable_ = false;
+    if (config_.path == "-") {
+        file_ = stdout;
+    } else {
+        struct stat info;
+        bool is_fifo = (stat(config_.path.c_str(), &info) == 0 && S_ISFIFO(info.st_mode));
+        file_ = std::fopen(config_.path.c_str(), is_fifo ? "w" : "a");
+        if (!file_) {
+            std::cerr << "❌ Failed to open marker event log: " << config_.path
+                      << " (" << std::strerror(errno) << ")" << std::endl;
+            return false;
+        }
+        rotatable_ = !is_fifo;
+    }
+
+    // Block buffering: lines reach the OS once per buffer or flush interval
+    // (stdout keeps its own buffering, it may already have been written to)
+    if (config_.write_buffer_bytes > 0 && file_ != stdout) {
+        write_buffer_.resize(config_.write_buffer_bytes);
+        std::setvbuf(file_, write_buffer_.data(), _IOFBF, write_buffer_.size());
+    }
+
+    file_bytes_ = 0;
+    if (rotatable_) {
+        struct stat info;
+        if (stat(config_.path.c_str(), &info) == 0) {
+            file_bytes_ = static_cast<size_t>(info.st_size);
+        }
+    }
+    file_opened_ = std::chrono::steady_clock::now();
+    last_flush_ = file_opened_;
+    return true;
+}
+
+void MarkerEventLog::closeOutput() {
+    if (!file_) {
+        return;
+    }
+    std::fflush(file_);
+    if (file_ != stdout) {
+        std::fclose(file_);
+    }
+    file_ = nullptr;
+}
+
+void MarkerEventLog::rotate() {
+    closeOutput();
+
+    std::time_t now = std::time(nullptr);
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", std::localtime(&now));
+
+    // Two rotations within one second get a numeric suffix
+    std::string rotated = config_.path + "." + stamp;
+    struct stat info;
+    for (int suffix = 1; stat(rotated.c_str(), &info) == 0; suffix++) {
+        rotated = config_.path + "." + stamp + "." + std::to_string(suffix);
+    }
+
+    if (std::rename(config_.path.c_str(), rotated.c_str()) != 0) {
+        std::cerr << "⚠️ Failed to rotate marker event log to " << rotated << std::endl;
+    } else {
+        files_rotated_++;
+    }
+
+    if (!openOutput()) {
+        std::cerr << "❌ Marker event log stopped writing after failed rotation" << std::endl;
+    }
+}
+
+void MarkerEventLog::writerLoop() {
+    while (running_) {
+        size_t drained = drain();
+
+        auto now = std::chrono::steady_clock::now();
+        if (file_ && now - last_flush_ >= std::chrono::milliseconds(config_.flush_interval_ms)) {
+            std::fflush(file_);
+            last_flush_ = now;
+        }
+
+        if (rotatable_ && file_ &&
+            ((config_.max_file_bytes > 0 && file_bytes_ >= config_.max_file_bytes) ||
+             (config_.max_file_age_s > 0 && now - file_opened_ >= std::chrono::seconds(config_.max_file_age_s)))) {
+            rotate();
+        }
+
+        if (drained == 0) {
+            std::unique_lock<std::mutex> lock(wake_mutex_);
+            wake_cv_.wait_for(lock, std::chrono::milliseconds(WRITER_POLL_MS), [this]() { return !running_; });
+        }
+    }
+}
+
+size_t MarkerEventLog::drain() {
+    size_t head = head_.load(std::memory_order_relaxed);
+    size_t tail = tail_.load(std::memory_order_acquire);
+    size_t drained = 0;
+
+    std::vector<char> line;
+    while (head != tail) {
+        const Record& record = ring_[head & ring_mask_];
+        size_t consumed = 1;
+
+        if (record.type == LIFECYCLE_EVENT) {
+            char buffer[192];
+            int length = std::snprintf(buffer, sizeof(buffer),
+                "{\"t\":%lld,\"ev\":\"%s\",\"id\":%d,\"s\":%d,\"x\":%.4f,\"y\":%.4f,\"a\":%.3f}\n",
+                static_cast<long long>(record.time_ms), kindName(record.kind), record.id, record.session,
+                record.x, record.y, record.angle);
+            writeLine(buffer, static_cast<size_t>(std::min<int>(length, sizeof(buffer) - 1)));
+        } else if (record.type == FRAME_HEADER) {
+            // The producer publishes whole frames, so all marker records are present
+            line.resize(64 + MAX_MARKER_JSON * (record.count + 1));
+            size_t length = appendFormat(line, 0, "{\"t\":%lld,\"f\":%llu,\"m\":[",
+                                         static_cast<long long>(record.time_ms),
+                                         static_cast<unsigned long long>(record.frame));
+            for (uint32_t i = 0; i < record.count; i++) {
+                const Record& marker = ring_[(head + 1 + i) & ring_mask_];
+                length = appendFormat(line, length, "%s{\"id\":%d,\"x\":%.4f,\"y\":%.4f,\"a\":%.3f,\"c\":%.2f}",
+                                      i > 0 ? "," : "", marker.id, marker.x, marker.y, marker.angle,
+                                      marker.confidence);
+            }
+            length = appendFormat(line, length, "]}\n");
+            writeLine(line.data(), length);
+            consumed += record.count;
+        }
+
+        head += consumed;
+        drained += consumed;
+        head_.store(head, std::memory_order_release);
+    }
+    return drained;
+}
+
+void MarkerEventLog::writeLine(const char* line, size_t length) {
+    if (!file_) {
+        return;
+    }
+    size_t written = std::fwrite(line, 1, length, file_);
+    file_bytes_ += written;
+    bytes_written_.fetch_add(written, std::memory_order_relaxed);
+}
+
+} // namespace CodiceCam
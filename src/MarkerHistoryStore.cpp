@@ -0,0 +1,521 @@
+#include "MarkerHistoryStore.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace CodiceCam {
+
+namespace {
+    const char SEGMENT_MAGIC[4] = {'C', 'M', 'H', 'S'};
+    const uint32_t SEGMENT_VERSION = 1;
+    const size_t PAGE_ALIGN = 4096;
+    const char* SEGMENT_PREFIX = "segment-";
+    const char* SEGMENT_SUFFIX = ".cmh";
+
+    struct SegmentHeader {
+        char magic[4];
+        uint32_t version;
+        uint64_t capacity;
+        uint64_t row_count;
+        int64_t min_time_ms;
+        int64_t max_time_ms;
+        uint64_t block_rows;
+    };
+
+    // Byte offsets of the block index and columns inside a segment file
+    struct SegmentLayout {
+        size_t block_index;
+        size_t time;
+        size_t id;
+        size_t x;
+        size_t y;
+        size_t angle;
+        size_t confidence;
+        size_t file_size;
+    };
+
+    size_t alignUp(size_t value) {
+        return (value + PAGE_ALIGN - 1) / PAGE_ALIGN * PAGE_ALIGN;
+    }
+
+    SegmentLayout computeLayout(uint64_t capacity, uint64_t block_rows) {
+        SegmentLayout layout;
+        uint64_t blocks = (capacity + block_rows - 1) / block_rows;
+        layout.block_index = PAGE_ALIGN;
+        layout.time = alignUp(layout.block_index + blocks * sizeof(int64_t));
+        layout.id = alignUp(layout.time + capacity * sizeof(int64_t));
+        layout.x = alignUp(layout.id + capacity * sizeof(int32_t));
+        layout.y = alignUp(layout.x + capacity * sizeof(float));
+        layout.angle = alignUp(layout.y + capacity * sizeof(float));
+        layout.confidence = alignUp(layout.angle + capacity * sizeof(float));
+        layout.file_size = alignUp(layout.confidence + capacity * sizeof(float));
+        return layout;
+    }
+}
+
+struct MarkerHistoryStore::Segment {
+    std::string path;
+    uint64_t capacity = 0;
+    uint64_t row_count = 0;
+    int64_t min_time_ms = 0;
+    int64_t max_time_ms = 0;
+    SegmentLayout layout = {};
+
+    int fd = -1;
+    uint8_t* base = nullptr;
+    bool writable = false;
+
+    ~Segment() {
+#ifndef _WIN32
+        if (base) {
+            munmap(base, layout.file_size);
+        }
+        if (fd >= 0) {
+            ::close(fd);
+        }
+#endif
+    }
+
+    SegmentHeader* header() const { return reinterpret_cast<SegmentHeader*>(base); }
+    int64_t* blockIndex() const { return reinterpret_cast<int64_t*>(base + layout.block_index); }
+    int64_t* timeColumn() const { return reinterpret_cast<int64_t*>(base + layout.time); }
+    int32_t* idColumn() const { return reinterpret_cast<int32_t*>(base + layout.id); }
+    float* xColumn() const { return reinterpret_cast<float*>(base + layout.x); }
+    float* yColumn() const { return reinterpret_cast<float*>(base + layout.y); }
+    float* angleColumn() const { return reinterpret_cast<float*>(base + layout.angle); }
+    float* confidenceColumn() const { return reinterpret_cast<float*>(base + layout.confidence); }
+};
+
+MarkerHistoryStore::MarkerHistoryStore(const MarkerHistoryConfig& config)
+    : config_(config)
+    , open_(false)
+    , rows_appended_(0)
+    , frames_appended_(0)
+{
+    config_.segment_rows = std::max<uint64_t>(config_.segment_rows, BLOCK_ROWS);
+}
+
+MarkerHistoryStore::~MarkerHistoryStore() {
+    close();
+}
+
+bool MarkerHistoryStore::open() {
+#ifdef _WIN32
+    std::cerr << "❌ Marker history store requires a POSIX system (mmap)" << std::endl;
+    return false;
+#else
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (open_) {
+        return true;
+    }
+
+    DIR* dir = opendir(config_.directory.c_str());
+    if (!dir) {
+        std::cerr << "❌ Failed to open marker history directory: " << config_.directory
+                  << " (" << std::strerror(errno) << ")" << std::endl;
+        return false;
+    }
+
+    // Index existing segments by their headers; columns stay unmapped until queried
+    std::vector<std::string> names;
+    while (dirent* entry = readdir(dir)) {
+        std::string name = entry->d_name;
+        if (name.rfind(SEGMENT_PREFIX, 0) == 0 && name.size() > std::strlen(SEGMENT_SUFFIX) &&
+            name.compare(name.size() - std::strlen(SEGMENT_SUFFIX), std::string::npos, SEGMENT_SUFFIX) == 0) {
+            names.push_back(name);
+        }
+    }
+    closedir(dir);
+    std::sort(names.begin(), names.end());  // Zero-padded start times sort chronologically
+
+    segments_.clear();
+    for (const auto& name : names) {
+        std::string path = config_.directory + "/" + name;
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            continue;
+        }
+        SegmentHeader header;
+        ssize_t read_bytes = pread(fd, &header, sizeof(header), 0);
+        struct stat info;
+        bool stat_ok = fstat(fd, &info) == 0;
+        ::close(fd);
+
+        if (read_bytes != static_cast<ssize_t>(sizeof(header)) ||
+            std::memcmp(header.magic, SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC)) != 0 ||
+            header.version != SEGMENT_VERSION || header.block_rows != BLOCK_ROWS ||
+            header.row_count > header.capacity) {
+            std::cerr << "⚠️ Skipping invalid history segment: " << path << std::endl;
+            continue;
+        }
+
+        // A truncated file (crash while creating, full disk, copy cut short) would SIGBUS when mapped;
+        // its columns are laid out by capacity, so the rows present cannot be recovered either
+        SegmentLayout layout = computeLayout(header.capacity, BLOCK_ROWS);
+        if (!stat_ok || header.capacity > static_cast<uint64_t>(info.st_size) ||
+            static_cast<uint64_t>(info.st_size) < layout.file_size) {
+            std::cerr << "⚠️ Skipping truncated history segment: " << path << " ("
+                      << (stat_ok ? static_cast<uint64_t>(info.st_size) : 0) << " of " << layout.file_size
+                      << " bytes)" << std::endl;
+            continue;
+        }
+
+        auto segment = std::make_shared<Segment>();
+        segment->path = path;
+        segment->capacity = header.capacity;
+        segment->row_count = header.row_count;
+        segment->min_time_ms = header.min_time_ms;
+        segment->max_time_ms = header.max_time_ms;
+        segment->layout = layout;
+        segments_.push_back(segment);
+    }
+
+    // Keep appending to the newest segment if it has room
+    if (!segments_.empty()) {
+        auto& last = segments_.back();
+        if (last->row_count < last->capacity && !mapSegment(*last, true)) {
+            std::cerr << "⚠️ Newest history segment is read-only, starting a new one" << std::endl;
+        }
+    }
+
+    open_ = true;
+    std::cout << "🗄️ Marker history store opened: " << config_.directory << " (" << segments_.size() << " segments)" << std::endl;
+    return true;
+#endif
+}
+
+void MarkerHistoryStore::close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!open_) {
+        return;
+    }
+#ifndef _WIN32
+    if (!segments_.empty() && segments_.back()->writable) {
+        msync(segments_.back()->base, segments_.back()->layout.file_size, MS_SYNC);
+    }
+#endif
+    segments_.clear();
+    open_ = false;
+}
+
+bool MarkerHistoryStore::isOpen() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return open_;
+}
+
+bool MarkerHistoryStore::appendFrame(int64_t time_ms, const StreamMarker* markers, size_t count) {
+    std::shared_ptr<Segment> segment;
+    uint64_t first_row;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!open_) {
+            return false;
+        }
+        frames_appended_++;
+        if (count == 0) {
+            return true;
+        }
+        if (count > config_.segment_rows) {
+            return false;
+        }
+
+        // Rows must stay in time order for the index; clamp clock steps backwards
+        if (!segments_.empty() && segments_.back()->row_count > 0) {
+            time_ms = std::max(time_ms, segments_.back()->max_time_ms);
+        }
+
+        segment = segments_.empty() ? nullptr : segments_.back();
+        if (!segment || !segment->writable || segment->capacity - segment->row_count < count) {
+            segment = createSegment(time_ms);
+            if (!segment) {
+                return false;
+            }
+        }
+        first_row = segment->row_count;
+    }
+
+    // Rows past row_count are invisible to queries, so write them unlocked
+    int64_t* time_column = segment->timeColumn();
+    int32_t* id_column = segment->idColumn();
+    float* x_column = segment->xColumn();
+    float* y_column = segment->yColumn();
+    float* angle_column = segment->angleColumn();
+    float* confidence_column = segment->confidenceColumn();
+    int64_t* block_index = segment->blockIndex();
+
+    for (size_t i = 0; i < count; i++) {
+        uint64_t row = first_row + i;
+        time_column[row] = time_ms;
+        id_column[row] = markers[i].id;
+        x_column[row] = markers[i].x;
+        y_column[row] = markers[i].y;
+        angle_column[row] = markers[i].angle;
+        confidence_column[row] = markers[i].confidence;
+        if (row % BLOCK_ROWS == 0) {
+            block_index[row / BLOCK_ROWS] = time_ms;
+        }
+    }
+
+    // Publish the frame: one header update per frame
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (segment->row_count == 0) {
+        segment->min_time_ms = time_ms;
+        segment->header()->min_time_ms = time_ms;
+    }
+    segment->row_count = first_row + count;
+    segment->max_time_ms = time_ms;
+    segment->header()->max_time_ms = time_ms;
+    segment->header()->row_count = segment->row_count;
+    rows_appended_ += count;
+    return true;
+}
+
+size_t MarkerHistoryStore::query(int marker_id, int64_t t0_ms, int64_t t1_ms, std::vector<HistoryRow>& rows) const {
+    size_t found = 0;
+    scanRange(t0_ms, t1_ms, [&](const ColumnView& view, uint64_t begin, uint64_t end) {
+        for (uint64_t row = begin; row < end; row++) {
+            if (marker_id >= 0 && view.id[row] != marker_id) {
+                continue;
+            }
+            rows.push_back({view.time[row], view.id[row], view.x[row], view.y[row], view.angle[row], view.confidence[row]});
+            found++;
+        }
+    });
+    return found;
+}
+
+size_t MarkerHistoryStore::buildHeatmap(int marker_id, int64_t t0_ms, int64_t t1_ms,
+                                        int grid_width, int grid_height, std::vector<uint32_t>& heatmap) const {
+    if (grid_width <= 0 || grid_height <= 0) {
+        return 0;
+    }
+    heatmap.resize(static_cast<size_t>(grid_width) * grid_height, 0);
+
+    size_t counted = 0;
+    scanRange(t0_ms, t1_ms, [&](const ColumnView& view, uint64_t begin, uint64_t end) {
+        for (uint64_t row = begin; row < end; row++) {
+            if (marker_id >= 0 && view.id[row] != marker_id) {
+                continue;
+            }
+            int gx = std::min(std::max(static_cast<int>(view.x[row] * grid_width), 0), grid_width - 1);
+            int gy = std::min(std::max(static_cast<int>(view.y[row] * grid_height), 0), grid_height - 1);
+            heatmap[static_cast<size_t>(gy) * grid_width + gx]++;
+            counted++;
+        }
+    });
+    return counted;
+}
+
+void MarkerHistoryStore::flush() {
+#ifndef _WIN32
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!segments_.empty() && segments_.back()->writable) {
+        msync(segments_.back()->base, segments_.back()->layout.file_size, MS_ASYNC);
+    }
+#endif
+}
+
+std::string MarkerHistoryStore::getStatistics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t total_rows = 0;
+    for (const auto& segment : segments_) {
+        total_rows += segment->row_count;
+    }
+
+    std::ostringstream oss;
+    oss << "Marker History Store (" << config_.directory << "):\n";
+    oss << "  Segments: " << segments_.size() << " (" << config_.segment_rows << " rows each)\n";
+    oss << "  Rows stored: " << total_rows << "\n";
+    oss << "  Appended this session: " << rows_appended_ << " rows, " << frames_appended_ << " frames\n";
+    if (!segments_.empty()) {
+        oss << "  Time range: " << segments_.front()->min_time_ms << " - " << segments_.back()->max_time_ms << " ms\n";
+    }
+    return oss.str();
+}
+
+std::shared_ptr<MarkerHistoryStore::Segment> MarkerHistoryStore::createSegment(int64_t first_time_ms) {
+#ifdef _WIN32
+    (void)first_time_ms;
+    return nullptr;
+#else
+    // The previous active segment becomes history; it stays mapped because
+    // queries may be scanning it outside the lock
+    if (!segments_.empty() && segments_.back()->writable) {
+        auto& previous = segments_.back();
+        msync(previous->base, previous->layout.file_size, MS_ASYNC);
+        previous->writable = false;
+    }
+
+    std::ostringstream name;
+    name << config_.directory << "/" << SEGMENT_PREFIX << std::setfill('0') << std::setw(16) << first_time_ms << SEGMENT_SUFFIX;
+
+    auto segment = std::make_shared<Segment>();
+    segment->path = name.str();
+    segment->capacity = config_.segment_rows;
+    segment->layout = computeLayout(segment->capacity, BLOCK_ROWS);
+
+    // Existing file with the same start time (restart within the same millisecond)
+    struct stat info;
+    if (stat(segment->path.c_str(), &info) == 0) {
+        segment->path += "." + std::to_string(segments_.size());
+    }
+
+    segment->fd = ::open(segment->path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (segment->fd < 0) {
+        std::cerr << "❌ Failed to create history segment " << segment->path << ": " << std::strerror(errno) << std::endl;
+        return nullptr;
+    }
+
+    // Reserve the space up front so a full disk fails here rather than as SIGBUS on a mapped write
+    int result = ftruncate(segment->fd, static_cast<off_t>(segment->layout.file_size));
+#ifdef __linux__
+    if (result == 0) {
+        result = posix_fallocate(segment->fd, 0, static_cast<off_t>(segment->layout.file_size));
+        errno = result != 0 ? result : errno;
+    }
+#endif
+    if (result != 0) {
+        std::cerr << "❌ Failed to size history segment " << segment->path << ": " << std::strerror(errno) << std::endl;
+        ::close(segment->fd);
+        segment->fd = -1;
+        unlink(segment->path.c_str());
+        return nullptr;
+    }
+
+    void* base = mmap(nullptr, segment->layout.file_size, PROT_READ | PROT_WRITE, MAP_SHARED, segment->fd, 0);
+    if (base == MAP_FAILED) {
+        std::cerr << "❌ Failed to map history segment " << segment->path << ": " << std::strerror(errno) << std::endl;
+        unlink(segment->path.c_str());
+        return nullptr;
+    }
+    segment->base = static_cast<uint8_t*>(base);
+    segment->writable = true;
+
+    SegmentHeader* header = segment->header();
+    std::memcpy(header->magic, SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC));
+    header->version = SEGMENT_VERSION;
+    header->capacity = segment->capacity;
+    header->row_count = 0;
+    header->min_time_ms = first_time_ms;
+    header->max_time_ms = first_time_ms;
+    header->block_rows = BLOCK_ROWS;
+    segment->min_time_ms = first_time_ms;
+    segment->max_time_ms = first_time_ms;
+
+    segments_.push_back(segment);
+    enforceRetention();
+    return segment;
+#endif
+}
+
+bool MarkerHistoryStore::mapSegment(Segment& segment, bool writable) const {
+#ifdef _WIN32
+    (void)segment;
+    (void)writable;
+    return false;
+#else
+    if (segment.base) {
+        return true;
+    }
+
+    segment.fd = ::open(segment.path.c_str(), writable ? O_RDWR : O_RDONLY);
+    if (segment.fd < 0) {
+        return false;
+    }
+
+    // The file may have been truncated since open() checked it
+    struct stat info;
+    if (fstat(segment.fd, &info) != 0 || static_cast<uint64_t>(info.st_size) < segment.layout.file_size) {
+        std::cerr << "⚠️ History segment is shorter than its layout, not mapping: " << segment.path << std::endl;
+        ::close(segment.fd);
+        segment.fd = -1;
+        return false;
+    }
+
+    int protection = writable ? (PROT_READ | PROT_WRITE) : PROT_READ;
+    void* base = mmap(nullptr, segment.layout.file_size, protection, MAP_SHARED, segment.fd, 0);
+    if (base == MAP_FAILED) {
+        ::close(segment.fd);
+        segment.fd = -1;
+        return false;
+    }
+
+    segment.base = static_cast<uint8_t*>(base);
+    segment.writable = writable;
+    return true;
+#endif
+}
+
+void MarkerHistoryStore::enforceRetention() {
+    if (config_.max_segments == 0) {
+        return;
+    }
+    while (segments_.size() > config_.max_segments) {
+        // Running queries keep their mapping until they finish
+        unlink(segments_.front()->path.c_str());
+        segments_.erase(segments_.begin());
+    }
+}
+
+void MarkerHistoryStore::scanRange(int64_t t0_ms, int64_t t1_ms, const RowVisitor& visitor) const {
+    if (t1_ms < t0_ms) {
+        return;
+    }
+
+    // Snapshot the overlapping segments and their committed row counts
+    std::vector<std::pair<std::shared_ptr<Segment>, uint64_t>> selected;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& segment : segments_) {
+            if (segment->row_count == 0 || segment->max_time_ms < t0_ms || segment->min_time_ms > t1_ms) {
+                continue;
+            }
+            if (!segment->base && !mapSegment(*segment, false)) {
+                std::cerr << "⚠️ Failed to map history segment " << segment->path << std::endl;
+                continue;
+            }
+            selected.emplace_back(segment, segment->row_count);
+        }
+    }
+
+    for (const auto& [segment, row_count] : selected) {
+        ColumnView view;
+        view.time = segment->timeColumn();
+        view.id = segment->idColumn();
+        view.x = segment->xColumn();
+        view.y = segment->yColumn();
+        view.angle = segment->angleColumn();
+        view.confidence = segment->confidenceColumn();
+        view.block_index = segment->blockIndex();
+        view.row_count = row_count;
+
+        // First row at or after t: block index, then binary search inside the block
+        auto lowerBound = [&view](int64_t t) -> uint64_t {
+            uint64_t blocks = (view.row_count + BLOCK_ROWS - 1) / BLOCK_ROWS;
+            const int64_t* block = std::lower_bound(view.block_index, view.block_index + blocks, t);
+            uint64_t block_number = static_cast<uint64_t>(block - view.block_index);
+            uint64_t begin = block_number > 0 ? (block_number - 1) * BLOCK_ROWS : 0;
+            uint64_t end = std::min(view.row_count, block_number * BLOCK_ROWS + 1);
+            return static_cast<uint64_t>(std::lower_bound(view.time + begin, view.time + end, t) - view.time);
+        };
+
+        uint64_t begin = lowerBound(t0_ms);
+        uint64_t end = (t1_ms == INT64_MAX) ? view.row_count : lowerBound(t1_ms + 1);
+        if (begin < end) {
+            visitor(view, begin, end);
+        }
+    }
+}
+
+} // namespace CodiceCam
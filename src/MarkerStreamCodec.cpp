@@ -0,0 +1,557 @@
+#include "MarkerStreamCodec.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+namespace CodiceCam {
+
+namespace {
+
+constexpr double TWO_PI = 6.283185307179586;
+constexpr size_t MAX_STORED_KEYFRAMES = 8;
+
+void writeVarint(std::vector<uint8_t>& out, uint32_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+void writeZigzag(std::vector<uint8_t>& out, int32_t value) {
+    writeVarint(out, (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31));
+}
+
+void writeU16(std::vector<uint8_t>& out, uint16_t value) {
+    out.push_back(static_cast<uint8_t>(value & 0xFF));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+}
+
+void writeHeader(std::vector<uint8_t>& out, uint8_t type) {
+    out.push_back(MarkerStream::MAGIC_0);
+    out.push_back(MarkerStream::MAGIC_1);
+    out.push_back(type);
+}
+
+/**
+ * @brief Bounds-checked reader over a received packet
+ */
+struct PacketReader {
+    const uint8_t* pos;
+    const uint8_t* end;
+    bool ok;
+
+    PacketReader(const uint8_t* data, size_t size) : pos(data), end(data + size), ok(data != nullptr) {}
+
+    uint8_t readU8() {
+        if (!ok || pos >= end) {
+            ok = false;
+            return 0;
+        }
+        return *pos++;
+    }
+
+    uint16_t readU16() {
+        uint16_t lo = readU8();
+        uint16_t hi = readU8();
+        return static_cast<uint16_t>(lo | (hi << 8));
+    }
+
+    uint32_t readVarint() {
+        uint32_t value = 0;
+        for (int shift = 0; shift < 35; shift += 7) {
+            uint8_t byte = readU8();
+            if (!ok) {
+                return 0;
+            }
+            value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        ok = false;
+        return 0;
+    }
+
+    int32_t readZigzag() {
+        uint32_t raw = readVarint();
+        return static_cast<int32_t>(raw >> 1) ^ -static_cast<int32_t>(raw & 1);
+    }
+};
+
+bool confidenceChanged(uint8_t a, uint8_t b) {
+    return std::abs(static_cast<int>(a) - static_cast<int>(b)) > 1;
+}
+
+size_t oscStringBytes(size_t length) {
+    // OSC strings are null-terminated and padded to a multiple of 4 bytes
+    return (length + 4) & ~static_cast<size_t>(3);
+}
+
+} // namespace
+
+// MarkerStream helpers
+
+MarkerStream::QuantizedMarker MarkerStream::quantize(const StreamMarker& marker) {
+    QuantizedMarker q;
+    float x = std::min(std::max(marker.x, 0.0f), 1.0f);
+    float y = std::min(std::max(marker.y, 0.0f), 1.0f);
+    double angle = std::fmod(static_cast<double>(marker.angle), TWO_PI);
+    if (angle < 0.0) {
+        angle += TWO_PI;
+    }
+    float confidence = std::min(std::max(marker.confidence, 0.0f), 1.0f);
+
+    q.x = static_cast<uint16_t>(std::lround(x * 65535.0f));
+    q.y = static_cast<uint16_t>(std::lround(y * 65535.0f));
+    q.angle = static_cast<uint16_t>(std::lround(angle / TWO_PI * 65536.0) & 0xFFFF);
+    q.confidence = static_cast<uint8_t>(std::lround(confidence * 255.0f));
+    return q;
+}
+
+StreamMarker MarkerStream::dequantize(int id, const QuantizedMarker& quantized) {
+    StreamMarker marker;
+    marker.id = id;
+    marker.x = quantized.x / 65535.0f;
+    marker.y = quantized.y / 65535.0f;
+    marker.angle = static_cast<float>(quantized.angle / 65536.0 * TWO_PI);
+    marker.confidence = quantized.confidence / 255.0f;
+    return marker;
+}
+
+size_t MarkerStream::tuio11SetMessageBytes() {
+    // /tuio/2Dobj ,siiffffffff "set" s i x y a X Y A m r
+    size_t message = oscStringBytes(11) + oscStringBytes(12) + oscStringBytes(3) + 2 * 4 + 8 * 4;
+    return 4 + message;  // bundle element size prefix
+}
+
+size_t MarkerStream::tuio11BundleBytes(size_t alive_count, size_t updated_count) {
+    size_t bundle_header = oscStringBytes(7) + 8;  // "#bundle" + timetag
+    size_t alive = 4 + oscStringBytes(11) + oscStringBytes(2 + alive_count) + oscStringBytes(5) + 4 * alive_count;
+    size_t fseq = 4 + oscStringBytes(11) + oscStringBytes(3) + oscStringBytes(4) + 4;
+    return bundle_header + alive + updated_count * tuio11SetMessageBytes() + fseq;
+}
+
+// MarkerStreamEncoder implementation
+
+MarkerStreamEncoder::MarkerStreamEncoder(int keyframe_interval)
+    : keyframe_interval_(std::max(1, keyframe_interval))
+    , assume_delivered_(false)
+    , force_keyframe_(true)
+    , next_seq_(0)
+    , frames_since_keyframe_(0)
+    , has_acked_keyframe_(false)
+    , acked_seq_(0)
+    , total_keyframes_(0)
+    , total_deltas_(0)
+    , total_bytes_(0)
+    , total_markers_(0)
+{
+}
+
+const std::vector<uint8_t>& MarkerStreamEncoder::encode(const std::vector<StreamMarker>& markers, uint32_t timestamp_ms) {
+    MarkerStream::Snapshot snapshot;
+    for (const auto& marker : markers) {
+        if (marker.id < 0) {
+            continue;
+        }
+        snapshot[marker.id] = MarkerStream::quantize(marker);
+    }
+
+    uint32_t seq = next_seq_++;
+    bool keyframe = force_keyframe_ || !has_acked_keyframe_ || frames_since_keyframe_ >= keyframe_interval_;
+
+    if (!keyframe) {
+        encodeDelta(seq, timestamp_ms, snapshot);
+
+        // A delta that outgrows a keyframe is not worth sending
+        size_t keyframe_estimate = 3 + 5 + 5 + 5 + snapshot.size() * 9;
+        if (packet_.size() > keyframe_estimate) {
+            keyframe = true;
+        }
+    }
+
+    if (keyframe) {
+        encodeKeyframe(seq, timestamp_ms, snapshot);
+
+        pending_keyframes_[seq] = snapshot;
+        while (pending_keyframes_.size() > MAX_STORED_KEYFRAMES) {
+            pending_keyframes_.erase(pending_keyframes_.begin());
+        }
+
+        frames_since_keyframe_ = 0;
+        force_keyframe_ = false;
+        total_keyframes_++;
+
+        if (assume_delivered_) {
+            acknowledge(seq);
+        }
+    } else {
+        frames_since_keyframe_++;
+        total_deltas_++;
+    }
+
+    total_bytes_ += packet_.size();
+    total_markers_ += snapshot.size();
+    return packet_;
+}
+
+bool MarkerStreamEncoder::acknowledge(uint32_t keyframe_seq) {
+    auto it = pending_keyframes_.find(keyframe_seq);
+    if (it == pending_keyframes_.end()) {
+        return false;
+    }
+
+    // Ignore ACKs that arrive out of order for older keyframes
+    if (has_acked_keyframe_ && static_cast<int32_t>(keyframe_seq - acked_seq_) <= 0) {
+        return false;
+    }
+
+    acked_snapshot_ = it->second;
+    acked_seq_ = keyframe_seq;
+    has_acked_keyframe_ = true;
+    pending_keyframes_.erase(pending_keyframes_.begin(), std::next(it));
+    return true;
+}
+
+bool MarkerStreamEncoder::processAckPacket(const uint8_t* data, size_t size) {
+    PacketReader reader(data, size);
+    if (reader.readU8() != MarkerStream::MAGIC_0 || reader.readU8() != MarkerStream::MAGIC_1 ||
+        reader.readU8() != MarkerStream::PACKET_ACK) {
+        return false;
+    }
+    uint32_t seq = reader.readVarint();
+    if (!reader.ok) {
+        return false;
+    }
+    return acknowledge(seq);
+}
+
+void MarkerStreamEncoder::setAssumeDelivered(bool enable) {
+    assume_delivered_ = enable;
+}
+
+void MarkerStreamEncoder::requestKeyframe() {
+    force_keyframe_ = true;
+}
+
+std::string MarkerStreamEncoder::getStatistics() const {
+    std::ostringstream oss;
+    oss << "Marker Stream Encoder Statistics:\n";
+    oss << "  Keyframes Sent: " << total_keyframes_ << "\n";
+    oss << "  Deltas Sent: " << total_deltas_ << "\n";
+    oss << "  Bytes Encoded: " << total_bytes_ << "\n";
+    if (total_markers_ > 0) {
+        oss << "  Bytes/Marker: " << std::fixed << std::setprecision(2)
+            << static_cast<double>(total_bytes_) / total_markers_ << "\n";
+    }
+    oss << "  Acknowledged Keyframe: " << (has_acked_keyframe_ ? std::to_string(acked_seq_) : "none") << "\n";
+    return oss.str();
+}
+
+void MarkerStreamEncoder::encodeKeyframe(uint32_t seq, uint32_t timestamp_ms, const MarkerStream::Snapshot& snapshot) {
+    packet_.clear();
+    writeHeader(packet_, MarkerStream::PACKET_KEYFRAME);
+    writeVarint(packet_, seq);
+    writeVarint(packet_, timestamp_ms);
+    writeVarint(packet_, static_cast<uint32_t>(snapshot.size()));
+
+    int previous_id = 0;
+    for (const auto& [id, q] : snapshot) {
+        writeVarint(packet_, static_cast<uint32_t>(id - previous_id));
+        previous_id = id;
+        writeU16(packet_, q.x);
+        writeU16(packet_, q.y);
+        writeU16(packet_, q.angle);
+        packet_.push_back(q.confidence);
+    }
+}
+
+void MarkerStreamEncoder::encodeDelta(uint32_t seq, uint32_t timestamp_ms, const MarkerStream::Snapshot& snapshot) {
+    packet_.clear();
+    writeHeader(packet_, MarkerStream::PACKET_DELTA);
+    writeVarint(packet_, seq);
+    writeVarint(packet_, acked_seq_);
+    writeVarint(packet_, timestamp_ms);
+
+    // Markers of the base keyframe that are gone
+    uint32_t removed_count = 0;
+    for (const auto& [id, q] : acked_snapshot_) {
+        if (snapshot.find(id) == snapshot.end()) {
+            removed_count++;
+        }
+    }
+    writeVarint(packet_, removed_count);
+    int previous_id = 0;
+    for (const auto& [id, q] : acked_snapshot_) {
+        if (snapshot.find(id) == snapshot.end()) {
+            writeVarint(packet_, static_cast<uint32_t>(id - previous_id));
+            previous_id = id;
+        }
+    }
+
+    // Markers that are new or differ from the base keyframe
+    size_t count_pos = packet_.size();
+    writeVarint(packet_, 0);  // placeholder, patched below
+    uint32_t entry_count = 0;
+    previous_id = 0;
+
+    std::vector<uint8_t> entries;
+    for (const auto& [id, q] : snapshot) {
+        auto base_it = acked_snapshot_.find(id);
+        if (base_it == acked_snapshot_.end()) {
+            writeVarint(entries, static_cast<uint32_t>(id - previous_id));
+            entries.push_back(MarkerStream::FLAG_ABSOLUTE | MarkerStream::FLAG_CONFIDENCE);
+            writeU16(entries, q.x);
+            writeU16(entries, q.y);
+            writeU16(entries, q.angle);
+            entries.push_back(q.confidence);
+        } else {
+            const auto& base = base_it->second;
+            bool moved = q.x != base.x || q.y != base.y || q.angle != base.angle;
+            bool confidence = confidenceChanged(q.confidence, base.confidence);
+            if (!moved && !confidence) {
+                continue;
+            }
+            writeVarint(entries, static_cast<uint32_t>(id - previous_id));
+            entries.push_back(confidence ? MarkerStream::FLAG_CONFIDENCE : 0);
+            writeZigzag(entries, static_cast<int32_t>(q.x) - static_cast<int32_t>(base.x));
+            writeZigzag(entries, static_cast<int32_t>(q.y) - static_cast<int32_t>(base.y));
+            writeZigzag(entries, static_cast<int16_t>(q.angle - base.angle));
+            if (confidence) {
+                entries.push_back(q.confidence);
+            }
+        }
+        previous_id = id;
+        entry_count++;
+    }
+
+    packet_.resize(count_pos);
+    writeVarint(packet_, entry_count);
+    packet_.insert(packet_.end(), entries.begin(), entries.end());
+}
+
+// MarkerStreamDecoder implementation
+
+MarkerStreamDecoder::MarkerStreamDecoder()
+    : ack_pending_(false)
+    , ack_seq_(0)
+    , frames_decoded_(0)
+    , frames_rejected_(0)
+{
+}
+
+bool MarkerStreamDecoder::decode(const uint8_t* data, size_t size, std::vector<StreamMarker>& markers, uint32_t& timestamp_ms) {
+    PacketReader reader(data, size);
+    if (reader.readU8() != MarkerStream::MAGIC_0 || reader.readU8() != MarkerStream::MAGIC_1) {
+        frames_rejected_++;
+        return false;
+    }
+
+    uint8_t type = reader.readU8();
+    MarkerStream::Snapshot snapshot;
+    uint32_t seq = 0;
+
+    if (type == MarkerStream::PACKET_KEYFRAME) {
+        seq = reader.readVarint();
+        timestamp_ms = reader.readVarint();
+        uint32_t count = reader.readVarint();
+
+        int id = 0;
+        for (uint32_t i = 0; i < count && reader.ok; i++) {
+            id += static_cast<int>(reader.readVarint());
+            MarkerStream::QuantizedMarker q;
+            q.x = reader.readU16();
+            q.y = reader.readU16();
+            q.angle = reader.readU16();
+            q.confidence = reader.readU8();
+            snapshot[id] = q;
+        }
+    } else if (type == MarkerStream::PACKET_DELTA) {
+        seq = reader.readVarint();
+        uint32_t base_seq = reader.readVarint();
+        timestamp_ms = reader.readVarint();
+
+        auto base_it = keyframes_.find(base_seq);
+        if (!reader.ok || base_it == keyframes_.end()) {
+            frames_rejected_++;
+            return false;
+        }
+        snapshot = base_it->second;
+
+        uint32_t removed_count = reader.readVarint();
+        int id = 0;
+        for (uint32_t i = 0; i < removed_count && reader.ok; i++) {
+            id += static_cast<int>(reader.readVarint());
+            snapshot.erase(id);
+        }
+
+        uint32_t entry_count = reader.readVarint();
+        id = 0;
+        for (uint32_t i = 0; i < entry_count && reader.ok; i++) {
+            id += static_cast<int>(reader.readVarint());
+            uint8_t flags = reader.readU8();
+
+            MarkerStream::QuantizedMarker q;
+            if (flags & MarkerStream::FLAG_ABSOLUTE) {
+                q.x = reader.readU16();
+                q.y = reader.readU16();
+                q.angle = reader.readU16();
+                q.confidence = 0;
+            } else {
+                auto base_marker = base_it->second.find(id);
+                if (base_marker == base_it->second.end()) {
+                    reader.ok = false;
+                    break;
+                }
+                q = base_marker->second;
+                q.x = static_cast<uint16_t>(q.x + reader.readZigzag());
+                q.y = static_cast<uint16_t>(q.y + reader.readZigzag());
+                q.angle = static_cast<uint16_t>(q.angle + reader.readZigzag());
+            }
+            if (flags & MarkerStream::FLAG_CONFIDENCE) {
+                q.confidence = reader.readU8();
+            }
+            snapshot[id] = q;
+        }
+    } else {
+        frames_rejected_++;
+        return false;
+    }
+
+    if (!reader.ok) {
+        frames_rejected_++;
+        return false;
+    }
+
+    if (type == MarkerStream::PACKET_KEYFRAME) {
+        keyframes_[seq] = snapshot;
+        while (keyframes_.size() > MAX_STORED_KEYFRAMES) {
+            keyframes_.erase(keyframes_.begin());
+        }
+        ack_pending_ = true;
+        ack_seq_ = seq;
+    }
+
+    markers.clear();
+    markers.reserve(snapshot.size());
+    for (const auto& [id, q] : snapshot) {
+        markers.push_back(MarkerStream::dequantize(id, q));
+    }
+
+    frames_decoded_++;
+    return true;
+}
+
+bool MarkerStreamDecoder::hasPendingAck() const {
+    return ack_pending_;
+}
+
+std::vector<uint8_t> MarkerStreamDecoder::takeAckPacket() {
+    std::vector<uint8_t> packet;
+    writeHeader(packet, MarkerStream::PACKET_ACK);
+    writeVarint(packet, ack_seq_);
+    ack_pending_ = false;
+    return packet;
+}
+
+std::string MarkerStreamDecoder::getStatistics() const {
+    std::ostringstream oss;
+    oss << "Marker Stream Decoder Statistics:\n";
+    oss << "  Frames Decoded: " << frames_decoded_ << "\n";
+    oss << "  Frames Rejected: " << frames_rejected_ << "\n";
+    oss << "  Stored Keyframes: " << keyframes_.size() << "\n";
+    return oss.str();
+}
+
+// Benchmark
+
+std::string MarkerStreamBenchmarkResult::toString() const {
+    std::ostringstream oss;
+    oss << "Marker Stream Benchmark (" << marker_count << " markers, " << frames << " frames):\n";
+    oss << std::fixed << std::setprecision(2);
+    oss << "  Binary: " << binary_bytes_per_marker << " bytes/marker\n";
+    oss << "  TUIO 1.1: " << tuio_bytes_per_marker << " bytes/marker\n";
+    oss << "  Compression Ratio: " << compression_ratio << "x\n";
+    oss << "  Round Trip: " << (round_trip_ok ? "OK" : "MISMATCH") << "\n";
+    return oss.str();
+}
+
+MarkerStreamBenchmarkResult benchmarkMarkerStream(int marker_count, int frames, double moving_fraction, int keyframe_interval) {
+    MarkerStreamBenchmarkResult result;
+    result.marker_count = std::max(1, std::min(marker_count, 4096));
+    result.frames = std::max(1, frames);
+    result.round_trip_ok = true;
+
+    // Deterministic pseudo-random scene
+    uint32_t rng = 0x12345678u;
+    auto next_random = [&rng]() {
+        rng = rng * 1664525u + 1013904223u;
+        return (rng >> 8) / 16777216.0f;
+    };
+
+    std::vector<StreamMarker> markers(result.marker_count);
+    for (int i = 0; i < result.marker_count; i++) {
+        markers[i].id = (i * 37) % 4096;
+        markers[i].x = next_random();
+        markers[i].y = next_random();
+        markers[i].angle = next_random() * static_cast<float>(TWO_PI);
+        markers[i].confidence = 0.8f + 0.2f * next_random();
+    }
+
+    MarkerStreamEncoder encoder(keyframe_interval);
+    MarkerStreamDecoder decoder;
+    uint64_t binary_bytes = 0;
+    uint64_t tuio_bytes = 0;
+
+    for (int frame = 0; frame < result.frames; frame++) {
+        for (auto& marker : markers) {
+            if (next_random() < moving_fraction) {
+                marker.x = std::min(std::max(marker.x + (next_random() - 0.5f) * 0.01f, 0.0f), 1.0f);
+                marker.y = std::min(std::max(marker.y + (next_random() - 0.5f) * 0.01f, 0.0f), 1.0f);
+                marker.angle += (next_random() - 0.5f) * 0.1f;
+            }
+        }
+
+        const auto& packet = encoder.encode(markers, static_cast<uint32_t>(frame * 33));
+        binary_bytes += packet.size();
+
+        // TUIOBridge updates every visible object each frame
+        tuio_bytes += MarkerStream::tuio11BundleBytes(markers.size(), markers.size());
+
+        std::vector<StreamMarker> decoded;
+        uint32_t timestamp_ms = 0;
+        if (!decoder.decode(packet.data(), packet.size(), decoded, timestamp_ms) ||
+            decoded.size() != markers.size()) {
+            result.round_trip_ok = false;
+        } else {
+            std::vector<StreamMarker> expected = markers;
+            std::sort(expected.begin(), expected.end(),
+                      [](const StreamMarker& a, const StreamMarker& b) { return a.id < b.id; });
+            for (size_t i = 0; i < expected.size(); i++) {
+                auto q_expected = MarkerStream::quantize(expected[i]);
+                auto q_decoded = MarkerStream::quantize(decoded[i]);
+                if (expected[i].id != decoded[i].id || q_expected.x != q_decoded.x ||
+                    q_expected.y != q_decoded.y || q_expected.angle != q_decoded.angle ||
+                    std::abs(static_cast<int>(q_expected.confidence) - static_cast<int>(q_decoded.confidence)) > 1) {
+                    result.round_trip_ok = false;
+                    break;
+                }
+            }
+        }
+
+        if (decoder.hasPendingAck()) {
+            auto ack = decoder.takeAckPacket();
+            encoder.processAckPacket(ack.data(), ack.size());
+        }
+    }
+
+    double marker_frames = static_cast<double>(result.marker_count) * result.frames;
+    result.binary_bytes_per_marker = binary_bytes / marker_frames;
+    result.tuio_bytes_per_marker = tuio_bytes / marker_frames;
+    result.compression_ratio = binary_bytes > 0 ? static_cast<double>(tuio_bytes) / binary_bytes : 0.0;
+    return result;
+}
+
+} // namespace CodiceCam
@@ -0,0 +1,85 @@
+#include "MemoryMonitor.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace CodiceCam {
+
+namespace {
+    const double BYTES_PER_MIB = 1024.0 * 1024.0;
+
+    // "VmRSS:     123456 kB" in /proc/self/status
+    size_t readStatusKiB(const std::string& key) {
+        std::ifstream file("/proc/self/status");
+        std::string line;
+        while (std::getline(file, line)) {
+            if (line.compare(0, key.size(), key) == 0) {
+                std::istringstream iss(line.substr(key.size()));
+                size_t kib = 0;
+                iss >> kib;
+                return kib * 1024;
+            }
+        }
+        return 0;
+    }
+
+    std::string formatMiB(size_t bytes) {
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(1) << bytes / BYTES_PER_MIB << " MiB";
+        return oss.str();
+    }
+}
+
+MemoryMonitor::MemoryMonitor(const cv::Size& frame_size, int frames_in_flight)
+    : frame_size_(frame_size)
+    , frames_in_flight_(std::max(1, frames_in_flight))
+{
+}
+
+void MemoryMonitor::addSubsystem(const std::string& name, BytesFunction bytes) {
+    if (!bytes) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    subsystems_.push_back({name, bytes});
+}
+
+size_t MemoryMonitor::getTargetBytes() const {
+    return targetBytes(frame_size_, frames_in_flight_);
+}
+
+std::string MemoryMonitor::getStatistics() const {
+    size_t rss = readRssBytes();
+    size_t peak = readPeakRssBytes();
+    size_t target = getTargetBytes();
+
+    std::ostringstream oss;
+    oss << "Memory:\n";
+    oss << "  RSS: " << formatMiB(rss) << " (peak " << formatMiB(peak) << ")\n";
+    oss << "  Target budget (" << frame_size_.width << "x" << frame_size_.height << ", "
+        << frames_in_flight_ << " in flight): " << formatMiB(target)
+        << (peak > target ? " - peak over budget" : "") << "\n";
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& subsystem : subsystems_) {
+        oss << "  " << subsystem.name << ": " << formatMiB(subsystem.bytes()) << "\n";
+    }
+    return oss.str();
+}
+
+size_t MemoryMonitor::targetBytes(const cv::Size& frame_size, int frames_in_flight) {
+    size_t pixels = static_cast<size_t>(std::max(0, frame_size.area()));
+    size_t frames = static_cast<size_t>(std::max(1, frames_in_flight));
+    return BASE_BYTES + pixels * (CAMERA_BYTES_PER_PIXEL + frames * FRAME_BYTES_PER_PIXEL);
+}
+
+size_t MemoryMonitor::readRssBytes() {
+    return readStatusKiB("VmRSS:");
+}
+
+size_t MemoryMonitor::readPeakRssBytes() {
+    return readStatusKiB("VmHWM:");
+}
+
+} // namespace CodiceCam
@@ -0,0 +1,291 @@
+#include "PerfCounters.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace CodiceCam {
+
+namespace {
+#ifdef __linux__
+    long perfEventOpen(perf_event_attr* attr, int group_fd) {
+        // Calling thread (pid 0) on any CPU (-1)
+        return syscall(__NR_perf_event_open, attr, 0, -1, group_fd, 0);
+    }
+
+    // Scale a counter that was only scheduled part of the time (PMU multiplexing)
+    uint64_t scaleCount(uint64_t value, uint64_t time_enabled, uint64_t time_running) {
+        if (time_running == 0 || time_running >= time_enabled) {
+            return value;
+        }
+        return static_cast<uint64_t>(static_cast<double>(value) * time_enabled / time_running);
+    }
+#endif
+
+    uint64_t delta(uint64_t end, uint64_t start) {
+        return end > start ? end - start : 0;
+    }
+}
+
+PerfCounters::PerfCounters()
+    : group_size_(0)
+    , unavailable_reason_("not opened")
+{
+    std::fill(fds_, fds_ + EVENT_COUNT, -1);
+    std::fill(slots_, slots_ + EVENT_COUNT, -1);
+}
+
+PerfCounters::~PerfCounters() {
+    close();
+}
+
+bool PerfCounters::open() {
+    close();
+
+#ifdef __linux__
+    const uint64_t configs[EVENT_COUNT] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES
+    };
+
+    for (int event = 0; event < EVENT_COUNT; event++) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = configs[event];
+        attr.disabled = (event == CYCLES) ? 1 : 0;  // The group starts with the leader
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        long fd = perfEventOpen(&attr, event == CYCLES ? -1 : fds_[CYCLES]);
+        if (fd < 0) {
+            if (event == CYCLES) {
+                int err = errno;
+                unavailable_reason_ = std::string("perf_event_open failed: ") + std::strerror(err);
+                if (err == EACCES || err == EPERM) {
+                    unavailable_reason_ += " (check /proc/sys/kernel/perf_event_paranoid or container seccomp profile)";
+                } else if (err == ENOENT || err == ENODEV || err == EOPNOTSUPP) {
+                    unavailable_reason_ += " (no hardware PMU exposed, e.g. virtual machine)";
+                }
+                return false;
+            }
+            // Optional event not supported by this CPU; it reads as 0
+            continue;
+        }
+
+        fds_[event] = static_cast<int>(fd);
+        slots_[event] = group_size_++;
+    }
+
+    ioctl(fds_[CYCLES], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    if (ioctl(fds_[CYCLES], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP) < 0) {
+        int err = errno;
+        close();
+        unavailable_reason_ = std::string("failed to enable counters: ") + std::strerror(err);
+        return false;
+    }
+
+    unavailable_reason_.clear();
+    return true;
+#else
+    unavailable_reason_ = "hardware counters are only supported on Linux";
+    return false;
+#endif
+}
+
+void PerfCounters::close() {
+#ifdef __linux__
+    // Members first, leader last
+    for (int event = EVENT_COUNT - 1; event >= 0; event--) {
+        if (fds_[event] >= 0) {
+            ::close(fds_[event]);
+        }
+    }
+#endif
+    std::fill(fds_, fds_ + EVENT_COUNT, -1);
+    std::fill(slots_, slots_ + EVENT_COUNT, -1);
+    group_size_ = 0;
+    unavailable_reason_ = "not opened";
+}
+
+bool PerfCounters::isAvailable() const {
+    return fds_[CYCLES] >= 0;
+}
+
+const std::string& PerfCounters::getUnavailableReason() const {
+    return unavailable_reason_;
+}
+
+bool PerfCounters::read(PerfSample& sample) const {
+    if (!isAvailable()) {
+        return false;
+    }
+
+#ifdef __linux__
+    // PERF_FORMAT_GROUP layout: nr, time_enabled, time_running, values[nr]
+    uint64_t buffer[3 + EVENT_COUNT];
+    ssize_t expected = static_cast<ssize_t>((3 + group_size_) * sizeof(uint64_t));
+    if (::read(fds_[CYCLES], buffer, sizeof(buffer)) < expected) {
+        return false;
+    }
+
+    uint64_t time_enabled = buffer[1];
+    uint64_t time_running = buffer[2];
+    auto value = [&](int event) -> uint64_t {
+        return slots_[event] < 0 ? 0 : scaleCount(buffer[3 + slots_[event]], time_enabled, time_running);
+    };
+
+    sample.cycles = value(CYCLES);
+    sample.instructions = value(INSTRUCTIONS);
+    sample.cache_misses = value(CACHE_MISSES);
+    sample.branch_misses = value(BRANCH_MISSES);
+    return true;
+#else
+    (void)sample;
+    return false;
+#endif
+}
+
+StageProfiler::Scope::Scope(StageProfiler* profiler, const char* stage)
+    : profiler_(profiler)
+    , stage_(stage)
+    , has_counters_(false)
+{
+    if (profiler_) {
+        has_counters_ = profiler_->beginCounters(start_counters_);
+        start_time_ = std::chrono::steady_clock::now();
+    }
+}
+
+StageProfiler::Scope::~Scope() {
+    if (profiler_) {
+        double wall_ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start_time_).count();
+        profiler_->record(stage_, wall_ms, has_counters_ ? &start_counters_ : nullptr);
+    }
+}
+
+StageProfiler::StageProfiler(bool use_hardware_counters)
+    : use_hardware_counters_(use_hardware_counters)
+    , counters_tried_(false)
+    , multiple_threads_(false)
+    , frames_(0)
+{
+}
+
+bool StageProfiler::beginCounters(PerfSample& sample) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!use_hardware_counters_) {
+            return false;
+        }
+        // Counters count the thread that opens them, so open on first use
+        if (!counters_tried_) {
+            counters_tried_ = true;
+            counter_thread_ = std::this_thread::get_id();
+            counters_.open();
+        }
+        // One thread's counts divided by every thread's frames would be wrong, so a second thread
+        // turns the counters off for good
+        if (std::this_thread::get_id() != counter_thread_) {
+            multiple_threads_ = true;
+        }
+        if (!counters_.isAvailable() || multiple_threads_) {
+            return false;
+        }
+    }
+    return counters_.read(sample);
+}
+
+void StageProfiler::record(const char* stage, double wall_ms, const PerfSample* start) {
+    PerfSample end;
+    bool has_counters = start && counters_.read(end);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    has_counters = has_counters && !multiple_threads_;
+    auto it = std::find_if(stages_.begin(), stages_.end(),
+                           [stage](const std::pair<std::string, StageTotals>& entry) { return entry.first == stage; });
+    if (it == stages_.end()) {
+        stages_.emplace_back(stage, StageTotals());
+        it = stages_.end() - 1;
+    }
+
+    StageTotals& totals = it->second;
+    totals.calls++;
+    totals.wall_ms += wall_ms;
+    if (has_counters) {
+        totals.counters.cycles += delta(end.cycles, start->cycles);
+        totals.counters.instructions += delta(end.instructions, start->instructions);
+        totals.counters.cache_misses += delta(end.cache_misses, start->cache_misses);
+        totals.counters.branch_misses += delta(end.branch_misses, start->branch_misses);
+    }
+}
+
+void StageProfiler::endFrame() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    frames_++;
+}
+
+bool StageProfiler::hasHardwareCounters() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return counters_.isAvailable() && !multiple_threads_;
+}
+
+std::string StageProfiler::getReport() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::ostringstream oss;
+
+    oss << "Stage Profile (" << frames_ << " frames):\n";
+    bool counters = counters_.isAvailable() && !multiple_threads_;
+    if (!use_hardware_counters_) {
+        oss << "  Hardware counters: disabled (wall-clock only)\n";
+    } else if (multiple_threads_) {
+        oss << "  Hardware counters: off - stages measured from more than one thread (wall-clock only)\n";
+    } else if (!counters) {
+        oss << "  Hardware counters: unavailable - "
+            << (counters_tried_ ? counters_.getUnavailableReason() : "no stage measured yet") << "\n";
+    } else {
+        // Counters are per thread: work OpenCV hands to the worker pool is in the wall time but not the counts
+        oss << "  Hardware counters: detecting thread only (worker pool threads not counted)\n";
+    }
+
+    double frames = frames_ > 0 ? static_cast<double>(frames_) : 1.0;
+    oss << std::fixed;
+    for (const auto& [name, totals] : stages_) {
+        oss << "  " << std::left << std::setw(14) << name << std::right
+            << std::setprecision(1) << std::setw(7) << totals.calls / frames << " calls/frame "
+            << std::setprecision(3) << std::setw(8) << totals.wall_ms / frames << " ms/frame";
+        if (counters) {
+            const PerfSample& c = totals.counters;
+            double ipc = c.cycles > 0 ? static_cast<double>(c.instructions) / c.cycles : 0.0;
+            oss << std::setprecision(0)
+                << std::setw(12) << c.cycles / frames << " cycles/frame"
+                << std::setprecision(2) << "  IPC " << ipc
+                << std::setprecision(0)
+                << std::setw(10) << c.cache_misses / frames << " cache-miss/frame"
+                << std::setw(10) << c.branch_misses / frames << " branch-miss/frame";
+        }
+        oss << "\n";
+    }
+    return oss.str();
+}
+
+void StageProfiler::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stages_.clear();
+    frames_ = 0;
+}
+
+} // namespace CodiceCam
@@ -0,0 +1,174 @@
+#include "QuadApprox.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace CodiceCam {
+
+namespace {
+    // Points per deviation block; the early exit is checked once per block
+    const int DEVIATION_BLOCK = 64;
+
+    inline int cross(const cv::Point& origin, const cv::Point& direction, const cv::Point& p) {
+        return direction.x * (p.y - origin.y) - direction.y * (p.x - origin.x);
+    }
+
+    // Scans forward from the point after start, wrapping, so ties resolve as in cv::approxPolyDP
+    int farthestFrom(const cv::Point* points, int count, int start) {
+        const cv::Point& from = points[start];
+        int best = start;
+        int best_distance = -1;
+        for (int j = 1; j < count; j++) {
+            int i = start + j < count ? start + j : start + j - count;
+            int dx = points[i].x - from.x;
+            int dy = points[i].y - from.y;
+            int distance = dx * dx + dy * dy;
+            if (distance > best_distance) {
+                best_distance = distance;
+                best = i;
+            }
+        }
+        return best;
+    }
+
+    // Largest |cross| from the line through origin along direction
+    int farthestFromLine(const cv::Point* points, int count, const cv::Point& origin, const cv::Point& direction,
+                         int& best_cross) {
+        int best = 0;
+        best_cross = -1;
+        for (int i = 0; i < count; i++) {
+            int value = std::abs(cross(origin, direction, points[i]));
+            if (value > best_cross) {
+                best_cross = value;
+                best = i;
+            }
+        }
+        return best;
+    }
+
+    // Largest cross on the given side (sign) of the line through origin along direction
+    int farthestOutside(const cv::Point* points, int count, const cv::Point& origin, const cv::Point& direction,
+                        int sign, int& best_cross) {
+        int best = 0;
+        best_cross = 0;
+        for (int i = 0; i < count; i++) {
+            int value = sign * cross(origin, direction, points[i]);
+            if (value > best_cross) {
+                best_cross = value;
+                best = i;
+            }
+        }
+        return best;
+    }
+
+    double length(const cv::Point& v) {
+        return std::sqrt(static_cast<double>(v.x) * v.x + static_cast<double>(v.y) * v.y);
+    }
+
+    // Every point in [begin, end) within limit (in cross units) of the line
+    bool withinDeviation(const cv::Point* points, int begin, int end, const cv::Point& origin,
+                         const cv::Point& direction, int limit) {
+        for (int block = begin; block < end; block += DEVIATION_BLOCK) {
+            int stop = std::min(block + DEVIATION_BLOCK, end);
+            int worst = 0;
+            for (int i = block; i < stop; i++) {
+                worst = std::max(worst, std::abs(cross(origin, direction, points[i])));
+            }
+            if (worst > limit) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+bool QuadApprox::approximate(const cv::Point* points, int count, double epsilon, cv::Point corners[4]) {
+    if (!points || count < 4) {
+        return false;
+    }
+
+    // Diagonal (or longest edge) A-B
+    int a = farthestFrom(points, count, 0);
+    int b = farthestFrom(points, count, a);
+    cv::Point ab = points[b] - points[a];
+    double ab_length = length(ab);
+    if (ab_length <= epsilon) {
+        return false;
+    }
+
+    // Third corner: farthest from A-B; it must stand out of the line like a Douglas-Peucker split
+    int c_cross;
+    int c = farthestFromLine(points, count, points[a], ab, c_cross);
+    if (c_cross <= epsilon * ab_length) {
+        return false;
+    }
+
+    // Fourth corner: farthest outside triangle ABC, over its three edges
+    int outward = cross(points[a], ab, points[c]) > 0 ? -1 : 1;
+    const int triangle[4] = {a, b, c, a};
+    int d = -1;
+    double d_distance = 0.0;
+    for (int edge = 0; edge < 3; edge++) {
+        const cv::Point& origin = points[triangle[edge]];
+        cv::Point direction = points[triangle[edge + 1]] - origin;
+        double edge_length = length(direction);
+        if (edge_length <= 0.0) {
+            continue;
+        }
+        int edge_cross;
+        int candidate = farthestOutside(points, count, origin, direction, outward, edge_cross);
+        double distance = edge_cross / edge_length;
+        if (distance > d_distance) {
+            d_distance = distance;
+            d = candidate;
+        }
+    }
+    if (d < 0 || d_distance <= epsilon) {
+        return false;
+    }
+
+    // Corners in contour order
+    int indices[4] = {a, b, c, d};
+    std::sort(indices, indices + 4);
+    for (int i = 1; i < 4; i++) {
+        if (indices[i] == indices[i - 1]) {
+            return false;
+        }
+    }
+
+    // Every contour point must lie within epsilon of the edge it belongs to
+    for (int i = 0; i < 4; i++) {
+        const cv::Point& origin = points[indices[i]];
+        const cv::Point& target = points[indices[(i + 1) % 4]];
+        cv::Point direction = target - origin;
+        int limit = static_cast<int>(std::floor(epsilon * length(direction)));
+
+        bool within;
+        if (i < 3) {
+            within = withinDeviation(points, indices[i] + 1, indices[i + 1], origin, direction, limit);
+        } else {
+            // The closing edge wraps around the end of the contour
+            within = withinDeviation(points, indices[3] + 1, count, origin, direction, limit) &&
+                     withinDeviation(points, 0, indices[0], origin, direction, limit);
+        }
+        if (!within) {
+            return false;
+        }
+    }
+
+    // cv::approxPolyDP emits a closed contour starting at its first split point, B
+    int first = 0;
+    while (indices[first] != b) {
+        first++;
+    }
+    for (int i = 0; i < 4; i++) {
+        corners[i] = points[indices[(first + i) % 4]];
+    }
+    return true;
+}
+
+bool QuadApprox::approximate(const std::vector<cv::Point>& contour, double epsilon, cv::Point corners[4]) {
+    return approximate(contour.data(), static_cast<int>(contour.size()), epsilon, corners);
+}
+
+} // namespace CodiceCam
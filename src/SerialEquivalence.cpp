@@ -0,0 +1,204 @@
+#include "SerialEquivalence.h"
+#include "FrameDataset.h"
+#include "FrameParallelDetector.h"
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+
+namespace CodiceCam {
+
+namespace {
+    // Differences kept in the report; the rest are only counted
+    const size_t MAX_REPORTED_DIFFERENCES = 50;
+
+    const float DEGREES_TO_RADIANS = 3.14159265358979f / 180.0f;
+
+    // TUIO tuple as test_live_camera sends it to TUIOBridge
+    struct TuioTuple {
+        int id;
+        float x;
+        float y;
+        float angle;
+    };
+
+    TuioTuple toTuio(const CodiceMarker& marker, const cv::Mat& frame) {
+        return {marker.id, marker.center.x / frame.cols, marker.center.y / frame.rows,
+                marker.angle * DEGREES_TO_RADIANS};
+    }
+}
+
+SerialEquivalenceChecker::SerialEquivalenceChecker()
+    : min_marker_size_(40)
+    , max_marker_size_(200)
+    , min_confidence_(0.7)
+{
+}
+
+bool SerialEquivalenceChecker::loadDataset(const std::string& path) {
+    return FrameDataset::load(path, frames_);
+}
+
+void SerialEquivalenceChecker::addFrame(const cv::Mat& frame) {
+    frames_.push_back(frame.clone());
+}
+
+size_t SerialEquivalenceChecker::getFrameCount() const {
+    return frames_.size();
+}
+
+void SerialEquivalenceChecker::setDetectionParams(int min_marker_size, int max_marker_size, double min_confidence) {
+    min_marker_size_ = min_marker_size;
+    max_marker_size_ = max_marker_size;
+    min_confidence_ = min_confidence;
+}
+
+EquivalenceReport SerialEquivalenceChecker::run(int contexts) {
+    EquivalenceReport report;
+    if (frames_.empty()) {
+        std::cerr << "❌ No frames to replay" << std::endl;
+        return report;
+    }
+
+    std::vector<std::vector<CodiceMarker>> serial;
+    std::vector<std::vector<CodiceMarker>> parallel;
+    if (!runSerial(serial) || !runParallel(contexts, parallel)) {
+        return report;
+    }
+
+    report.frames = frames_.size();
+    for (size_t i = 0; i < frames_.size(); i++) {
+        report.serial_markers += serial[i].size();
+        report.parallel_markers += parallel[i].size();
+        compareFrame(i, serial[i], parallel[i], report);
+    }
+    return report;
+}
+
+std::unique_ptr<MarkerDetector> SerialEquivalenceChecker::createDetector() const {
+    auto detector = std::make_unique<MarkerDetector>();
+    detector->setDebugMode(false);
+    detector->setVerboseMode(false);
+    detector->setDetectionParams(min_marker_size_, max_marker_size_, min_confidence_);
+    detector->setDeterministicMode(true);
+    return detector;
+}
+
+bool SerialEquivalenceChecker::runSerial(std::vector<std::vector<CodiceMarker>>& results) {
+    auto detector = createDetector();
+
+    // Serial reference: OpenCV's own parallel loops on the calling thread only
+    int threads = cv::getNumThreads();
+    cv::setNumThreads(1);
+
+    results.assign(frames_.size(), std::vector<CodiceMarker>());
+    size_t failed = 0;
+    for (size_t i = 0; i < frames_.size(); i++) {
+        if (!detector->detectMarkers(frames_[i], results[i])) {
+            results[i].clear();
+            failed++;
+        }
+    }
+
+    cv::setNumThreads(threads);
+    if (failed > 0) {
+        std::cout << "⚠️ Serial run: detection failed on " << failed << " frames" << std::endl;
+    }
+    return true;
+}
+
+bool SerialEquivalenceChecker::runParallel(int contexts, std::vector<std::vector<CodiceMarker>>& results) {
+    ParallelDetectionConfig config;
+    config.contexts = contexts;
+    config.deterministic = true;
+    FrameParallelDetector parallel_detector(config);
+
+    std::vector<std::unique_ptr<MarkerDetector>> detectors;
+    for (int i = 0; i < parallel_detector.getContextCount(); i++) {
+        detectors.push_back(createDetector());
+    }
+
+    auto detect = [&](int context, const cv::Mat& frame, const FrameInfo& info, std::vector<CodiceMarker>& markers) {
+        return detectors[context]->detectMarkers(FrameInput::fromCamera(frame, info.capture_time), markers);
+    };
+
+    // Commits arrive in submission order, one at a time
+    results.assign(frames_.size(), std::vector<CodiceMarker>());
+    auto commit = [&](const cv::Mat&, const FrameInfo& info, const std::vector<CodiceMarker>& markers) {
+        results[info.sequence] = markers;
+        return FrameStatus::DELIVERED;
+    };
+
+    if (!parallel_detector.start(detect, commit, nullptr)) {
+        std::cerr << "❌ Failed to start parallel run" << std::endl;
+        return false;
+    }
+
+    for (size_t i = 0; i < frames_.size(); i++) {
+        FrameInfo info;
+        info.sequence = i;
+        info.capture_time = std::chrono::steady_clock::now();
+        parallel_detector.submit(frames_[i], info);
+    }
+    parallel_detector.drain();
+    parallel_detector.stop();
+
+    std::cout << parallel_detector.getStatistics();
+    return true;
+}
+
+void SerialEquivalenceChecker::compareFrame(size_t index, const std::vector<CodiceMarker>& serial,
+                                            const std::vector<CodiceMarker>& parallel, EquivalenceReport& report) const {
+    std::vector<std::string> differences;
+
+    if (serial.size() != parallel.size()) {
+        std::ostringstream oss;
+        oss << "frame " << index << ": " << serial.size() << " markers serial, " << parallel.size() << " parallel";
+        differences.push_back(oss.str());
+    }
+
+    for (size_t m = 0; m < std::min(serial.size(), parallel.size()); m++) {
+        const CodiceMarker& a = serial[m];
+        const CodiceMarker& b = parallel[m];
+        std::ostringstream oss;
+        oss << "frame " << index << " marker " << m << ": ";
+
+        if (a.id != b.id) {
+            oss << "id " << a.id << " serial, " << b.id << " parallel";
+            differences.push_back(oss.str());
+            continue;
+        }
+        if (a.corners != b.corners) {
+            oss << "id " << a.id << " corners differ";
+            for (size_t c = 0; c < std::min(a.corners.size(), b.corners.size()); c++) {
+                if (a.corners[c] != b.corners[c]) {
+                    oss << " (corner " << c << ": " << a.corners[c].x << "," << a.corners[c].y << " serial, "
+                        << b.corners[c].x << "," << b.corners[c].y << " parallel)";
+                    break;
+                }
+            }
+            differences.push_back(oss.str());
+            continue;
+        }
+
+        TuioTuple ta = toTuio(a, frames_[index]);
+        TuioTuple tb = toTuio(b, frames_[index]);
+        if (ta.x != tb.x || ta.y != tb.y || ta.angle != tb.angle) {
+            oss << "id " << a.id << " TUIO (" << ta.x << ", " << ta.y << ", " << ta.angle << ") serial, ("
+                << tb.x << ", " << tb.y << ", " << tb.angle << ") parallel";
+            differences.push_back(oss.str());
+        }
+    }
+
+    if (differences.empty()) {
+        return;
+    }
+    report.mismatched_frames++;
+    for (const auto& difference : differences) {
+        if (report.differences.size() >= MAX_REPORTED_DIFFERENCES) {
+            break;
+        }
+        report.differences.push_back(difference);
+    }
+}
+
+} // namespace CodiceCam
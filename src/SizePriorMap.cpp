@@ -0,0 +1,308 @@
+#include "SizePriorMap.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace CodiceCam {
+
+namespace {
+    enum Sum { UU, UV, U, VV, V, N, US, VS, S, SUM_COUNT };
+
+    // Determinants below this (relative to n^3) mean the samples do not span the table
+    const double MIN_RELATIVE_DETERMINANT = 1e-6;
+
+    double det3(double a, double b, double c, double d, double e, double f, double g, double h, double i) {
+        return a * (e * i - f * h) - b * (d * i - f * g) + c * (d * h - e * g);
+    }
+}
+
+SizePriorMap::SizePriorMap(const SizePriorConfig& config)
+    : config_(config)
+    , plane_valid_(false)
+    , checked_(0)
+    , rejected_(0)
+    , explored_(0)
+{
+    config_.grid_cols = std::max(1, config_.grid_cols);
+    config_.grid_rows = std::max(1, config_.grid_rows);
+    resetLocked();
+}
+
+void SizePriorMap::setImageSize(const cv::Size& size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (size == image_size_) {
+        return;
+    }
+    if (image_size_.area() > 0) {
+        std::cout << "⚠️ Image size changed to " << size.width << "x" << size.height << ", size prior reset" << std::endl;
+    }
+    image_size_ = size;
+    resetLocked();
+}
+
+void SizePriorMap::observe(const cv::Point2f& center, double size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int index = cellIndexLocked(center);
+    if (index < 0 || size <= 0.0) {
+        return;
+    }
+
+    // Running mean while warming up, then an exponential average that follows slow drift
+    Cell& cell = cells_[index];
+    cell.samples++;
+    double weight = std::max(config_.learning_rate, 1.0 / static_cast<double>(cell.samples));
+    cell.size += weight * (size - cell.size);
+
+    // Seen range: widened at once by any sample, then decaying back toward the average
+    if (cell.samples == 1) {
+        cell.min_size = size;
+        cell.max_size = size;
+    } else {
+        cell.min_size = std::min(size, cell.min_size + config_.learning_rate * (cell.size - cell.min_size));
+        cell.max_size = std::max(size, cell.max_size + config_.learning_rate * (cell.size - cell.max_size));
+    }
+
+    double u = center.x / image_size_.width;
+    double v = center.y / image_size_.height;
+    sums_[UU] += u * u;
+    sums_[UV] += u * v;
+    sums_[U] += u;
+    sums_[VV] += v * v;
+    sums_[V] += v;
+    sums_[N] += 1.0;
+    sums_[US] += u * size;
+    sums_[VS] += v * size;
+    sums_[S] += size;
+    solvePlaneLocked();
+}
+
+bool SizePriorMap::accepts(const cv::Point2f& center, double size) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    checked_++;
+    double min_size, max_size;
+    if (!acceptedRangeLocked(center, min_size, max_size) || (size >= min_size && size <= max_size)) {
+        return true;
+    }
+
+    // Let an occasional out-of-range candidate through; if it decodes, the cell learns its size
+    uint64_t& rejections = cell_rejections_[cellIndexLocked(center)];
+    rejections++;
+    if (config_.explore_interval > 0 && rejections % config_.explore_interval == 0) {
+        explored_++;
+        return true;
+    }
+    rejected_++;
+    return false;
+}
+
+bool SizePriorMap::expectedSize(const cv::Point2f& center, double& size) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return expectedSizeLocked(center, size);
+}
+
+void SizePriorMap::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    resetLocked();
+}
+
+bool SizePriorMap::saveToFile(const std::string& filename) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "❌ Failed to open size prior file for writing: " << filename << std::endl;
+        return false;
+    }
+
+    file << "# CodiceCam marker size prior\n";
+    file << "size_prior " << image_size_.width << " " << image_size_.height << " "
+         << config_.grid_cols << " " << config_.grid_rows << "\n";
+    file << "plane";
+    for (int i = 0; i < SUM_COUNT; i++) {
+        file << " " << sums_[i];
+    }
+    file << "\n";
+    for (int row = 0; row < config_.grid_rows; row++) {
+        for (int col = 0; col < config_.grid_cols; col++) {
+            const Cell& cell = cells_[row * config_.grid_cols + col];
+            if (cell.samples > 0) {
+                file << "cell " << col << " " << row << " " << cell.size << " " << cell.samples << " "
+                     << cell.min_size << " " << cell.max_size << "\n";
+            }
+        }
+    }
+
+    std::cout << "📝 Size prior saved to " << filename << std::endl;
+    return true;
+}
+
+bool SizePriorMap::loadFromFile(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "❌ Failed to open size prior file: " << filename << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    bool has_header = false;
+    std::string line;
+    int line_number = 0;
+    while (std::getline(file, line)) {
+        line_number++;
+        line.erase(0, line.find_first_not_of(" \t"));
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        std::istringstream iss(line);
+        std::string keyword;
+        iss >> keyword;
+        if (keyword == "size_prior") {
+            cv::Size size;
+            int cols, rows;
+            if (!(iss >> size.width >> size.height >> cols >> rows) || cols < 1 || rows < 1) {
+                std::cerr << "❌ Malformed size prior header on line " << line_number << std::endl;
+                return false;
+            }
+            image_size_ = size;
+            config_.grid_cols = cols;
+            config_.grid_rows = rows;
+            resetLocked();
+            has_header = true;
+        } else if (keyword == "plane" && has_header) {
+            for (int i = 0; i < SUM_COUNT; i++) {
+                iss >> sums_[i];
+            }
+            solvePlaneLocked();
+        } else if (keyword == "cell" && has_header) {
+            int col, row;
+            Cell cell;
+            if (!(iss >> col >> row >> cell.size >> cell.samples) ||
+                col < 0 || col >= config_.grid_cols || row < 0 || row >= config_.grid_rows) {
+                std::cerr << "⚠️  Skipping malformed size prior cell on line " << line_number << std::endl;
+                continue;
+            }
+            // Files from before the seen range was kept: start the range at the average
+            if (!(iss >> cell.min_size >> cell.max_size)) {
+                cell.min_size = cell.size;
+                cell.max_size = cell.size;
+            }
+            cells_[row * config_.grid_cols + col] = cell;
+        } else {
+            std::cerr << "⚠️  Skipping unknown size prior line " << line_number << std::endl;
+        }
+    }
+
+    if (!has_header) {
+        std::cerr << "❌ Size prior file has no header: " << filename << std::endl;
+        return false;
+    }
+    std::cout << "✅ Size prior loaded from " << filename << " (" << static_cast<uint64_t>(sums_[N]) << " samples)" << std::endl;
+    return true;
+}
+
+std::string SizePriorMap::getStatistics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t learned_cells = 0;
+    for (const Cell& cell : cells_) {
+        if (cell.samples >= static_cast<uint64_t>(config_.min_cell_samples)) {
+            learned_cells++;
+        }
+    }
+
+    std::ostringstream oss;
+    oss << "Size Prior:\n";
+    oss << "  Samples: " << static_cast<uint64_t>(sums_[N]) << "\n";
+    oss << "  Learned cells: " << learned_cells << " / " << cells_.size()
+        << (plane_valid_ ? " (plane fit active)" : "") << "\n";
+    oss << "  Candidates rejected: " << rejected_ << " / " << checked_ << " (" << explored_
+        << " out-of-range let through to relearn)\n";
+    return oss.str();
+}
+
+int SizePriorMap::cellIndexLocked(const cv::Point2f& center) const {
+    if (image_size_.width <= 0 || image_size_.height <= 0) {
+        return -1;
+    }
+    int col = static_cast<int>(center.x * config_.grid_cols / image_size_.width);
+    int row = static_cast<int>(center.y * config_.grid_rows / image_size_.height);
+    col = std::min(std::max(col, 0), config_.grid_cols - 1);
+    row = std::min(std::max(row, 0), config_.grid_rows - 1);
+    return row * config_.grid_cols + col;
+}
+
+bool SizePriorMap::expectedSizeLocked(const cv::Point2f& center, double& size) const {
+    int index = cellIndexLocked(center);
+    if (index < 0) {
+        return false;
+    }
+
+    const Cell& cell = cells_[index];
+    if (cell.samples >= static_cast<uint64_t>(config_.min_cell_samples)) {
+        size = cell.size;
+        return true;
+    }
+
+    if (plane_valid_) {
+        double u = center.x / image_size_.width;
+        double v = center.y / image_size_.height;
+        size = plane_[0] * u + plane_[1] * v + plane_[2];
+        return size > 0.0;
+    }
+    return false;
+}
+
+bool SizePriorMap::acceptedRangeLocked(const cv::Point2f& center, double& min_size, double& max_size) const {
+    int index = cellIndexLocked(center);
+    if (index < 0) {
+        return false;
+    }
+
+    const Cell& cell = cells_[index];
+    if (cell.samples >= static_cast<uint64_t>(config_.min_cell_samples)) {
+        double scale = 1.0 + config_.tolerance;
+        min_size = cell.min_size / scale;
+        max_size = cell.max_size * scale;
+        return true;
+    }
+
+    // Extrapolated from other cells: only reject sizes far from the plane
+    double expected;
+    if (!expectedSizeLocked(center, expected)) {
+        return false;
+    }
+    double scale = 1.0 + config_.plane_tolerance;
+    min_size = expected / scale;
+    max_size = expected * scale;
+    return true;
+}
+
+void SizePriorMap::solvePlaneLocked() {
+    plane_valid_ = false;
+    double n = sums_[N];
+    if (n < config_.min_fit_samples) {
+        return;
+    }
+
+    const double* m = sums_;
+    double det = det3(m[UU], m[UV], m[U], m[UV], m[VV], m[V], m[U], m[V], m[N]);
+    if (std::fabs(det) < MIN_RELATIVE_DETERMINANT * n * n * n) {
+        return;  // Samples on a line or a point: no plane yet
+    }
+
+    plane_[0] = det3(m[US], m[UV], m[U], m[VS], m[VV], m[V], m[S], m[V], m[N]) / det;
+    plane_[1] = det3(m[UU], m[US], m[U], m[UV], m[VS], m[V], m[U], m[S], m[N]) / det;
+    plane_[2] = det3(m[UU], m[UV], m[US], m[UV], m[VV], m[VS], m[U], m[V], m[S]) / det;
+    plane_valid_ = true;
+}
+
+void SizePriorMap::resetLocked() {
+    cells_.assign(static_cast<size_t>(config_.grid_cols) * config_.grid_rows, Cell());
+    cell_rejections_.assign(cells_.size(), 0);
+    std::fill(sums_, sums_ + SUM_COUNT, 0.0);
+    std::fill(plane_, plane_ + 3, 0.0);
+    plane_valid_ = false;
+}
+
+} // namespace CodiceCam
@@ -4,14 +4,46 @@
 #include <algorithm>
 #include <set>
 #include <iomanip>
+#include <cmath>
 
 // Include TUIO headers
 #include "TuioServer.h"
 #include "TuioObject.h"
 #include "TuioTime.h"
 
+// oscpack sockets for the compact binary stream
+#include "ip/UdpSocket.h"
+#include "ip/IpEndpointName.h"
+#include "ip/PacketListener.h"
+
 namespace CodiceCam {
 
+namespace {
+    // Frame budget priority: surface widths of error per radian of rotation, and per frame unsent
+    const double ANGLE_ERROR_WEIGHT = 0.05;
+    const double REFRESH_WEIGHT = 0.0005;
+    const double TWO_PI = 6.283185307179586;
+}
+
+/**
+ * @brief Receives keyframe ACKs for the compact binary stream
+ */
+class BinaryStreamAckListener : public PacketListener {
+public:
+    BinaryStreamAckListener(MarkerStreamEncoder& encoder, std::mutex& mutex)
+        : encoder_(encoder), mutex_(mutex) {}
+
+    void ProcessPacket(const char* data, int size, const IpEndpointName& remoteEndpoint) override {
+        (void)remoteEndpoint;
+        std::lock_guard<std::mutex> lock(mutex_);
+        encoder_.processAckPacket(reinterpret_cast<const uint8_t*>(data), static_cast<size_t>(size));
+    }
+
+private:
+    MarkerStreamEncoder& encoder_;
+    std::mutex& mutex_;
+};
+
 TUIOBridge::TUIOBridge()
     : tuio_server_(nullptr)
     , host_("localhost")
@@ -21,9 +53,14 @@ TUIOBridge::TUIOBridge()
     , total_objects_created_(0)
     , total_objects_updated_(0)
     , total_objects_removed_(0)
+    , total_updates_deferred_(0)
     , start_time_(std::chrono::steady_clock::now())
+    , lifecycle_history_limit_(10)
     , total_detected_(0)
     , total_lost_(0)
+    , total_updates_coalesced_(0)
+    , event_log_frames_(true)
+    , output_frame_(0)
 {
 }
 
@@ -67,6 +104,14 @@ bool TUIOBridge::start() {
         running_ = true;
         start_time_ = std::chrono::steady_clock::now();
         
+        if (!startBinaryStream()) {
+            std::cerr << "⚠️  Binary stream unavailable, continuing with TUIO only" << std::endl;
+        }
+        
+        for (auto& sink : zone_sinks_) {
+            sink->start();
+        }
+        
         std::cout << "🚀 TUIO server started on " << host_ << ":" << port_ << std::endl;
         return true;
         
@@ -87,6 +132,11 @@ void TUIOBridge::stop() {
             active_objects_.clear();
             last_markers_.clear();
             
+            for (auto& sink : zone_sinks_) {
+                sink->stop();
+            }
+            
+            stopBinaryStream();
             running_ = false;
             
             std::cout << "🛑 TUIO server stopped" << std::endl;
@@ -102,6 +152,47 @@ void TUIOBridge::updateMarkers(const std::vector<CodiceMarker>& markers) {
         return;
     }
     
+    if (zone_sinks_.empty()) {
+        commitMarkers(markers);
+    } else {
+        std::vector<CodiceMarker> unzoned;
+        routeToZones(markers, unzoned);
+        commitMarkers(unzoned);
+    }
+    
+    bool log_frame = event_log_ && event_log_frames_;
+    if (log_frame || history_store_) {
+        frame_markers_.clear();
+        for (const auto& marker : markers) {
+            StreamMarker logged;
+            logged.id = marker.id;
+            logged.x = marker.x;
+            logged.y = marker.y;
+            logged.angle = marker.angle;
+            logged.confidence = static_cast<float>(marker.confidence);
+            frame_markers_.push_back(logged);
+        }
+        if (log_frame) {
+            event_log_->logFrame(frame_markers_.data(), frame_markers_.size());
+        }
+        if (history_store_) {
+            int64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+            history_store_->appendFrame(now_ms, frame_markers_.data(), frame_markers_.size());
+        }
+    }
+    
+    // Mirror the full frame on the compact binary stream
+    if (binary_encoder_) {
+        try {
+            sendBinaryFrame(markers);
+        } catch (const std::exception& e) {
+            std::cerr << "❌ Error sending binary frame: " << e.what() << std::endl;
+        }
+    }
+}
+
+void TUIOBridge::commitMarkers(const std::vector<CodiceMarker>& markers) {
     try {
         // Clean up expired markers first
         cleanupExpiredMarkers();
@@ -114,6 +205,10 @@ void TUIOBridge::updateMarkers(const std::vector<CodiceMarker>& markers) {
         
         // Initialize frame
         tuio_server_->initFrame(TUIO::TuioTime::getSessionTime());
+        output_frame_++;
+        int budget_bytes = config_manager_.getConfig().frame_budget_bytes;
+        size_t added_count = 0;
+        pending_updates_.clear();
         
         // Update existing markers and add new ones
         for (const auto& marker : markers) {
@@ -133,6 +228,8 @@ void TUIOBridge::updateMarkers(const std::vector<CodiceMarker>& markers) {
                 if (obj) {
                     active_objects_[session_id] = obj;
                     total_objects_created_++;
+                    added_count++;
+                    sent_states_[marker.id] = {marker.x, marker.y, marker.angle, output_frame_};
                     
                     // Handle lifecycle: DETECTED
                     CodiceMarker lifecycle_marker = marker;
@@ -142,21 +239,28 @@ void TUIOBridge::updateMarkers(const std::vector<CodiceMarker>& markers) {
                     handleStateTransition(marker.id, MarkerState::DETECTED, lifecycle_marker);
                 }
             } else {
-                // Update existing object
+                // Update existing object (deferred to the frame budget when one is set)
                 auto obj = active_objects_[session_id];
-                tuio_server_->updateTuioObject(obj, marker.x, marker.y, marker.angle);
-                total_objects_updated_++;
+                if (budget_bytes > 0) {
+                    pending_updates_.push_back({obj, &marker, updatePriority(marker)});
+                } else {
+                    sendUpdate(obj, marker);
+                }
                 
-                // Handle lifecycle: UPDATED
-                CodiceMarker lifecycle_marker = marker;
-                lifecycle_marker.state = MarkerState::UPDATED;
-                auto last_marker_it = last_markers_.find(marker.id);
-                if (last_marker_it != last_markers_.end()) {
-                    lifecycle_marker.update_count = last_marker_it->second.update_count + 1;
+                // Handle lifecycle: UPDATED (coalesced)
+                if (isUpdateEventDue(marker, std::chrono::steady_clock::now())) {
+                    CodiceMarker lifecycle_marker = marker;
+                    lifecycle_marker.state = MarkerState::UPDATED;
+                    auto last_marker_it = last_markers_.find(marker.id);
+                    if (last_marker_it != last_markers_.end()) {
+                        lifecycle_marker.update_count = last_marker_it->second.update_count + 1;
+                    } else {
+                        lifecycle_marker.update_count = 1;
+                    }
+                    handleStateTransition(marker.id, MarkerState::UPDATED, lifecycle_marker);
                 } else {
-                    lifecycle_marker.update_count = 1;
+                    total_updates_coalesced_++;
                 }
-                handleStateTransition(marker.id, MarkerState::UPDATED, lifecycle_marker);
             }
             
             // Update last seen time and state
@@ -212,9 +316,15 @@ void TUIOBridge::updateMarkers(const std::vector<CodiceMarker>& markers) {
             
             tuio_server_->removeTuioObject(obj);
             active_objects_.erase(session_id);
+            sent_states_.erase(marker_id);
+            notified_states_.erase(marker_id);
             total_objects_removed_++;
         }
         
+        if (budget_bytes > 0) {
+            sendBudgetedUpdates(budget_bytes, added_count);
+        }
+        
         // Commit the frame
         tuio_server_->commitFrame();
         
@@ -223,6 +333,45 @@ void TUIOBridge::updateMarkers(const std::vector<CodiceMarker>& markers) {
     }
 }
 
+void TUIOBridge::sendUpdate(TUIO::TuioObject* object, const CodiceMarker& marker) {
+    tuio_server_->updateTuioObject(object, marker.x, marker.y, marker.angle);
+    total_objects_updated_++;
+    sent_states_[marker.id] = {marker.x, marker.y, marker.angle, output_frame_};
+}
+
+double TUIOBridge::updatePriority(const CodiceMarker& marker) const {
+    auto it = sent_states_.find(marker.id);
+    if (it == sent_states_.end()) {
+        return HUGE_VAL;
+    }
+    const SentState& sent = it->second;
+    double dx = marker.x - sent.x;
+    double dy = marker.y - sent.y;
+    double da = std::remainder(static_cast<double>(marker.angle) - sent.angle, TWO_PI);
+    double error = std::sqrt(dx * dx + dy * dy) + ANGLE_ERROR_WEIGHT * std::fabs(da);
+    return error + REFRESH_WEIGHT * static_cast<double>(output_frame_ - sent.frame);
+}
+
+void TUIOBridge::sendBudgetedUpdates(int budget_bytes, size_t added_count) {
+    // Alive list, fseq and adds are sent regardless; updates share what is left (at least one)
+    size_t fixed_bytes = MarkerStream::tuio11BundleBytes(active_objects_.size(), added_count);
+    size_t update_bytes = MarkerStream::tuio11SetMessageBytes();
+    size_t slots = static_cast<size_t>(budget_bytes) > fixed_bytes
+        ? (static_cast<size_t>(budget_bytes) - fixed_bytes) / update_bytes : 0;
+    slots = std::max<size_t>(slots, 1);
+    
+    if (pending_updates_.size() > slots) {
+        std::nth_element(pending_updates_.begin(), pending_updates_.begin() + slots, pending_updates_.end(),
+                         [](const PendingUpdate& a, const PendingUpdate& b) { return a.priority > b.priority; });
+        total_updates_deferred_ += pending_updates_.size() - slots;
+        pending_updates_.resize(slots);
+    }
+    for (const auto& update : pending_updates_) {
+        sendUpdate(update.object, *update.marker);
+    }
+    pending_updates_.clear();
+}
+
 bool TUIOBridge::isRunning() const {
     return running_;
 }
@@ -239,6 +388,9 @@ std::string TUIOBridge::getConfiguration() const {
 
 void TUIOBridge::setMarkerTimeout(int timeout_ms) {
     marker_timeout_ms_ = timeout_ms;
+    for (auto& sink : zone_sinks_) {
+        sink->setMarkerTimeout(timeout_ms);
+    }
 }
 
 std::string TUIOBridge::getStatistics() const {
@@ -252,6 +404,28 @@ std::string TUIOBridge::getStatistics() const {
     oss << "  Objects Created: " << total_objects_created_ << "\n";
     oss << "  Objects Updated: " << total_objects_updated_ << "\n";
     oss << "  Objects Removed: " << total_objects_removed_ << "\n";
+    if (config_manager_.getConfig().frame_budget_bytes > 0) {
+        oss << "  Updates Deferred (frame budget " << config_manager_.getConfig().frame_budget_bytes
+            << " bytes): " << total_updates_deferred_ << "\n";
+    }
+    
+    for (size_t z = 0; z < zone_sinks_.size(); z++) {
+        const auto& zone = zone_router_.getZone(z);
+        oss << "  Zone " << zone.name << " (" << zone.host << ":" << zone.port << "): "
+            << zone_sinks_[z]->getActiveMappings().size() << " active objects\n";
+    }
+    
+    if (event_log_ && event_log_frames_) {
+        oss << event_log_->getStatistics();
+    }
+    if (history_store_) {
+        oss << history_store_->getStatistics();
+    }
+    
+    std::lock_guard<std::mutex> lock(binary_mutex_);
+    if (binary_encoder_) {
+        oss << binary_encoder_->getStatistics();
+    }
     return oss.str();
 }
 
@@ -367,8 +541,191 @@ std::vector<std::string> TUIOBridge::getAvailableProfiles() const {
     return config_manager_.getConfig().getAvailableProfiles();
 }
 
+bool TUIOBridge::isBinaryStreamActive() const {
+    std::lock_guard<std::mutex> lock(binary_mutex_);
+    return binary_encoder_ != nullptr;
+}
+
+bool TUIOBridge::startBinaryStream() {
+    const auto& config = config_manager_.getConfig();
+    if (!config.enable_compression) {
+        return true;
+    }
+    
+    try {
+        std::lock_guard<std::mutex> lock(binary_mutex_);
+        binary_encoder_ = std::make_unique<MarkerStreamEncoder>(config.binary_keyframe_interval);
+        binary_encoder_->setAssumeDelivered(config.binary_ack_port == 0);
+        binary_socket_ = std::make_unique<UdpTransmitSocket>(
+            IpEndpointName(host_.c_str(), config.binary_stream_port));
+        
+        if (config.binary_ack_port > 0) {
+            binary_ack_listener_ = std::make_unique<BinaryStreamAckListener>(*binary_encoder_, binary_mutex_);
+            binary_ack_socket_ = std::make_unique<UdpListeningReceiveSocket>(
+                IpEndpointName(IpEndpointName::ANY_ADDRESS, config.binary_ack_port),
+                binary_ack_listener_.get());
+            binary_ack_thread_ = std::thread([this]() { binary_ack_socket_->Run(); });
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Error starting binary stream: " << e.what() << std::endl;
+        stopBinaryStream();
+        return false;
+    }
+    
+    std::cout << "📦 Binary marker stream on " << host_ << ":" << config.binary_stream_port
+              << (config.binary_ack_port > 0 ? " (ACKs on port " + std::to_string(config.binary_ack_port) + ")" : "")
+              << std::endl;
+    return true;
+}
+
+void TUIOBridge::stopBinaryStream() {
+    if (binary_ack_socket_) {
+        binary_ack_socket_->AsynchronousBreak();
+    }
+    if (binary_ack_thread_.joinable()) {
+        binary_ack_thread_.join();
+    }
+    
+    std::lock_guard<std::mutex> lock(binary_mutex_);
+    binary_ack_socket_.reset();
+    binary_ack_listener_.reset();
+    binary_socket_.reset();
+    binary_encoder_.reset();
+}
+
+void TUIOBridge::sendBinaryFrame(const std::vector<CodiceMarker>& markers) {
+    std::vector<StreamMarker> stream_markers;
+    stream_markers.reserve(markers.size());
+    for (const auto& marker : markers) {
+        if (!isValidCodiceId(marker.id) || !isValidCoordinates(marker.x, marker.y)) {
+            continue;
+        }
+        StreamMarker stream_marker;
+        stream_marker.id = marker.id;
+        stream_marker.x = marker.x;
+        stream_marker.y = marker.y;
+        stream_marker.angle = marker.angle;
+        stream_marker.confidence = static_cast<float>(marker.confidence);
+        stream_markers.push_back(stream_marker);
+    }
+    
+    auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start_time_).count();
+    
+    std::lock_guard<std::mutex> lock(binary_mutex_);
+    if (!binary_encoder_ || !binary_socket_) {
+        return;
+    }
+    const auto& packet = binary_encoder_->encode(stream_markers, static_cast<uint32_t>(elapsed_ms));
+    binary_socket_->Send(reinterpret_cast<const char*>(packet.data()), packet.size());
+}
+
+bool TUIOBridge::addZone(const TUIOZone& zone) {
+    // Zone sinks carry TUIO only; the binary stream stays on the main bridge
+    TUIOStreamingConfig sink_config = config_manager_.getConfig();
+    sink_config.host = zone.host;
+    sink_config.port = zone.port;
+    sink_config.enable_compression = false;
+    
+    auto sink = std::make_unique<TUIOBridge>();
+    if (!sink->setStreamingConfig(sink_config) || !sink->initialize(zone.host, zone.port)) {
+        std::cerr << "❌ Failed to create sink for zone '" << zone.name << "'" << std::endl;
+        return false;
+    }
+    
+    if (!zone_router_.addZone(zone)) {
+        return false;
+    }
+    
+    sink->setMarkerTimeout(marker_timeout_ms_);
+    sink->setLifecycleHistoryLimit(lifecycle_history_limit_);
+    sink->setLifecycleCallback(lifecycle_callback_);
+    sink->event_log_ = event_log_;
+    sink->event_log_frames_ = false;
+    if (running_) {
+        sink->start();
+    }
+    zone_sinks_.push_back(std::move(sink));
+    
+    std::cout << "🗺️  Zone '" << zone.name << "' -> " << zone.host << ":" << zone.port << std::endl;
+    return true;
+}
+
+bool TUIOBridge::loadZonesFromFile(const std::string& config_file) {
+    ZoneRouter loaded;
+    if (!loaded.loadFromFile(config_file)) {
+        return false;
+    }
+    
+    bool added = false;
+    for (size_t i = 0; i < loaded.getZoneCount(); i++) {
+        added = addZone(loaded.getZone(i)) || added;
+    }
+    return added;
+}
+
+void TUIOBridge::clearZones() {
+    for (auto& sink : zone_sinks_) {
+        sink->stop();
+    }
+    zone_sinks_.clear();
+    zone_router_.clearZones();
+}
+
+size_t TUIOBridge::getZoneCount() const {
+    return zone_router_.getZoneCount();
+}
+
+void TUIOBridge::setEventLog(std::shared_ptr<MarkerEventLog> event_log) {
+    event_log_ = event_log;
+    event_log_frames_ = true;
+    
+    // Sinks log their lifecycle events; the frame line already has their markers
+    for (auto& sink : zone_sinks_) {
+        sink->event_log_ = event_log;
+        sink->event_log_frames_ = false;
+    }
+}
+
+void TUIOBridge::setHistoryStore(std::shared_ptr<MarkerHistoryStore> history_store) {
+    history_store_ = history_store;
+}
+
+void TUIOBridge::routeToZones(const std::vector<CodiceMarker>& markers, std::vector<CodiceMarker>& unzoned) {
+    std::vector<float> xs, ys;
+    xs.reserve(markers.size());
+    ys.reserve(markers.size());
+    for (const auto& marker : markers) {
+        xs.push_back(marker.x);
+        ys.push_back(marker.y);
+    }
+    
+    std::vector<int> zone_indices;
+    zone_router_.classify(xs, ys, zone_indices);
+    
+    // Every sink gets a frame, even an empty one, so its markers time out correctly
+    std::vector<std::vector<CodiceMarker>> zoned(zone_sinks_.size());
+    for (size_t i = 0; i < markers.size(); i++) {
+        int zone_index = zone_indices[i];
+        if (zone_index < 0) {
+            unzoned.push_back(markers[i]);
+            continue;
+        }
+        CodiceMarker zone_marker = markers[i];
+        zone_router_.remap(static_cast<size_t>(zone_index), markers[i].x, markers[i].y, zone_marker.x, zone_marker.y);
+        zoned[zone_index].push_back(zone_marker);
+    }
+    
+    for (size_t z = 0; z < zone_sinks_.size(); z++) {
+        zone_sinks_[z]->updateMarkers(zoned[z]);
+    }
+}
+
 void TUIOBridge::setLifecycleCallback(std::function<void(int marker_id, MarkerState state, const CodiceMarker& marker)> callback) {
     lifecycle_callback_ = callback;
+    for (auto& sink : zone_sinks_) {
+        sink->setLifecycleCallback(callback);
+    }
 }
 
 std::string TUIOBridge::getLifecycleStatistics() const {
@@ -380,6 +737,7 @@ std::string TUIOBridge::getLifecycleStatistics() const {
     oss << "  Objects Created: " << total_objects_created_ << "\n";
     oss << "  Objects Updated: " << total_objects_updated_ << "\n";
     oss << "  Objects Removed: " << total_objects_removed_ << "\n";
+    oss << "  UPDATED Events Coalesced: " << total_updates_coalesced_ << "\n";
     
     // State distribution
     std::map<MarkerState, int> state_counts;
@@ -415,6 +773,13 @@ std::string TUIOBridge::getMarkerLifecycleHistory(int marker_id) const {
     return oss.str();
 }
 
+void TUIOBridge::setLifecycleHistoryLimit(size_t entries) {
+    lifecycle_history_limit_ = std::max<size_t>(entries, 1);
+    for (auto& sink : zone_sinks_) {
+        sink->setLifecycleHistoryLimit(lifecycle_history_limit_);
+    }
+}
+
 bool TUIOBridge::transitionMarkerState(int marker_id, MarkerState new_state) {
     auto state_it = marker_states_.find(marker_id);
     if (state_it == marker_states_.end()) {
@@ -435,6 +800,9 @@ bool TUIOBridge::transitionMarkerState(int marker_id, MarkerState new_state) {
 void TUIOBridge::handleStateTransition(int marker_id, MarkerState new_state, const CodiceMarker& marker) {
     // Update state
     marker_states_[marker_id] = new_state;
+    if (new_state == MarkerState::DETECTED || new_state == MarkerState::UPDATED) {
+        notified_states_[marker_id] = {marker.x, marker.y, marker.angle, std::chrono::steady_clock::now(), false};
+    }
     
     // Add to history
     addToHistory(marker_id, new_state);
@@ -451,16 +819,46 @@ void TUIOBridge::handleStateTransition(int marker_id, MarkerState new_state, con
         lifecycle_callback_(marker_id, new_state, marker);
     }
     
+    if (event_log_ && new_state != MarkerState::ACTIVE) {
+        MarkerEventKind kind = (new_state == MarkerState::DETECTED) ? MarkerEventKind::DETECTED :
+                               (new_state == MarkerState::LOST) ? MarkerEventKind::LOST : MarkerEventKind::UPDATED;
+        event_log_->logEvent(kind, marker_id, marker.session_id, marker.x, marker.y, marker.angle);
+    }
+    
     std::cout << "🔄 Marker " << marker_id << " -> " << getStateName(new_state) << std::endl;
 }
 
+bool TUIOBridge::isUpdateEventDue(const CodiceMarker& marker, std::chrono::steady_clock::time_point now) {
+    auto it = notified_states_.find(marker.id);
+    if (it == notified_states_.end()) {
+        return true;
+    }
+    NotifiedState& notified = it->second;
+    const TUIOStreamingConfig& config = config_manager_.getConfig();
+    
+    double dx = marker.x - notified.x;
+    double dy = marker.y - notified.y;
+    double da = std::remainder(static_cast<double>(marker.angle) - notified.angle, TWO_PI);
+    bool changed = dx * dx + dy * dy > config.update_event_distance * config.update_event_distance ||
+                   std::fabs(da) > config.update_event_angle;
+    
+    // Trailing edge: a change held back by the rate limit is sent when the window expires
+    if (config.update_event_max_rate > 0 &&
+        now - notified.time < std::chrono::microseconds(1000000 / config.update_event_max_rate)) {
+        notified.pending = notified.pending || changed;
+        return false;
+    }
+    return changed || notified.pending;
+}
+
 void TUIOBridge::addToHistory(int marker_id, MarkerState state) {
     auto now = std::chrono::steady_clock::now();
-    marker_history_[marker_id].push_back({state, now});
+    auto& history = marker_history_[marker_id];
+    history.push_back({state, now});
     
-    // Keep only last 10 history entries per marker
-    if (marker_history_[marker_id].size() > 10) {
-        marker_history_[marker_id].pop_front();
+    // Keep only the last lifecycle_history_limit_ entries per marker
+    while (history.size() > lifecycle_history_limit_) {
+        history.pop_front();
     }
 }
 
@@ -526,6 +924,8 @@ void TUIOBridge::cleanupExpiredMarkers() {
             total_objects_removed_++;
         }
         last_markers_.erase(marker_id);
+        sent_states_.erase(marker_id);
+        notified_states_.erase(marker_id);
     }
 }
 
@@ -34,6 +34,18 @@ std::string TUIOStreamingConfig::getValidationErrors() const {
     if (buffer_size < 256) {
         errors.push_back("Buffer size must be at least 256 bytes");
     }
+    if (frame_budget_bytes < 0) {
+        errors.push_back("Frame budget must be 0 (unlimited) or a positive number of bytes");
+    }
+    if (binary_stream_port < 1 || binary_stream_port > 65535) {
+        errors.push_back("Binary stream port must be between 1 and 65535");
+    }
+    if (binary_ack_port < 0 || binary_ack_port > 65535) {
+        errors.push_back("Binary ACK port must be between 0 and 65535");
+    }
+    if (binary_keyframe_interval < 1 || binary_keyframe_interval > 600) {
+        errors.push_back("Binary keyframe interval must be between 1 and 600 frames");
+    }
     
     // Marker validation
     if (marker_timeout_ms < 100) {
@@ -45,6 +57,15 @@ std::string TUIOStreamingConfig::getValidationErrors() const {
     if (max_markers < 1 || max_markers > 100) {
         errors.push_back("Max markers must be between 1 and 100");
     }
+    if (update_event_distance < 0.0 || update_event_distance > 1.0) {
+        errors.push_back("Update event distance must be between 0.0 and 1.0");
+    }
+    if (update_event_angle < 0.0) {
+        errors.push_back("Update event angle must not be negative");
+    }
+    if (update_event_max_rate < 0 || update_event_max_rate > 120) {
+        errors.push_back("Update event max rate must be between 0 (unlimited) and 120 per second");
+    }
     
     // Performance validation
     if (motion_smoothing_factor < 0.0 || motion_smoothing_factor > 1.0) {
@@ -69,9 +90,16 @@ void TUIOStreamingConfig::setDefaults() {
     max_fps = 30;
     enable_compression = false;
     buffer_size = 1024;
+    frame_budget_bytes = 0;
+    binary_stream_port = 3334;
+    binary_ack_port = 0;
+    binary_keyframe_interval = 30;
     marker_timeout_ms = 1000;
     min_confidence = 0.5;
     max_markers = 10;
+    update_event_distance = 0.005;
+    update_event_angle = 0.035;
+    update_event_max_rate = 10;
     enable_tuio_1_1 = true;
     enable_tuio_2_0 = false;
     tuio_profile = "default";
@@ -94,12 +122,19 @@ std::string TUIOStreamingConfig::toJson() const {
     oss << "  \"streaming\": {\n";
     oss << "    \"max_fps\": " << max_fps << ",\n";
     oss << "    \"enable_compression\": " << (enable_compression ? "true" : "false") << ",\n";
-    oss << "    \"buffer_size\": " << buffer_size << "\n";
+    oss << "    \"buffer_size\": " << buffer_size << ",\n";
+    oss << "    \"frame_budget_bytes\": " << frame_budget_bytes << ",\n";
+    oss << "    \"binary_stream_port\": " << binary_stream_port << ",\n";
+    oss << "    \"binary_ack_port\": " << binary_ack_port << ",\n";
+    oss << "    \"binary_keyframe_interval\": " << binary_keyframe_interval << "\n";
     oss << "  },\n";
     oss << "  \"markers\": {\n";
     oss << "    \"timeout_ms\": " << marker_timeout_ms << ",\n";
     oss << "    \"min_confidence\": " << min_confidence << ",\n";
-    oss << "    \"max_markers\": " << max_markers << "\n";
+    oss << "    \"max_markers\": " << max_markers << ",\n";
+    oss << "    \"update_event_distance\": " << update_event_distance << ",\n";
+    oss << "    \"update_event_angle\": " << update_event_angle << ",\n";
+    oss << "    \"update_event_max_rate\": " << update_event_max_rate << "\n";
     oss << "  },\n";
     oss << "  \"tuio\": {\n";
     oss << "    \"enable_tuio_1_1\": " << (enable_tuio_1_1 ? "true" : "false") << ",\n";
@@ -128,9 +163,17 @@ bool TUIOStreamingConfig::fromJson(const std::string& json) {
     std::regex timeout_regex("\"timeout_ms\":\\s*(\\d+)");
     std::regex max_fps_regex("\"max_fps\":\\s*(\\d+)");
     std::regex buffer_size_regex("\"buffer_size\":\\s*(\\d+)");
+    std::regex frame_budget_regex("\"frame_budget_bytes\":\\s*(\\d+)");
     std::regex marker_timeout_regex("\"marker_timeout_ms\":\\s*(\\d+)");
     std::regex min_confidence_regex("\"min_confidence\":\\s*([\\d.]+)");
     std::regex max_markers_regex("\"max_markers\":\\s*(\\d+)");
+    std::regex update_distance_regex("\"update_event_distance\":\\s*([\\d.]+)");
+    std::regex update_angle_regex("\"update_event_angle\":\\s*([\\d.]+)");
+    std::regex update_rate_regex("\"update_event_max_rate\":\\s*(\\d+)");
+    std::regex compression_regex("\"enable_compression\":\\s*(true|false)");
+    std::regex binary_port_regex("\"binary_stream_port\":\\s*(\\d+)");
+    std::regex binary_ack_port_regex("\"binary_ack_port\":\\s*(\\d+)");
+    std::regex keyframe_interval_regex("\"binary_keyframe_interval\":\\s*(\\d+)");
     
     std::smatch match;
     
@@ -149,6 +192,9 @@ bool TUIOStreamingConfig::fromJson(const std::string& json) {
     if (std::regex_search(json, match, buffer_size_regex)) {
         buffer_size = std::stoi(match[1].str());
     }
+    if (std::regex_search(json, match, frame_budget_regex)) {
+        frame_budget_bytes = std::stoi(match[1].str());
+    }
     if (std::regex_search(json, match, marker_timeout_regex)) {
         marker_timeout_ms = std::stoi(match[1].str());
     }
@@ -158,31 +204,31 @@ bool TUIOStreamingConfig::fromJson(const std::string& json) {
     if (std::regex_search(json, match, max_markers_regex)) {
         max_markers = std::stoi(match[1].str());
     }
+    if (std::regex_search(json, match, update_distance_regex)) {
+        update_event_distance = std::stod(match[1].str());
+    }
+    if (std::regex_search(json, match, update_angle_regex)) {
+        update_event_angle = std::stod(match[1].str());
+    }
+    if (std::regex_search(json, match, update_rate_regex)) {
+        update_event_max_rate = std::stoi(match[1].str());
+    }
+    if (std::regex_search(json, match, compression_regex)) {
+        enable_compression = (match[1].str() == "true");
+    }
+    if (std::regex_search(json, match, binary_port_regex)) {
+        binary_stream_port = std::stoi(match[1].str());
+    }
+    if (std::regex_search(json, match, binary_ack_port_regex)) {
+        binary_ack_port = std::stoi(match[1].str());
+    }
+    if (std::regex_search(json, match, keyframe_interval_regex)) {
+        binary_keyframe_interval = std::stoi(match[1].str());
+    }
     
     return validate();
 }
 
-void TUIOStreamingConfig::merge(const TUIOStreamingConfig& other) {
-    if (!other.host.empty()) host = other.host;
-    if (other.port > 0) port = other.port;
-    if (other.timeout_ms > 0) timeout_ms = other.timeout_ms;
-    if (other.max_fps > 0) max_fps = other.max_fps;
-    if (other.buffer_size > 0) buffer_size = other.buffer_size;
-    if (other.marker_timeout_ms > 0) marker_timeout_ms = other.marker_timeout_ms;
-    if (other.min_confidence >= 0.0) min_confidence = other.min_confidence;
-    if (other.max_markers > 0) max_markers = other.max_markers;
-    enable_compression = other.enable_compression;
-    enable_tuio_1_1 = other.enable_tuio_1_1;
-    enable_tuio_2_0 = other.enable_tuio_2_0;
-    if (!other.tuio_profile.empty()) tuio_profile = other.tuio_profile;
-    enable_debug_logging = other.enable_debug_logging;
-    enable_statistics = other.enable_statistics;
-    if (other.statistics_interval_ms > 0) statistics_interval_ms = other.statistics_interval_ms;
-    enable_motion_prediction = other.enable_motion_prediction;
-    if (other.motion_smoothing_factor >= 0.0) motion_smoothing_factor = other.motion_smoothing_factor;
-    if (other.prediction_frames >= 0) prediction_frames = other.prediction_frames;
-}
-
 TUIOStreamingConfig TUIOStreamingConfig::getProfile(const std::string& profile_name) const {
     // Return a copy with profile-specific settings
     TUIOStreamingConfig profile = *this;
@@ -291,8 +337,23 @@ std::string TUIOConfigManager::getConfigSummary() const {
     std::ostringstream oss;
     oss << "TUIO Streaming Configuration Summary:\n";
     oss << "  Network: " << config_.host << ":" << config_.port << "\n";
-    oss << "  Streaming: " << config_.max_fps << " FPS, " << config_.buffer_size << " bytes\n";
+    oss << "  Streaming: " << config_.max_fps << " FPS, " << config_.buffer_size << " bytes";
+    if (config_.frame_budget_bytes > 0) {
+        oss << ", " << config_.frame_budget_bytes << " bytes/frame budget";
+    }
+    oss << "\n";
+    if (config_.enable_compression) {
+        oss << "  Binary Stream: port " << config_.binary_stream_port
+            << ", keyframe every " << config_.binary_keyframe_interval << " frames"
+            << (config_.binary_ack_port > 0 ? ", ACK port " + std::to_string(config_.binary_ack_port) : ", no ACK channel") << "\n";
+    }
     oss << "  Markers: " << config_.max_markers << " max, " << config_.min_confidence << " min confidence\n";
+    oss << "  Lifecycle UPDATED: after " << config_.update_event_distance << " movement or "
+        << config_.update_event_angle << " rad rotation";
+    if (config_.update_event_max_rate > 0) {
+        oss << ", at most " << config_.update_event_max_rate << "/s per marker";
+    }
+    oss << "\n";
     oss << "  TUIO: v1.1=" << (config_.enable_tuio_1_1 ? "enabled" : "disabled");
     if (config_.enable_tuio_2_0) oss << ", v2.0=enabled";
     oss << "\n";
@@ -351,12 +412,26 @@ bool TUIOConfigManager::parseJsonValue(const std::string& key, const std::string
         config_.max_fps = std::stoi(value);
     } else if (key == "buffer_size") {
         config_.buffer_size = std::stoi(value);
+    } else if (key == "frame_budget_bytes") {
+        config_.frame_budget_bytes = std::stoi(value);
+    } else if (key == "binary_stream_port") {
+        config_.binary_stream_port = std::stoi(value);
+    } else if (key == "binary_ack_port") {
+        config_.binary_ack_port = std::stoi(value);
+    } else if (key == "binary_keyframe_interval") {
+        config_.binary_keyframe_interval = std::stoi(value);
     } else if (key == "marker_timeout_ms") {
         config_.marker_timeout_ms = std::stoi(value);
     } else if (key == "min_confidence") {
         config_.min_confidence = std::stod(value);
     } else if (key == "max_markers") {
         config_.max_markers = std::stoi(value);
+    } else if (key == "update_event_distance") {
+        config_.update_event_distance = std::stod(value);
+    } else if (key == "update_event_angle") {
+        config_.update_event_angle = std::stod(value);
+    } else if (key == "update_event_max_rate") {
+        config_.update_event_max_rate = std::stoi(value);
     } else if (key == "enable_compression") {
         config_.enable_compression = (value == "true" || value == "1");
     } else if (key == "enable_tuio_1_1") {
@@ -386,9 +461,16 @@ std::string TUIOConfigManager::serializeJsonValue(const std::string& key) const
     if (key == "timeout_ms") return std::to_string(config_.timeout_ms);
     if (key == "max_fps") return std::to_string(config_.max_fps);
     if (key == "buffer_size") return std::to_string(config_.buffer_size);
+    if (key == "frame_budget_bytes") return std::to_string(config_.frame_budget_bytes);
+    if (key == "binary_stream_port") return std::to_string(config_.binary_stream_port);
+    if (key == "binary_ack_port") return std::to_string(config_.binary_ack_port);
+    if (key == "binary_keyframe_interval") return std::to_string(config_.binary_keyframe_interval);
     if (key == "marker_timeout_ms") return std::to_string(config_.marker_timeout_ms);
     if (key == "min_confidence") return std::to_string(config_.min_confidence);
     if (key == "max_markers") return std::to_string(config_.max_markers);
+    if (key == "update_event_distance") return std::to_string(config_.update_event_distance);
+    if (key == "update_event_angle") return std::to_string(config_.update_event_angle);
+    if (key == "update_event_max_rate") return std::to_string(config_.update_event_max_rate);
     if (key == "enable_compression") return config_.enable_compression ? "true" : "false";
     if (key == "enable_tuio_1_1") return config_.enable_tuio_1_1 ? "true" : "false";
     if (key == "enable_tuio_2_0") return config_.enable_tuio_2_0 ? "true" : "false";
@@ -3,9 +3,22 @@
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
+#include <cmath>
 
 namespace CodiceCam {
 
+namespace {
+    const int MARKER_RADIUS = 20;
+    const int ORIENTATION_LENGTH = 30;
+    const int GRID_SPACING = 50;
+    const int CIRCLE_SEGMENTS = 16;
+    const int STATS_WIDTH = 300;
+    const int STATS_HEIGHT = 120;
+    const int STATS_REFRESH_MS = 250;  // Overlay text changes at most 4x per second
+    const int FRAME_INTERVAL_MS = 16;  // ~60 FPS cap while objects change
+    const int DEFAULT_HEARTBEAT_MS = 1000;
+}
+
 TUIOTestClient::TUIOTestClient()
     : window_(nullptr)
     , renderer_(nullptr)
@@ -13,12 +26,34 @@ TUIOTestClient::TUIOTestClient()
     , debug_mode_(false)
     , window_width_(800)
     , window_height_(600)
+    , render_updates_received_(0)
     , total_objects_received_(0)
     , total_updates_received_(0)
     , total_objects_removed_(0)
+    , total_frames_rendered_(0)
     , start_time_(std::chrono::steady_clock::now())
+    , wake_event_type_(static_cast<Uint32>(-1))
+    , objects_dirty_(false)
+    , wake_pending_(false)
+    , redraw_requested_(true)
+    , heartbeat_interval_ms_(DEFAULT_HEARTBEAT_MS)
+    , batched_rendering_(CODICE_SDL_RENDER_GEOMETRY != 0)
+#if CODICE_SDL_RENDER_GEOMETRY
+    , grid_width_(0)
+    , grid_height_(0)
+#endif
+    , stats_texture_(nullptr)
+    , last_stats_refresh_(std::chrono::steady_clock::now())
 {
     initializeColors();
+    
+#if CODICE_SDL_RENDER_GEOMETRY
+    for (int i = 0; i < CIRCLE_SEGMENTS; i++) {
+        float theta = 2.0f * static_cast<float>(M_PI) * i / CIRCLE_SEGMENTS;
+        circle_cos_.push_back(std::cos(theta));
+        circle_sin_.push_back(std::sin(theta));
+    }
+#endif
 }
 
 TUIOTestClient::~TUIOTestClient() {
@@ -59,6 +94,12 @@ bool TUIOTestClient::initialize(int width, int height, const std::string& title)
     // Set renderer properties
     SDL_SetRenderDrawBlendMode(renderer_, SDL_BLENDMODE_BLEND);
     
+    // Object updates wake the render loop with a user event
+    wake_event_type_ = SDL_RegisterEvents(1);
+    if (wake_event_type_ == static_cast<Uint32>(-1)) {
+        std::cerr << "⚠️  No SDL user events available, rendering on heartbeat only" << std::endl;
+    }
+    
     std::cout << "✅ TUIO Test Client initialized: " << width << "x" << height << std::endl;
     return true;
 }
@@ -76,13 +117,34 @@ bool TUIOTestClient::start() {
     std::cout << "📋 Controls:" << std::endl;
     std::cout << "  - ESC or Close Window: Exit" << std::endl;
     std::cout << "  - D: Toggle debug mode" << std::endl;
+    std::cout << "  - B: Toggle batched rendering" << std::endl;
     std::cout << "  - R: Reset statistics" << std::endl;
     
-    // Main render loop
+    // Main render loop: sleep on events, render on change, input or heartbeat
+    auto last_render = std::chrono::steady_clock::now() - std::chrono::milliseconds(heartbeat_interval_ms_);
     while (running_) {
-        handleEvents();
-        render();
-        SDL_Delay(16); // ~60 FPS
+        auto since_render = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - last_render).count();
+        bool pending = redraw_requested_ || objects_dirty_;
+        long timeout = (pending ? FRAME_INTERVAL_MS : heartbeat_interval_ms_) - since_render;
+        
+        SDL_Event event;
+        if (SDL_WaitEventTimeout(&event, static_cast<int>(std::max(timeout, 0L)))) {
+            handleEvent(event);
+            while (SDL_PollEvent(&event)) {
+                handleEvent(event);
+            }
+        }
+        
+        auto now = std::chrono::steady_clock::now();
+        since_render = std::chrono::duration_cast<std::chrono::milliseconds>(now - last_render).count();
+        pending = redraw_requested_ || objects_dirty_;
+        if ((pending && since_render >= FRAME_INTERVAL_MS) || since_render >= heartbeat_interval_ms_) {
+            redraw_requested_ = false;
+            objects_dirty_ = false;
+            render();
+            last_render = now;
+        }
     }
     
     return true;
@@ -90,11 +152,13 @@ bool TUIOTestClient::start() {
 
 void TUIOTestClient::stop() {
     running_ = false;
+    wakeRenderLoop();
     std::cout << "🛑 TUIO Test Client stopped" << std::endl;
 }
 
 void TUIOTestClient::updateObject(int session_id, int symbol_id, float x, float y, float angle,
                                  float velocity_x, float velocity_y, float rotation_velocity, float acceleration) {
+    std::unique_lock<std::mutex> lock(objects_mutex_);
     auto it = objects_.find(session_id);
     bool is_new_object = (it == objects_.end());
     
@@ -124,9 +188,14 @@ void TUIOTestClient::updateObject(int session_id, int symbol_id, float x, float
                       << " at (" << std::fixed << std::setprecision(2) << x << ", " << y << ")" << std::endl;
         }
     }
+    lock.unlock();
+    
+    objects_dirty_ = true;
+    wakeRenderLoop();
 }
 
 void TUIOTestClient::removeObject(int session_id) {
+    std::unique_lock<std::mutex> lock(objects_mutex_);
     auto it = objects_.find(session_id);
     if (it != objects_.end()) {
         objects_.erase(it);
@@ -134,6 +203,25 @@ void TUIOTestClient::removeObject(int session_id) {
         if (debug_mode_) {
             std::cout << "❌ Removed object: Session=" << session_id << std::endl;
         }
+        lock.unlock();
+        
+        objects_dirty_ = true;
+        wakeRenderLoop();
+    }
+}
+
+void TUIOTestClient::wakeRenderLoop() {
+    if (wake_event_type_ == static_cast<Uint32>(-1)) {
+        return;
+    }
+    
+    // One queued wake event is enough, however many updates arrive meanwhile
+    if (!wake_pending_.exchange(true)) {
+        SDL_Event event = {};
+        event.type = wake_event_type_;
+        if (SDL_PushEvent(&event) <= 0) {
+            wake_pending_ = false;
+        }
     }
 }
 
@@ -146,12 +234,14 @@ std::string TUIOTestClient::getStatistics() const {
     auto now = std::chrono::steady_clock::now();
     auto elapsed_seconds = std::chrono::duration_cast<std::chrono::seconds>(now - start_time_).count();
     
+    std::lock_guard<std::mutex> lock(objects_mutex_);
     oss << "TUIO Test Client Statistics:\n";
     oss << "  Uptime: " << elapsed_seconds << " seconds\n";
     oss << "  Active Objects: " << objects_.size() << "\n";
     oss << "  Objects Received: " << total_objects_received_ << "\n";
     oss << "  Updates Received: " << total_updates_received_ << "\n";
     oss << "  Objects Removed: " << total_objects_removed_ << "\n";
+    oss << "  Frames Rendered: " << total_frames_rendered_ << "\n";
     
     if (elapsed_seconds > 0) {
         double updates_per_second = static_cast<double>(total_updates_received_) / elapsed_seconds;
@@ -166,55 +256,114 @@ void TUIOTestClient::setDebugMode(bool debug) {
     std::cout << "🐛 Debug mode: " << (debug ? "enabled" : "disabled") << std::endl;
 }
 
-void TUIOTestClient::handleEvents() {
-    SDL_Event event;
-    while (SDL_PollEvent(&event)) {
-        switch (event.type) {
-            case SDL_QUIT:
-                running_ = false;
-                break;
-                
-            case SDL_KEYDOWN:
-                switch (event.key.keysym.sym) {
-                    case SDLK_ESCAPE:
-                        running_ = false;
-                        break;
-                    case SDLK_d:
-                        setDebugMode(!debug_mode_);
-                        break;
-                    case SDLK_r:
-                        total_objects_received_ = 0;
-                        total_updates_received_ = 0;
-                        total_objects_removed_ = 0;
-                        start_time_ = std::chrono::steady_clock::now();
-                        std::cout << "🔄 Statistics reset" << std::endl;
-                        break;
-                }
-                break;
-                
-            case SDL_WINDOWEVENT:
-                if (event.window.event == SDL_WINDOWEVENT_RESIZED) {
-                    window_width_ = event.window.data1;
-                    window_height_ = event.window.data2;
+void TUIOTestClient::setBatchedRendering(bool enable) {
+#if CODICE_SDL_RENDER_GEOMETRY
+    batched_rendering_ = enable;
+#else
+    if (enable) {
+        std::cerr << "⚠️  Batched rendering requires SDL 2.0.18+, using per-object rendering" << std::endl;
+    }
+    batched_rendering_ = false;
+#endif
+    std::cout << "🎨 Batched rendering: " << (batched_rendering_ ? "enabled" : "disabled") << std::endl;
+    redraw_requested_ = true;
+}
+
+void TUIOTestClient::setHeartbeatInterval(int interval_ms) {
+    heartbeat_interval_ms_ = std::max(interval_ms, FRAME_INTERVAL_MS);
+}
+
+void TUIOTestClient::handleEvent(const SDL_Event& event) {
+    if (event.type == wake_event_type_) {
+        wake_pending_ = false;
+        return;
+    }
+    
+    switch (event.type) {
+        case SDL_QUIT:
+            running_ = false;
+            break;
+            
+        case SDL_KEYDOWN:
+            redraw_requested_ = true;
+            switch (event.key.keysym.sym) {
+                case SDLK_ESCAPE:
+                    running_ = false;
+                    break;
+                case SDLK_d:
+                    setDebugMode(!debug_mode_);
+                    break;
+                case SDLK_b:
+                    setBatchedRendering(!batched_rendering_);
+                    break;
+                case SDLK_r: {
+                    std::lock_guard<std::mutex> lock(objects_mutex_);
+                    total_objects_received_ = 0;
+                    total_updates_received_ = 0;
+                    total_objects_removed_ = 0;
+                    total_frames_rendered_ = 0;
+                    start_time_ = std::chrono::steady_clock::now();
+                    std::cout << "🔄 Statistics reset" << std::endl;
+                    break;
                 }
-                break;
-        }
+            }
+            break;
+            
+        case SDL_WINDOWEVENT:
+            redraw_requested_ = true;
+            if (event.window.event == SDL_WINDOWEVENT_RESIZED) {
+                window_width_ = event.window.data1;
+                window_height_ = event.window.data2;
+            }
+            break;
+            
+        case SDL_RENDER_TARGETS_RESET:
+        case SDL_RENDER_DEVICE_RESET:
+            // Target texture contents are lost, rebuild on next frame
+            if (stats_texture_) {
+                SDL_DestroyTexture(stats_texture_);
+                stats_texture_ = nullptr;
+            }
+            stats_text_.clear();
+            redraw_requested_ = true;
+            break;
     }
 }
 
 void TUIOTestClient::render() {
+    // Snapshot the object table so updates are not blocked while drawing
+    {
+        std::lock_guard<std::mutex> lock(objects_mutex_);
+        render_objects_.clear();
+        for (const auto& [session_id, obj] : objects_) {
+            if (obj.is_active) {
+                render_objects_.push_back(obj);
+            }
+        }
+        render_updates_received_ = total_updates_received_;
+        total_frames_rendered_++;
+    }
+    
     // Clear screen with dark background
     SDL_SetRenderDrawColor(renderer_, 20, 20, 20, 255);
     SDL_RenderClear(renderer_);
     
+#if CODICE_SDL_RENDER_GEOMETRY
+    if (batched_rendering_) {
+        renderGridBatched();
+        renderObjectsBatched();
+        renderStatisticsCached();
+        SDL_RenderPresent(renderer_);
+        return;
+    }
+#endif
+    
     // Render grid
     renderGrid();
     
     // Render all active objects
-    for (const auto& [session_id, obj] : objects_) {
-        if (obj.is_active) {
-            renderObject(obj);
-        }
+    for (const auto& obj : render_objects_) {
+        renderObject(obj);
     }
     
     // Render statistics
@@ -267,8 +416,50 @@ void TUIOTestClient::renderObject(const TUIOObject& obj) {
 }
 
 void TUIOTestClient::renderStatistics() {
+    drawStatistics(buildStatisticsText(), 10, 10);
+}
+
+void TUIOTestClient::renderStatisticsCached() {
+    auto now = std::chrono::steady_clock::now();
+    auto since_refresh = std::chrono::duration_cast<std::chrono::milliseconds>(now - last_stats_refresh_).count();
+    
+    if (!stats_texture_) {
+        stats_texture_ = SDL_CreateTexture(renderer_, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET,
+                                           STATS_WIDTH, STATS_HEIGHT);
+        if (!stats_texture_) {
+            // Render targets unsupported, draw directly
+            renderStatistics();
+            return;
+        }
+        SDL_SetTextureBlendMode(stats_texture_, SDL_BLENDMODE_BLEND);
+        stats_text_.clear();
+    }
+    
+    // Re-render the overlay only when its text changed (rate limited)
+    std::string stats_text = buildStatisticsText();
+    if (stats_text_.empty() || (stats_text != stats_text_ && since_refresh >= STATS_REFRESH_MS)) {
+        SDL_SetRenderTarget(renderer_, stats_texture_);
+        SDL_SetRenderDrawColor(renderer_, 0, 0, 0, 0);
+        SDL_RenderClear(renderer_);
+        drawStatistics(stats_text, 0, 0);
+        SDL_SetRenderTarget(renderer_, nullptr);
+        
+        stats_text_ = stats_text;
+        last_stats_refresh_ = now;
+    }
+    
+    SDL_Rect dst = {10, 10, STATS_WIDTH, STATS_HEIGHT};
+    SDL_RenderCopy(renderer_, stats_texture_, nullptr, &dst);
+}
+
+std::string TUIOTestClient::buildStatisticsText() const {
+    return "Objects: " + std::to_string(render_objects_.size()) +
+           " | Updates: " + std::to_string(render_updates_received_);
+}
+
+void TUIOTestClient::drawStatistics(const std::string& stats_text, int origin_x, int origin_y) {
     // Draw statistics background
-    SDL_Rect stats_bg = {10, 10, 300, 120};
+    SDL_Rect stats_bg = {origin_x, origin_y, STATS_WIDTH, STATS_HEIGHT};
     SDL_SetRenderDrawColor(renderer_, 0, 0, 0, 180);
     SDL_RenderFillRect(renderer_, &stats_bg);
     SDL_SetRenderDrawColor(renderer_, 255, 255, 255, 255);
@@ -276,23 +467,21 @@ void TUIOTestClient::renderStatistics() {
     
     // Note: In a real implementation, you'd use SDL_ttf for text rendering
     // For now, we'll just show the object count visually
-    std::string stats_text = "Objects: " + std::to_string(objects_.size()) + 
-                           " | Updates: " + std::to_string(total_updates_received_);
-    
     // Draw simple text representation (rectangles for each character)
-    int text_x = 20;
-    int text_y = 30;
+    int text_x = origin_x + 10;
+    int text_y = origin_y + 20;
     int char_width = 8;
     int char_height = 12;
     
+    std::vector<SDL_Rect> char_rects;
+    char_rects.reserve(stats_text.size());
     for (char c : stats_text) {
         if (c != ' ') {
-            SDL_Rect char_rect = {text_x, text_y, char_width, char_height};
-            SDL_SetRenderDrawColor(renderer_, 255, 255, 255, 255);
-            SDL_RenderDrawRect(renderer_, &char_rect);
+            char_rects.push_back({text_x, text_y, char_width, char_height});
         }
         text_x += char_width + 2;
     }
+    SDL_RenderDrawRects(renderer_, char_rects.data(), static_cast<int>(char_rects.size()));
 }
 
 void TUIOTestClient::renderGrid() {
@@ -310,6 +499,120 @@ void TUIOTestClient::renderGrid() {
     }
 }
 
+#if CODICE_SDL_RENDER_GEOMETRY
+void TUIOTestClient::renderObjectsBatched() {
+    object_vertices_.clear();
+    object_indices_.clear();
+    
+    const SDL_Color white = {255, 255, 255, 255};
+    const SDL_Color id_background = {0, 0, 0, 128};
+    const float radius = static_cast<float>(MARKER_RADIUS);
+    
+    for (const auto& obj : render_objects_) {
+        float cx = static_cast<float>(screenX(obj.x));
+        float cy = static_cast<float>(screenY(obj.y));
+        float screen_angle = screenAngle(obj.angle);
+        
+        // Filled circle as a triangle fan
+        SDL_Color color = getMarkerColor(obj.symbol_id);
+        int center = static_cast<int>(object_vertices_.size());
+        object_vertices_.push_back({{cx, cy}, color, {0.0f, 0.0f}});
+        for (int i = 0; i < CIRCLE_SEGMENTS; i++) {
+            object_vertices_.push_back({{cx + radius * circle_cos_[i], cy + radius * circle_sin_[i]}, color, {0.0f, 0.0f}});
+            object_indices_.push_back(center);
+            object_indices_.push_back(center + 1 + i);
+            object_indices_.push_back(center + 1 + (i + 1) % CIRCLE_SEGMENTS);
+        }
+        
+        // Marker border
+        appendRectOutline(object_vertices_, object_indices_, cx - radius, cy - radius, radius * 2, radius * 2, white);
+        
+        // Orientation line
+        appendLine(object_vertices_, object_indices_, cx, cy,
+                   cx + ORIENTATION_LENGTH * std::cos(screen_angle),
+                   cy + ORIENTATION_LENGTH * std::sin(screen_angle), 2.0f, white);
+        
+        // Marker ID box
+        if (debug_mode_) {
+            float id_x = cx + radius + 5;
+            float id_y = cy - 10;
+            appendQuad(object_vertices_, object_indices_, id_x, id_y, id_x + 30, id_y + 20, id_background);
+            appendRectOutline(object_vertices_, object_indices_, id_x, id_y, 30, 20, white);
+        }
+    }
+    
+    if (!object_indices_.empty()) {
+        SDL_RenderGeometry(renderer_, nullptr, object_vertices_.data(), static_cast<int>(object_vertices_.size()),
+                           object_indices_.data(), static_cast<int>(object_indices_.size()));
+    }
+}
+
+void TUIOTestClient::renderGridBatched() {
+    // Grid vertices only change with the window size
+    if (grid_width_ != window_width_ || grid_height_ != window_height_) {
+        grid_vertices_.clear();
+        grid_indices_.clear();
+        
+        const SDL_Color grid_color = {40, 40, 40, 255};
+        for (int x = 0; x < window_width_; x += GRID_SPACING) {
+            appendQuad(grid_vertices_, grid_indices_, static_cast<float>(x), 0.0f,
+                       static_cast<float>(x + 1), static_cast<float>(window_height_), grid_color);
+        }
+        for (int y = 0; y < window_height_; y += GRID_SPACING) {
+            appendQuad(grid_vertices_, grid_indices_, 0.0f, static_cast<float>(y),
+                       static_cast<float>(window_width_), static_cast<float>(y + 1), grid_color);
+        }
+        
+        grid_width_ = window_width_;
+        grid_height_ = window_height_;
+    }
+    
+    if (!grid_indices_.empty()) {
+        SDL_RenderGeometry(renderer_, nullptr, grid_vertices_.data(), static_cast<int>(grid_vertices_.size()),
+                           grid_indices_.data(), static_cast<int>(grid_indices_.size()));
+    }
+}
+
+void TUIOTestClient::appendQuad(std::vector<SDL_Vertex>& vertices, std::vector<int>& indices,
+                                float x0, float y0, float x1, float y1, SDL_Color color) const {
+    int base = static_cast<int>(vertices.size());
+    vertices.push_back({{x0, y0}, color, {0.0f, 0.0f}});
+    vertices.push_back({{x1, y0}, color, {0.0f, 0.0f}});
+    vertices.push_back({{x1, y1}, color, {0.0f, 0.0f}});
+    vertices.push_back({{x0, y1}, color, {0.0f, 0.0f}});
+    indices.insert(indices.end(), {base, base + 1, base + 2, base, base + 2, base + 3});
+}
+
+void TUIOTestClient::appendLine(std::vector<SDL_Vertex>& vertices, std::vector<int>& indices,
+                                float x0, float y0, float x1, float y1, float width, SDL_Color color) const {
+    float dx = x1 - x0;
+    float dy = y1 - y0;
+    float length = std::sqrt(dx * dx + dy * dy);
+    if (length <= 0.0f) {
+        return;
+    }
+    
+    // Offset perpendicular to the line by half the width
+    float nx = -dy / length * width * 0.5f;
+    float ny = dx / length * width * 0.5f;
+    
+    int base = static_cast<int>(vertices.size());
+    vertices.push_back({{x0 + nx, y0 + ny}, color, {0.0f, 0.0f}});
+    vertices.push_back({{x1 + nx, y1 + ny}, color, {0.0f, 0.0f}});
+    vertices.push_back({{x1 - nx, y1 - ny}, color, {0.0f, 0.0f}});
+    vertices.push_back({{x0 - nx, y0 - ny}, color, {0.0f, 0.0f}});
+    indices.insert(indices.end(), {base, base + 1, base + 2, base, base + 2, base + 3});
+}
+
+void TUIOTestClient::appendRectOutline(std::vector<SDL_Vertex>& vertices, std::vector<int>& indices,
+                                       float x, float y, float w, float h, SDL_Color color) const {
+    appendQuad(vertices, indices, x, y, x + w, y + 1, color);
+    appendQuad(vertices, indices, x, y + h - 1, x + w, y + h, color);
+    appendQuad(vertices, indices, x, y + 1, x + 1, y + h - 1, color);
+    appendQuad(vertices, indices, x + w - 1, y + 1, x + w, y + h - 1, color);
+}
+#endif
+
 SDL_Color TUIOTestClient::getMarkerColor(int symbol_id) const {
     if (marker_colors_.empty()) {
         return {255, 255, 255, 255}; // Default white
@@ -336,6 +639,11 @@ void TUIOTestClient::initializeColors() {
 }
 
 void TUIOTestClient::cleanup() {
+    if (stats_texture_) {
+        SDL_DestroyTexture(stats_texture_);
+        stats_texture_ = nullptr;
+    }
+    
     if (renderer_) {
         SDL_DestroyRenderer(renderer_);
         renderer_ = nullptr;
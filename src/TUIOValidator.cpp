@@ -1,4 +1,5 @@
 #include "TUIOValidator.h"
+#include "MarkerStreamCodec.h"
 #include <iostream>
 #include <sstream>
 #include <algorithm>
@@ -480,10 +481,11 @@ std::string TUIOIntegrationTester::runIntegrationTests() {
     auto performance_result = testPerformance();
     auto streaming_result = testMarkerStreaming();
     auto config_result = testConfigurationIntegration();
+    auto bandwidth_result = testBinaryStreamBandwidth();
     
     // Store results
     test_results_ = {format_result, compatibility_result, performance_result, 
-                    streaming_result, config_result};
+                    streaming_result, config_result, bandwidth_result};
     
     // Generate summary
     int passed_tests = 0;
@@ -599,6 +601,36 @@ TUIOValidationResult TUIOIntegrationTester::testConfigurationIntegration() {
     return result;
 }
 
+TUIOValidationResult TUIOIntegrationTester::testBinaryStreamBandwidth() {
+    TUIOValidationResult result;
+    result.addInfo("test", "Binary Stream Bandwidth");
+    
+    // Typical table loads at 30 FPS for 10 seconds
+    bool round_trip_ok = true;
+    bool smaller = true;
+    for (int marker_count : {1, 10, 50}) {
+        auto benchmark = benchmarkMarkerStream(marker_count, 300);
+        round_trip_ok = round_trip_ok && benchmark.round_trip_ok;
+        smaller = smaller && benchmark.binary_bytes_per_marker < benchmark.tuio_bytes_per_marker;
+        
+        std::ostringstream value;
+        value << std::fixed << std::setprecision(1) << benchmark.binary_bytes_per_marker
+              << " vs " << benchmark.tuio_bytes_per_marker << " bytes/marker";
+        result.addInfo("markers_" + std::to_string(marker_count), value.str());
+    }
+    
+    if (round_trip_ok && smaller) {
+        result.is_valid = true;
+        result.addInfo("status", "PASS");
+    } else {
+        result.addInfo("status", "FAIL");
+        result.error_message = round_trip_ok ? "Binary stream is not smaller than TUIO 1.1"
+                                             : "Binary stream round trip mismatch";
+    }
+    
+    return result;
+}
+
 std::string TUIOIntegrationTester::generateTestReport() const {
     std::ostringstream report;
     report << "📊 TUIO Integration Test Report\n";
@@ -0,0 +1,262 @@
+#include "WorkerPool.h"
+#include "CpuQuota.h"
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+
+// cv::parallel::ParallelForAPI was added in OpenCV 4.5.2
+#if (CV_VERSION_MAJOR > 4) || (CV_VERSION_MAJOR == 4 && (CV_VERSION_MINOR > 5 || (CV_VERSION_MINOR == 5 && CV_VERSION_REVISION >= 2)))
+#define CODICE_OPENCV_PARALLEL_BACKEND 1
+#include <opencv2/core/parallel/parallel_backend.hpp>
+#else
+#define CODICE_OPENCV_PARALLEL_BACKEND 0
+#endif
+
+namespace CodiceCam {
+
+namespace {
+    // Chunks per thread, so uneven task costs still balance
+    const int CHUNKS_PER_THREAD = 4;
+
+    // Index of the current thread in its pool (0 = not a worker)
+    thread_local int tls_thread_index = 0;
+
+    // Set while the current thread runs a loop body; nested loops run inline
+    thread_local bool tls_in_parallel_body = false;
+
+    // Process-wide pool, created on first use with the configured concurrency
+    std::mutex shared_mutex;
+    std::shared_ptr<WorkerPool> shared_pool;
+    int shared_concurrency = 0;
+
+#if CODICE_OPENCV_PARALLEL_BACKEND
+    class WorkerPoolParallelBackend : public cv::parallel::ParallelForAPI {
+    public:
+        explicit WorkerPoolParallelBackend(std::shared_ptr<WorkerPool> pool)
+            : pool_(std::move(pool)) {}
+
+        void parallel_for(int tasks, FN_parallel_for_body_cb_t body_callback, void* callback_data) override {
+            pool_->parallelFor(tasks, [&](int begin, int end) {
+                body_callback(begin, end, callback_data);
+            });
+        }
+
+        int getThreadNum() const override {
+            return pool_->getThreadIndex();
+        }
+
+        int getNumThreads() const override {
+            return pool_->getConcurrency();
+        }
+
+        int setNumThreads(int nThreads) override {
+            // The pool is sized once for the whole process; OpenCV cannot resize it
+            (void)nThreads;
+            return pool_->getConcurrency();
+        }
+
+        const char* getName() const override {
+            return "codicecam";
+        }
+
+    private:
+        std::shared_ptr<WorkerPool> pool_;
+    };
+#endif
+}
+
+WorkerPool::WorkerPool(int concurrency)
+    : concurrency_(concurrency)
+    , stopping_(false)
+    , loops_run_(0)
+    , loops_inline_(0)
+{
+    if (concurrency_ <= 0) {
+        concurrency_ = CpuQuota::effectiveCpuCount();
+    }
+
+    // The caller is one of the threads
+    for (int i = 1; i < concurrency_; i++) {
+        workers_.emplace_back(&WorkerPool::workerLoop, this, i);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+void WorkerPool::parallelFor(int tasks, const RangeBody& body) {
+    if (tasks <= 0) {
+        return;
+    }
+
+    // Nested loops, single tasks and single-thread pools run inline
+    if (tls_in_parallel_body || tasks == 1 || concurrency_ == 1) {
+        loops_inline_++;
+        bool was_in_body = tls_in_parallel_body;
+        tls_in_parallel_body = true;
+        try {
+            body(0, tasks);
+        } catch (...) {
+            tls_in_parallel_body = was_in_body;
+            throw;
+        }
+        tls_in_parallel_body = was_in_body;
+        return;
+    }
+
+    loops_run_++;
+    auto job = std::make_shared<Job>();
+    job->body = &body;
+    job->tasks = tasks;
+    job->chunk_count = std::min(tasks, concurrency_ * CHUNKS_PER_THREAD);
+    job->chunk_size = (tasks + job->chunk_count - 1) / job->chunk_count;
+    job->chunk_count = (tasks + job->chunk_size - 1) / job->chunk_size;
+    job->next_chunk = 0;
+    job->completed_chunks = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.push_back(job);
+    }
+    work_cv_.notify_all();
+
+    // The caller works on its own loop, then waits for chunks still running elsewhere
+    runChunks(*job);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = std::find(jobs_.begin(), jobs_.end(), job);
+    if (it != jobs_.end()) {
+        jobs_.erase(it);
+    }
+    done_cv_.wait(lock, [&job]() {
+        return job->completed_chunks.load() == job->chunk_count;
+    });
+    lock.unlock();
+
+    if (job->error) {
+        std::rethrow_exception(job->error);
+    }
+}
+
+int WorkerPool::getConcurrency() const {
+    return concurrency_;
+}
+
+int WorkerPool::getThreadIndex() const {
+    return tls_thread_index;
+}
+
+std::string WorkerPool::getStatistics() const {
+    std::ostringstream oss;
+    oss << "Worker Pool:\n";
+    oss << "  Threads: " << concurrency_ << " (" << workers_.size() << " workers + caller)\n";
+    oss << "  Parallel loops: " << loops_run_.load() << "\n";
+    oss << "  Inline loops (nested or single task): " << loops_inline_.load() << "\n";
+    return oss.str();
+}
+
+std::shared_ptr<WorkerPool> WorkerPool::shared() {
+    std::lock_guard<std::mutex> lock(shared_mutex);
+    if (!shared_pool) {
+        shared_pool = std::make_shared<WorkerPool>(shared_concurrency);
+    }
+    return shared_pool;
+}
+
+bool WorkerPool::setSharedConcurrency(int concurrency) {
+    std::lock_guard<std::mutex> lock(shared_mutex);
+    if (shared_pool) {
+        std::cerr << "⚠️ Worker pool already running with " << shared_pool->getConcurrency()
+                  << " threads, ignoring requested " << concurrency << std::endl;
+        return false;
+    }
+    shared_concurrency = std::max(0, concurrency);
+    return true;
+}
+
+bool WorkerPool::installOpenCVBackend() {
+    static std::once_flag once;
+    static bool installed = false;
+
+    std::call_once(once, []() {
+        std::shared_ptr<WorkerPool> pool = shared();
+#if CODICE_OPENCV_PARALLEL_BACKEND
+        try {
+            cv::parallel::setParallelForBackend(std::make_shared<WorkerPoolParallelBackend>(pool), false);
+            installed = true;
+            std::cout << "⚙️ OpenCV parallel backend: CodiceCam worker pool (" << pool->getConcurrency() << " threads)" << std::endl;
+        } catch (const cv::Exception& e) {
+            std::cerr << "⚠️ Failed to install OpenCV parallel backend: " << e.what() << std::endl;
+        }
+#endif
+        if (!installed) {
+            cv::setNumThreads(pool->getConcurrency());
+            std::cout << "⚙️ OpenCV parallel backend unavailable (OpenCV " << CV_VERSION
+                      << "), capping OpenCV threads at " << pool->getConcurrency() << std::endl;
+        }
+    });
+
+    return installed;
+}
+
+void WorkerPool::workerLoop(int index) {
+    tls_thread_index = index;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        work_cv_.wait(lock, [this]() { return stopping_ || !jobs_.empty(); });
+        if (stopping_) {
+            return;
+        }
+
+        std::shared_ptr<Job> job = jobs_.front();
+        lock.unlock();
+        runChunks(*job);
+        lock.lock();
+
+        // Every chunk is claimed; stop offering the job to other workers
+        if (!jobs_.empty() && jobs_.front() == job) {
+            jobs_.pop_front();
+        }
+    }
+}
+
+void WorkerPool::runChunks(Job& job) {
+    bool was_in_body = tls_in_parallel_body;
+    tls_in_parallel_body = true;
+
+    int chunk;
+    while ((chunk = job.next_chunk.fetch_add(1)) < job.chunk_count) {
+        int begin = chunk * job.chunk_size;
+        int end = std::min(begin + job.chunk_size, job.tasks);
+        try {
+            (*job.body)(begin, end);
+        } catch (...) {
+            std::lock_guard<std::mutex> error_lock(job.error_mutex);
+            if (!job.error) {
+                job.error = std::current_exception();
+            }
+        }
+
+        if (job.completed_chunks.fetch_add(1) + 1 == job.chunk_count) {
+            // Lock so the notification cannot slip between the waiter's check and sleep
+            std::lock_guard<std::mutex> lock(mutex_);
+            done_cv_.notify_all();
+        }
+    }
+
+    tls_in_parallel_body = was_in_body;
+}
+
+} // namespace CodiceCam
@@ -0,0 +1,177 @@
+#include "ZoneRouter.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+namespace CodiceCam {
+
+ZoneRouter::ZoneRouter() {
+}
+
+ZoneRouter::~ZoneRouter() {
+}
+
+bool ZoneRouter::addZone(const TUIOZone& zone) {
+    if (zone.polygon.size() < 3) {
+        std::cerr << "❌ Zone '" << zone.name << "' needs at least 3 vertices" << std::endl;
+        return false;
+    }
+    if (zone.port < 1 || zone.port > 65535) {
+        std::cerr << "❌ Zone '" << zone.name << "' has invalid port " << zone.port << std::endl;
+        return false;
+    }
+
+    ZoneGeometry geometry;
+    geometry.min_x = geometry.min_y = 1.0f;
+    geometry.max_x = geometry.max_y = 0.0f;
+
+    for (size_t i = 0; i < zone.polygon.size(); i++) {
+        const auto& p0 = zone.polygon[i];
+        const auto& p1 = zone.polygon[(i + 1) % zone.polygon.size()];
+
+        if (p0.first < 0.0f || p0.first > 1.0f || p0.second < 0.0f || p0.second > 1.0f) {
+            std::cerr << "❌ Zone '" << zone.name << "' vertex outside surface: ("
+                      << p0.first << ", " << p0.second << ")" << std::endl;
+            return false;
+        }
+
+        geometry.min_x = std::min(geometry.min_x, p0.first);
+        geometry.min_y = std::min(geometry.min_y, p0.second);
+        geometry.max_x = std::max(geometry.max_x, p0.first);
+        geometry.max_y = std::max(geometry.max_y, p0.second);
+
+        // Horizontal edges never cross a scanline
+        if (p0.second == p1.second) {
+            continue;
+        }
+        geometry.edge_x0.push_back(p0.first);
+        geometry.edge_y0.push_back(p0.second);
+        geometry.edge_y1.push_back(p1.second);
+        geometry.edge_slope.push_back((p1.first - p0.first) / (p1.second - p0.second));
+    }
+
+    if (geometry.max_x <= geometry.min_x || geometry.max_y <= geometry.min_y) {
+        std::cerr << "❌ Zone '" << zone.name << "' has zero area" << std::endl;
+        return false;
+    }
+
+    zones_.push_back(zone);
+    geometry_.push_back(std::move(geometry));
+    return true;
+}
+
+void ZoneRouter::clearZones() {
+    zones_.clear();
+    geometry_.clear();
+}
+
+size_t ZoneRouter::getZoneCount() const {
+    return zones_.size();
+}
+
+const TUIOZone& ZoneRouter::getZone(size_t index) const {
+    return zones_.at(index);
+}
+
+void ZoneRouter::classify(const std::vector<float>& xs, const std::vector<float>& ys, std::vector<int>& zone_indices) const {
+    const size_t count = std::min(xs.size(), ys.size());
+    zone_indices.assign(count, -1);
+    if (count == 0 || zones_.empty()) {
+        return;
+    }
+
+    inside_.resize(count);
+    const float* px = xs.data();
+    const float* py = ys.data();
+    unsigned char* inside = inside_.data();
+
+    for (size_t z = 0; z < geometry_.size(); z++) {
+        const ZoneGeometry& geometry = geometry_[z];
+        std::fill(inside_.begin(), inside_.end(), 0);
+
+        // Even-odd crossing test, one edge against the whole batch at a time
+        for (size_t e = 0; e < geometry.edge_slope.size(); e++) {
+            const float x0 = geometry.edge_x0[e];
+            const float y0 = geometry.edge_y0[e];
+            const float y1 = geometry.edge_y1[e];
+            const float slope = geometry.edge_slope[e];
+
+            for (size_t i = 0; i < count; i++) {
+                const bool spans = (y0 > py[i]) != (y1 > py[i]);
+                const bool left = px[i] < x0 + (py[i] - y0) * slope;
+                inside[i] ^= static_cast<unsigned char>(spans & left);
+            }
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            if (inside[i] && zone_indices[i] < 0) {
+                zone_indices[i] = static_cast<int>(z);
+            }
+        }
+    }
+}
+
+void ZoneRouter::remap(size_t zone_index, float x, float y, float& zone_x, float& zone_y) const {
+    const ZoneGeometry& geometry = geometry_.at(zone_index);
+    zone_x = (x - geometry.min_x) / (geometry.max_x - geometry.min_x);
+    zone_y = (y - geometry.min_y) / (geometry.max_y - geometry.min_y);
+    zone_x = std::min(std::max(zone_x, 0.0f), 1.0f);
+    zone_y = std::min(std::max(zone_y, 0.0f), 1.0f);
+}
+
+bool ZoneRouter::loadFromFile(const std::string& config_file) {
+    std::ifstream file(config_file);
+    if (!file.is_open()) {
+        std::cerr << "❌ Failed to open zone file: " << config_file << std::endl;
+        return false;
+    }
+
+    size_t loaded = 0;
+    std::string line;
+    int line_number = 0;
+    while (std::getline(file, line)) {
+        line_number++;
+        line.erase(0, line.find_first_not_of(" \t"));
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        std::istringstream iss(line);
+        std::string keyword;
+        TUIOZone zone;
+        if (!(iss >> keyword >> zone.name >> zone.host >> zone.port) || keyword != "zone") {
+            std::cerr << "⚠️  Skipping malformed zone line " << line_number << std::endl;
+            continue;
+        }
+
+        std::string vertex;
+        bool valid = true;
+        while (iss >> vertex) {
+            size_t comma = vertex.find(',');
+            if (comma == std::string::npos) {
+                valid = false;
+                break;
+            }
+            try {
+                zone.polygon.emplace_back(std::stof(vertex.substr(0, comma)), std::stof(vertex.substr(comma + 1)));
+            } catch (const std::exception&) {
+                valid = false;
+                break;
+            }
+        }
+
+        if (!valid) {
+            std::cerr << "⚠️  Skipping zone with malformed vertex on line " << line_number << std::endl;
+            continue;
+        }
+        if (addZone(zone)) {
+            loaded++;
+        }
+    }
+
+    std::cout << "✅ Loaded " << loaded << " zone(s) from: " << config_file << std::endl;
+    return loaded > 0;
+}
+
+} // namespace CodiceCam
@@ -0,0 +1,165 @@
+#include "include/CaptureScheduler.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace CodiceCam;
+
+namespace {
+    const double PERIOD_MS = 1000.0 / 30.0;
+    const int FRAMES = 3000;
+    const int SETTLE_FRAMES = 300;  // The phase estimates converge before anything is checked
+
+    int g_failures = 0;
+
+    void check(bool condition, const std::string& description) {
+        std::cout << (condition ? "  ✅ " : "  ❌ ") << description << std::endl;
+        if (!condition) {
+            g_failures++;
+        }
+    }
+
+    double wrap(double value) {
+        double wrapped = std::fmod(value, PERIOD_MS);
+        return wrapped < 0.0 ? wrapped + PERIOD_MS : wrapped;
+    }
+
+    double circularDistance(double a, double b) {
+        double d = wrap(a - b);
+        return std::min(d, PERIOD_MS - d);
+    }
+
+    struct Camera {
+        double phase_ms;       // Capture phase at frame 0
+        double drift_ms;       // Phase drift per frame
+        double jitter_ms;      // Capture timestamp jitter (standard deviation)
+    };
+
+    struct Result {
+        double max_hold_ms = 0.0;
+        double total_hold_ms = 0.0;
+        int holds = 0;
+        int slot_jumps = 0;           // A source's dispatch phase moved by more than half a slot
+        double min_spacing_ms = PERIOD_MS;  // Closest pair of dispatch phases in a frame
+        int frames = 0;
+        int spread_frames = 0;        // Frames whose dispatch phases are all at least half a slot apart
+    };
+
+    // Feeds synthetic capture timestamps into dispatchTime and measures holds, spacing and slot changes
+    Result simulate(const std::vector<Camera>& cameras, unsigned seed) {
+        // Phase 0 is the scheduler's own wrap point: its epoch is taken at construction
+        auto epoch = std::chrono::steady_clock::now();
+        CaptureScheduler scheduler;
+        std::vector<int> sources;
+        for (size_t i = 0; i < cameras.size(); i++) {
+            sources.push_back(scheduler.addSource("cam" + std::to_string(i), PERIOD_MS));
+        }
+
+        std::mt19937 rng(seed);
+        std::normal_distribution<double> normal(0.0, 1.0);
+        double spacing = PERIOD_MS / cameras.size();
+
+        Result result;
+        std::vector<double> previous(cameras.size(), -1.0);
+        for (int frame = 0; frame < FRAMES; frame++) {
+            std::vector<double> dispatch_phases;
+            for (size_t i = 0; i < cameras.size(); i++) {
+                const Camera& camera = cameras[i];
+                double capture_ms = frame * PERIOD_MS + camera.phase_ms + camera.drift_ms * frame +
+                                    camera.jitter_ms * normal(rng);
+                auto capture = epoch + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                    std::chrono::duration<double, std::milli>(capture_ms));
+                auto dispatch = scheduler.dispatchTime(sources[i], capture);
+
+                double hold_ms = std::chrono::duration<double, std::milli>(dispatch - capture).count();
+                double dispatch_ms = std::chrono::duration<double, std::milli>(dispatch - epoch).count();
+                dispatch_phases.push_back(wrap(dispatch_ms));
+
+                if (frame < SETTLE_FRAMES) {
+                    continue;
+                }
+                result.max_hold_ms = std::max(result.max_hold_ms, hold_ms);
+                result.total_hold_ms += hold_ms;
+                result.holds++;
+                // Drift moves a slot by a fraction of a millisecond per frame; a jump is a slot change
+                if (previous[i] >= 0.0 && circularDistance(dispatch_phases[i], previous[i]) > spacing / 2.0) {
+                    result.slot_jumps++;
+                }
+            }
+            if (frame >= SETTLE_FRAMES) {
+                double closest = PERIOD_MS;
+                for (size_t i = 0; i < dispatch_phases.size(); i++) {
+                    for (size_t j = i + 1; j < dispatch_phases.size(); j++) {
+                        closest = std::min(closest, circularDistance(dispatch_phases[i], dispatch_phases[j]));
+                    }
+                }
+                result.min_spacing_ms = std::min(result.min_spacing_ms, closest);
+                result.frames++;
+                result.spread_frames += closest >= spacing / 2.0 ? 1 : 0;
+            }
+            previous = dispatch_phases;
+        }
+        return result;
+    }
+
+    void report(const Result& result) {
+        std::cout << "  Hold: " << (result.holds > 0 ? result.total_hold_ms / result.holds : 0.0) << " ms avg / "
+                  << result.max_hold_ms << " ms max, closest dispatch phases " << result.min_spacing_ms
+                  << " ms, spread in " << result.spread_frames << " / " << result.frames << " frames, slot jumps "
+                  << result.slot_jumps << std::endl;
+    }
+}
+
+int main() {
+    std::cout << "🗓️ Capture Scheduler Simulation" << std::endl;
+    std::cout << "==============================" << std::endl;
+    std::cout << "  Period " << PERIOD_MS << " ms, " << FRAMES << " frames per case" << std::endl;
+
+    std::cout << "\n📋 Aligned: 3 cameras capturing together" << std::endl;
+    {
+        Result result = simulate({{10.0, 0.0, 0.0}, {10.0, 0.0, 0.0}, {10.0, 0.0, 0.0}}, 1);
+        report(result);
+        check(result.min_spacing_ms > PERIOD_MS / 3.0 - 1.0, "processing is spread one third of a period apart");
+        check(result.slot_jumps == 0, "no slot changes");
+    }
+
+    std::cout << "\n📋 Jittered: 3 cameras capturing together, 0.5 ms jitter" << std::endl;
+    {
+        Result result = simulate({{10.0, 0.0, 0.5}, {10.0, 0.0, 0.5}, {10.0, 0.0, 0.5}}, 2);
+        report(result);
+        check(result.min_spacing_ms > PERIOD_MS / 3.0 - 3.0, "processing stays about one third of a period apart");
+        check(result.slot_jumps == 0, "jitter does not trade slots");
+    }
+
+    std::cout << "\n📋 Drifting: one camera drifts a full period against the others" << std::endl;
+    {
+        // A full period over the run: the drifting camera passes each of the others
+        Result result = simulate({{5.0, 0.0, 0.3}, {16.0, 0.0, 0.3}, {27.0, PERIOD_MS / FRAMES, 0.3}}, 3);
+        report(result);
+        // A drifting source processes at once while it is past its slot and before the order changes
+        check(result.spread_frames >= result.frames * 9 / 10, "processing stays spread in 90% of frames");
+        check(result.max_hold_ms < 0.75 * PERIOD_MS, "no frame waits longer than max_delay_fraction");
+        // Each crossing may trade two slots once; hysteresis keeps it from flapping
+        check(result.slot_jumps <= 2 * 2 * 2, "slots change only when the phases clearly cross");
+    }
+
+    std::cout << "\n📋 Wrap-straddling: 2 cameras capturing together at the period boundary" << std::endl;
+    {
+        // Their phase estimates jitter across the wrap point of [0, period)
+        Result result = simulate({{0.0, 0.0, 0.5}, {0.0, 0.0, 0.5}, {PERIOD_MS / 2.0, 0.0, 0.5}}, 4);
+        report(result);
+        check(result.min_spacing_ms > PERIOD_MS / 3.0 - 3.0, "processing is spread across the boundary");
+        check(result.slot_jumps == 0, "crossing the boundary does not reorder the sources");
+    }
+
+    if (g_failures > 0) {
+        std::cerr << "\n❌ " << g_failures << " capture scheduler checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "\n✅ All capture scheduler checks passed" << std::endl;
+    return 0;
+}
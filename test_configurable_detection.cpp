@@ -42,6 +42,10 @@ struct DetectionConfig {
     int max_marker_size = 300;
     double min_confidence = 0.6;
 
+    // Per-location size prior
+    bool use_size_prior = false;
+    std::string size_prior_file;  // Loaded at start and saved at exit when set
+
     // Debug options
     bool debug_mode = true;
     bool verbose_mode = false;
@@ -97,6 +101,8 @@ DetectionConfig loadConfig(const std::string& filename) {
         else if (key == "min_marker_size") config.min_marker_size = std::stoi(value);
         else if (key == "max_marker_size") config.max_marker_size = std::stoi(value);
         else if (key == "min_confidence") config.min_confidence = std::stod(value);
+        else if (key == "use_size_prior") config.use_size_prior = (value == "true");
+        else if (key == "size_prior_file") config.size_prior_file = value;
         else if (key == "debug_mode") config.debug_mode = (value == "true");
         else if (key == "verbose_mode") config.verbose_mode = (value == "true");
     }
@@ -123,6 +129,11 @@ void printConfig(const DetectionConfig& config) {
     std::cout << "  Marker Validation:" << std::endl;
     std::cout << "    - Size range: " << config.min_marker_size << " - " << config.max_marker_size << std::endl;
     std::cout << "    - Min confidence: " << config.min_confidence << std::endl;
+    std::cout << "    - Size prior: " << (config.use_size_prior ? "ON" : "OFF");
+    if (config.use_size_prior && !config.size_prior_file.empty()) {
+        std::cout << " (" << config.size_prior_file << ")";
+    }
+    std::cout << std::endl;
     std::cout << "  Debug Options:" << std::endl;
     std::cout << "    - Debug mode: " << (config.debug_mode ? "ON" : "OFF") << std::endl;
     std::cout << "    - Verbose mode: " << (config.verbose_mode ? "ON" : "OFF") << std::endl;
@@ -170,6 +181,13 @@ int main() {
     marker_detector.setDetectionParams(config.min_marker_size, config.max_marker_size, config.min_confidence);
     marker_detector.setDebugMode(config.debug_mode);
     marker_detector.setVerboseMode(config.verbose_mode);
+    if (config.use_size_prior) {
+        auto size_prior = std::make_shared<SizePriorMap>();
+        if (!config.size_prior_file.empty() && std::ifstream(config.size_prior_file).good()) {
+            size_prior->loadFromFile(config.size_prior_file);
+        }
+        marker_detector.setSizePrior(size_prior);
+    }
     std::cout << "✅ Marker detector initialized with custom settings" << std::endl;
 
     // Clear debug output folder if debug mode is enabled
@@ -213,7 +231,9 @@ int main() {
             return;
         }
 
-        if (!marker_detector.detectMarkers(frame, processed_frame, detected_markers)) {
+        if (!marker_detector.detectMarkers(
+                FrameInput::fromPreprocessed(frame, image_processor.getPreprocessedFrame(), processed_frame),
+                detected_markers)) {
             std::cout << "❌ Marker detection failed on frame " << frame_count << std::endl;
             return;
         }
@@ -270,6 +290,9 @@ int main() {
     std::cout << "\n🛑 Shutting down..." << std::endl;
     camera.stopCapture();
     std::cout << "✅ Camera stopped" << std::endl;
+    if (marker_detector.getSizePrior() && !config.size_prior_file.empty()) {
+        marker_detector.getSizePrior()->saveToFile(config.size_prior_file);
+    }
 
     std::cout << "\n🎉 Test completed!" << std::endl;
     std::cout << "📊 Final Statistics:" << std::endl;
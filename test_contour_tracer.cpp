@@ -0,0 +1,147 @@
+#include "include/ContourTracer.h"
+#include "include/FrameDataset.h"
+#include "include/ImageProcessor.h"
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace CodiceCam;
+
+namespace {
+    // Default limits: roughly what ImageProcessor derives for markers up to 100 px
+    const int DEFAULT_MAX_EXTENT = 185;
+    const int LENGTH_FACTOR = 6;
+
+    // Border steps of a CHAIN_APPROX_SIMPLE contour: each segment is a straight run of chain moves
+    int borderSteps(const std::vector<cv::Point>& contour) {
+        int steps = 0;
+        for (size_t i = 0; i < contour.size(); i++) {
+            cv::Point d = contour[(i + 1) % contour.size()] - contour[i];
+            steps += std::max(std::abs(d.x), std::abs(d.y));
+        }
+        return steps;
+    }
+
+    // Whether the tracer follows this contour to completion under the limits
+    bool underLimits(const std::vector<cv::Point>& contour, int max_extent, int max_length) {
+        cv::Rect box = cv::boundingRect(contour);
+        return box.width - 1 <= max_extent && box.height - 1 <= max_extent && borderSteps(contour) <= max_length;
+    }
+
+    std::string describe(const std::vector<cv::Point>& contour) {
+        cv::Rect box = cv::boundingRect(contour);
+        return std::to_string(contour.size()) + " points at (" + std::to_string(box.x) + "," + std::to_string(box.y) +
+               ") " + std::to_string(box.width) + "x" + std::to_string(box.height);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "🧭 BoundedContourTracer / findContours Comparison" << std::endl;
+    std::cout << "=================================================" << std::endl;
+
+    // test_contour_tracer <image directory | video file> [max_extent]
+    // Compares BoundedContourTracer with cv::findContours(RETR_EXTERNAL, CHAIN_APPROX_SIMPLE) on the edge
+    // images of the preprocessed frames. Without limits both must return the same contours in the same
+    // order; with limits every reference contour under the limits must still be returned unchanged
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <image directory | video file> [max_extent]" << std::endl;
+        return 1;
+    }
+    int max_extent = argc > 2 ? std::max(1, std::atoi(argv[2])) : DEFAULT_MAX_EXTENT;
+    int max_length = max_extent * LENGTH_FACTOR;
+
+    std::vector<cv::Mat> frames;
+    if (!FrameDataset::load(argv[1], frames)) {
+        return 1;
+    }
+    std::cout << "  Limits: extent " << max_extent << " px, length " << max_length << " steps" << std::endl;
+
+    ImageProcessor image_processor;
+    BoundedContourTracer unbounded;
+    BoundedContourTracer bounded;
+    bounded.setLimits(max_extent, max_length);
+
+    size_t reference_contours = 0;
+    size_t unbounded_mismatches = 0;
+    size_t under_limits = 0;
+    size_t bounded_missing = 0;
+    size_t bounded_order_mismatches = 0;
+    size_t bounded_extra = 0;
+    MismatchLog mismatches;
+
+    for (size_t f = 0; f < frames.size(); f++) {
+        cv::Mat edges;
+        if (!image_processor.processFrame(frames[f], edges) || edges.type() != CV_8UC1) {
+            std::cerr << "⚠️  Skipping frame " << f << ": preprocessing failed" << std::endl;
+            continue;
+        }
+
+        std::vector<std::vector<cv::Point>> reference;
+        std::vector<cv::Vec4i> hierarchy;
+        cv::findContours(edges, reference, hierarchy, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+        reference_contours += reference.size();
+
+        // Unlimited: identical output
+        std::vector<std::vector<cv::Point>> traced;
+        unbounded.trace(edges, traced);
+        if (traced.size() != reference.size()) {
+            unbounded_mismatches++;
+            mismatches.add(f, "unbounded: " + std::to_string(traced.size()) + " contours vs findContours " +
+                                  std::to_string(reference.size()));
+        } else {
+            for (size_t i = 0; i < reference.size(); i++) {
+                if (traced[i] != reference[i]) {
+                    unbounded_mismatches++;
+                    mismatches.add(f, "unbounded contour " + std::to_string(i) + ": " + describe(traced[i]) +
+                                      " vs findContours " + describe(reference[i]));
+                }
+            }
+        }
+
+        // Limited: every reference contour under the limits, in the same relative order. Contours nested
+        // inside an abandoned one are extra by design
+        bounded.trace(edges, traced);
+        size_t next = 0;
+        size_t matched = 0;
+        for (const auto& contour : reference) {
+            if (!underLimits(contour, max_extent, max_length)) {
+                continue;
+            }
+            under_limits++;
+            auto found = std::find(traced.begin() + next, traced.end(), contour);
+            if (found != traced.end()) {
+                next = static_cast<size_t>(found - traced.begin()) + 1;
+                matched++;
+            } else if (std::find(traced.begin(), traced.end(), contour) != traced.end()) {
+                bounded_order_mismatches++;
+                matched++;
+                mismatches.add(f, "bounded: contour out of order, " + describe(contour));
+            } else {
+                bounded_missing++;
+                mismatches.add(f, "bounded: missing contour " + describe(contour));
+            }
+        }
+        bounded_extra += traced.size() - matched;
+    }
+
+    std::cout << "\n📊 Comparison Report:" << std::endl;
+    std::cout << "  Frames: " << frames.size() << std::endl;
+    std::cout << "  findContours contours: " << reference_contours << std::endl;
+    std::cout << "  Unbounded mismatches: " << unbounded_mismatches << std::endl;
+    std::cout << "  Contours under the limits: " << under_limits << std::endl;
+    std::cout << "  Bounded missing: " << bounded_missing << std::endl;
+    std::cout << "  Bounded order mismatches: " << bounded_order_mismatches << std::endl;
+    std::cout << "  Bounded extra (inside abandoned contours): " << bounded_extra << std::endl;
+    std::cout << "  Abandoned: " << bounded.getAbandonedCount() << " of "
+              << bounded.getTracedCount() + bounded.getAbandonedCount() << " traced" << std::endl;
+
+    if (unbounded_mismatches > 0 || bounded_missing > 0 || bounded_order_mismatches > 0) {
+        std::cerr << "❌ BoundedContourTracer differs from cv::findContours" << std::endl;
+        return 1;
+    }
+    std::cout << "✅ BoundedContourTracer matches cv::findContours (unbounded, and under the limits)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,145 @@
+#include "include/CpuQuota.h"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+
+using namespace CodiceCam;
+
+namespace {
+    int g_failures = 0;
+
+    void check(bool condition, const std::string& description) {
+        std::cout << (condition ? "  ✅ " : "  ❌ ") << description << std::endl;
+        if (!condition) {
+            g_failures++;
+        }
+    }
+
+    void writeFile(const std::filesystem::path& path, const std::string& content) {
+        std::filesystem::create_directories(path.parent_path());
+        std::ofstream file(path);
+        file << content;
+    }
+
+    // A fake cgroup v2 mount and /proc/self/cgroup in a fresh temp directory
+    struct FakeCgroup {
+        std::filesystem::path root;
+        std::filesystem::path mount;
+        std::filesystem::path proc_cgroup;
+
+        FakeCgroup(const std::string& name, const std::string& proc_content) {
+            root = std::filesystem::temp_directory_path() /
+                   ("codicecam_cpu_quota_" + std::to_string(getpid()) + "_" + name);
+            std::filesystem::remove_all(root);
+            mount = root / "cgroup";
+            proc_cgroup = root / "proc_self_cgroup";
+            std::filesystem::create_directories(mount);
+            writeFile(proc_cgroup, proc_content);
+        }
+
+        ~FakeCgroup() {
+            std::error_code error;
+            std::filesystem::remove_all(root, error);
+        }
+
+        void write(const std::string& relative, const std::string& content) {
+            writeFile(mount / relative, content);
+        }
+
+        CpuQuota quota() const {
+            return CpuQuota(mount.string(), proc_cgroup.string());
+        }
+    };
+}
+
+int main() {
+    std::cout << "🧮 CPU Quota Test" << std::endl;
+    std::cout << "=================" << std::endl;
+
+    std::cout << "\n📋 cpuset lists" << std::endl;
+    check(CpuQuota::parseCpuList("0-3,8,10-11") == 7, "\"0-3,8,10-11\" has 7 CPUs");
+    check(CpuQuota::parseCpuList("5") == 1, "\"5\" has 1 CPU");
+    check(CpuQuota::parseCpuList("0-3\n") == 4, "trailing newline is ignored");
+    check(CpuQuota::parseCpuList("") == 0, "empty list has no CPUs");
+
+    std::cout << "\n📋 No cgroup v2 hierarchy" << std::endl;
+    {
+        FakeCgroup cgroup("v1", "12:cpu,cpuacct:/kiosk\n");
+        CpuQuota quota = cgroup.quota();
+        check(quota.getCgroupPath().empty(), "no cgroup path");
+        check(quota.getEffectiveCpuCount() == quota.getAffinityCount(), "effective count is the affinity mask");
+        CpuThrottling throttling;
+        check(!quota.readThrottling(throttling), "no throttling counters");
+    }
+
+    std::cout << "\n📋 Root cgroup, unlimited quota, 4-CPU cpuset" << std::endl;
+    {
+        FakeCgroup cgroup("root", "0::/\n");
+        cgroup.write("cpu.max", "max 100000\n");
+        cgroup.write("cpuset.cpus.effective", "0-3\n");
+        CpuQuota quota = cgroup.quota();
+        check(quota.getCgroupPath() == cgroup.mount.string(), "cgroup path is the mount point");
+        check(quota.getQuotaCpus() == 0.0, "\"max\" quota is unlimited");
+        check(quota.getCpusetCount() == 4, "cpuset has 4 CPUs");
+        check(quota.getEffectiveCpuCount() == std::min(4, quota.getAffinityCount()), "effective count is min(affinity, cpuset)");
+    }
+
+    std::cout << "\n📋 Nested cgroup, tighter quota on the parent" << std::endl;
+    {
+        FakeCgroup cgroup("nested", "0::/kiosk/app\n");
+        cgroup.write("kiosk/app/cpu.max", "250000 100000\n");
+        cgroup.write("kiosk/cpu.max", "150000 100000\n");
+        cgroup.write("kiosk/app/cpuset.cpus.effective", "0-7\n");
+        CpuQuota quota = cgroup.quota();
+        check(std::fabs(quota.getQuotaCpus() - 1.5) < 1e-9, "parent quota of 1.5 CPUs applies");
+        check(quota.getEffectiveCpuCount() == 1, "1.5 CPUs round down to 1");
+    }
+
+    std::cout << "\n📋 Fractional quota below one CPU" << std::endl;
+    {
+        FakeCgroup cgroup("fraction", "0::/small\n");
+        cgroup.write("small/cpu.max", "50000 100000\n");
+        CpuQuota quota = cgroup.quota();
+        check(std::fabs(quota.getQuotaCpus() - 0.5) < 1e-9, "quota is 0.5 CPUs");
+        check(quota.getEffectiveCpuCount() == 1, "effective count is at least 1");
+    }
+
+    std::cout << "\n📋 Quota change picked up by refresh()" << std::endl;
+    {
+        FakeCgroup cgroup("refresh", "0::/app\n");
+        cgroup.write("app/cpu.max", "max 100000\n");
+        CpuQuota quota = cgroup.quota();
+        int before = quota.getEffectiveCpuCount();
+        cgroup.write("app/cpu.max", "100000 100000\n");
+        quota.refresh();
+        check(before == quota.getAffinityCount(), "unlimited before");
+        check(quota.getEffectiveCpuCount() == 1, "1 CPU after the quota is set");
+    }
+
+    std::cout << "\n📋 Throttling counters" << std::endl;
+    {
+        FakeCgroup cgroup("stat", "0::/app\n");
+        cgroup.write("app/cpu.stat",
+                     "usage_usec 9000000\nuser_usec 8000000\nsystem_usec 1000000\n"
+                     "nr_periods 200\nnr_throttled 50\nthrottled_usec 123456\n");
+        CpuQuota quota = cgroup.quota();
+        CpuThrottling throttling;
+        check(quota.readThrottling(throttling), "cpu.stat read");
+        check(throttling.periods == 200, "nr_periods = 200");
+        check(throttling.throttled == 50, "nr_throttled = 50");
+        check(throttling.throttled_usec == 123456, "throttled_usec = 123456");
+        check(quota.getStatistics().find("Throttled periods: 50 / 200 (25.0%)") != std::string::npos,
+              "statistics report 25% throttled");
+    }
+
+    if (g_failures > 0) {
+        std::cerr << "\n❌ " << g_failures << " CPU quota checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "\n✅ All CPU quota checks passed" << std::endl;
+    return 0;
+}
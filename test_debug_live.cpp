@@ -90,7 +90,9 @@ int main() {
             std::cout << "✅ Image processing successful on frame " << frame_count << std::endl;
         }
         
-        if (!marker_detector.detectMarkers(processed_frame, detected_markers)) {
+        if (!marker_detector.detectMarkers(
+                FrameInput::fromPreprocessed(frame, image_processor.getPreprocessedFrame(), processed_frame),
+                detected_markers)) {
             if (frame_count % 30 == 0) {
                 std::cout << "❌ Marker detection failed on frame " << frame_count << std::endl;
             }
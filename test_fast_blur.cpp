@@ -0,0 +1,157 @@
+#include "include/FastBlur.h"
+#include "include/FrameDataset.h"
+#include <opencv2/opencv.hpp>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace CodiceCam;
+
+namespace {
+    // Contrast/brightness of ImageProcessor's defaults
+    const double CONTRAST_ALPHA = 1.2;
+    const double BRIGHTNESS_BETA = 10.0;
+
+    int g_failures = 0;
+
+    void check(bool condition, const std::string& description) {
+        std::cout << (condition ? "  ✅ " : "  ❌ ") << description << std::endl;
+        if (!condition) {
+            g_failures++;
+        }
+    }
+
+    // Largest difference from cv::GaussianBlur: kernels up to 11 use the same Q8 weights as OpenCV
+    int blurBound(int kernel_size) {
+        return kernel_size <= 11 ? 0 : 2;
+    }
+
+    // A difference of d before the contrast table is at most floor(alpha * d) + 1 after it (rounding)
+    int contrastBound(int blur_bound, double alpha) {
+        return static_cast<int>(std::floor(alpha * blur_bound)) + 1;
+    }
+
+    // Flat regions, sharp edges and sensor noise, like a camera frame of a table
+    cv::Mat cameraLikeFrame(cv::Size size, unsigned seed) {
+        cv::RNG rng(seed);
+        cv::Mat frame(size, CV_8UC3, cv::Scalar(120, 120, 120));
+        for (int i = 0; i < 60; i++) {
+            cv::Point corner(rng.uniform(0, size.width), rng.uniform(0, size.height));
+            int side = rng.uniform(20, 120);
+            cv::rectangle(frame, corner, corner + cv::Point(side, side),
+                          cv::Scalar(rng.uniform(0, 256), rng.uniform(0, 256), rng.uniform(0, 256)), cv::FILLED);
+        }
+        cv::Mat noise(size, CV_16SC3);
+        rng.fill(noise, cv::RNG::NORMAL, 0, 3);
+        cv::Mat noisy;
+        frame.convertTo(noisy, CV_16SC3);
+        noisy += noise;
+        noisy.convertTo(frame, CV_8UC3);
+        return frame;
+    }
+
+    cv::Mat noiseFrame(cv::Size size, unsigned seed) {
+        cv::RNG rng(seed);
+        cv::Mat frame(size, CV_8UC1);
+        rng.fill(frame, cv::RNG::UNIFORM, 0, 256);
+        return frame;
+    }
+
+    struct Difference {
+        int max = 0;
+        double identical = 0.0;  // Fraction of identical pixels
+    };
+
+    Difference compare(const cv::Mat& a, const cv::Mat& b) {
+        cv::Mat diff;
+        cv::absdiff(a, b, diff);
+        double max = 0.0;
+        cv::minMaxLoc(diff, nullptr, &max);
+        Difference result;
+        result.max = static_cast<int>(max);
+        result.identical = 1.0 - static_cast<double>(cv::countNonZero(diff)) / diff.total();
+        return result;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "🌫️ FastBlur / cv::GaussianBlur Comparison" << std::endl;
+    std::cout << "=========================================" << std::endl;
+
+    // test_fast_blur [image directory | video file]
+    // Bounds the difference between FastBlur and cvtColor + GaussianBlur (+ convertTo) on synthetic
+    // frames (odd sizes, BGR and gray), and on recorded frames when a dataset is given
+    std::vector<std::pair<std::string, cv::Mat>> frames = {
+        {"camera-like BGR 1280x720", cameraLikeFrame(cv::Size(1280, 720), 1)},
+        {"camera-like BGR 641x479", cameraLikeFrame(cv::Size(641, 479), 2)},
+        {"white noise gray 640x480", noiseFrame(cv::Size(640, 480), 3)},
+        {"white noise gray 17x16", noiseFrame(cv::Size(17, 16), 4)},
+    };
+    if (argc > 1) {
+        std::vector<cv::Mat> recorded;
+        if (!FrameDataset::load(argv[1], recorded)) {
+            return 1;
+        }
+        for (size_t i = 0; i < recorded.size(); i++) {
+            frames.push_back({"frame " + std::to_string(i), recorded[i]});
+        }
+    }
+
+    FastBlur fast_blur;
+    for (int kernel_size = 3; kernel_size <= FastBlur::MAX_KERNEL_SIZE; kernel_size += 2) {
+        fast_blur.setKernelSize(kernel_size);
+        int bound = blurBound(kernel_size);
+        int contrast_bound = contrastBound(bound, CONTRAST_ALPHA);
+        std::cout << "\n📋 Kernel " << kernel_size << " (" << fast_blur.getInfo() << ")" << std::endl;
+
+        Difference worst_blur;
+        Difference worst_contrast;
+        worst_blur.identical = worst_contrast.identical = 1.0;
+        size_t compared = 0;
+        for (const auto& [name, frame] : frames) {
+            if (!FastBlur::supports(frame, kernel_size)) {
+                continue;
+            }
+            cv::Mat gray = frame;
+            if (frame.channels() == 3) {
+                cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
+            }
+            cv::Mat reference;
+            cv::GaussianBlur(gray, reference, cv::Size(kernel_size, kernel_size), 0);
+            cv::Mat reference_contrast;
+            reference.convertTo(reference_contrast, -1, CONTRAST_ALPHA, BRIGHTNESS_BETA);
+
+            cv::Mat blurred;
+            cv::Mat contrasted;
+            fast_blur.apply(frame, blurred);
+            fast_blur.apply(frame, contrasted, CONTRAST_ALPHA, BRIGHTNESS_BETA);
+
+            Difference blur = compare(blurred, reference);
+            Difference contrast = compare(contrasted, reference_contrast);
+            if (blur.max > bound || contrast.max > contrast_bound) {
+                std::cout << "    " << name << ": blur max " << blur.max << ", with contrast max " << contrast.max
+                          << std::endl;
+            }
+            worst_blur.max = std::max(worst_blur.max, blur.max);
+            worst_blur.identical = std::min(worst_blur.identical, blur.identical);
+            worst_contrast.max = std::max(worst_contrast.max, contrast.max);
+            worst_contrast.identical = std::min(worst_contrast.identical, contrast.identical);
+            compared++;
+        }
+
+        std::cout << "  " << compared << " frames, blur: max " << worst_blur.max << ", " << worst_blur.identical * 100.0
+                  << "% identical (worst frame); with contrast: max " << worst_contrast.max << ", "
+                  << worst_contrast.identical * 100.0 << "% identical" << std::endl;
+        check(worst_blur.max <= bound, "blur within " + std::to_string(bound) + " gray levels of cv::GaussianBlur");
+        check(worst_contrast.max <= contrast_bound,
+              "blur + contrast within " + std::to_string(contrast_bound) + " gray levels of GaussianBlur + convertTo");
+    }
+
+    if (g_failures > 0) {
+        std::cerr << "\n❌ " << g_failures << " FastBlur checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "\n✅ All FastBlur checks passed" << std::endl;
+    return 0;
+}
@@ -5,6 +5,11 @@
 #include "include/TUIOTestClient.h"
 #include "include/TUIOValidator.h"
 #include "include/TUIOConfig.h"
+#include "include/FramePoolAllocator.h"
+#include "include/MemoryMonitor.h"
+#include "include/FrameParallelDetector.h"
+#include "include/CpuQuota.h"
+#include "include/WorkerPool.h"
 #include <iostream>
 #include <thread>
 #include <chrono>
@@ -12,6 +17,9 @@
 #include <signal.h>
 #include <iomanip>
 #include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <algorithm>
 
 using namespace CodiceCam;
 
@@ -75,9 +83,67 @@ struct TestStatistics {
 
 TestStatistics g_stats;
 
-int main() {
+int main(int argc, char* argv[]) {
     std::cout << "🎥 Live Camera TUIO Integration Test" << std::endl;
     std::cout << "====================================" << std::endl;
+
+    // --benchmark: per-stage timings and hardware counters (per detection context with --contexts)
+    // --frame-pool: allocate cv::Mat buffers from pooled huge-page regions (held until exit)
+    // --contexts N: detect N consecutive frames in parallel, committed in capture order
+    // --idle-after S: drop to a 2 FPS motion check after S seconds without markers or motion (0 = never)
+    // --low-memory: Y-plane frames, one frame in flight per context, no frame pool or debug frames
+    // --quality-gate: skip decoding candidates in motion-blurred or clipped regions
+    // --size-prior: learn per-location marker sizes (one map shared by every detection context)
+    bool benchmark = false;
+    bool quality_gate = false;
+    bool size_prior = false;
+    bool low_memory = false;
+    bool frame_pool = false;
+    int detection_contexts = 1;
+    int idle_after_s = 60;
+    for (int i = 1; i < argc; i++) {
+        if (std::string(argv[i]) == "--benchmark") {
+            benchmark = true;
+        } else if (std::string(argv[i]) == "--frame-pool") {
+            frame_pool = true;
+        } else if (std::string(argv[i]) == "--contexts" && i + 1 < argc) {
+            detection_contexts = std::max(1, std::atoi(argv[++i]));
+        } else if (std::string(argv[i]) == "--idle-after" && i + 1 < argc) {
+            idle_after_s = std::max(0, std::atoi(argv[++i]));
+        } else if (std::string(argv[i]) == "--low-memory") {
+            low_memory = true;
+        } else if (std::string(argv[i]) == "--quality-gate") {
+            quality_gate = true;
+        } else if (std::string(argv[i]) == "--size-prior") {
+            size_prior = true;
+        }
+    }
+
+    // Detection contexts beyond the CPU quota only get the cgroup throttled
+    CpuQuota cpu_quota;
+    std::cout << cpu_quota.getStatistics();
+    if (detection_contexts > cpu_quota.getEffectiveCpuCount()) {
+        std::cout << "⚠️ Limiting detection contexts to " << cpu_quota.getEffectiveCpuCount()
+                  << " effective CPUs (requested " << detection_contexts << ")" << std::endl;
+        detection_contexts = cpu_quota.getEffectiveCpuCount();
+    }
+
+    // Each context runs on its own thread; the shared pool gets the remaining cores plus the caller
+    if (detection_contexts > 1) {
+        int pool_threads = std::max(1, cpu_quota.getEffectiveCpuCount() - detection_contexts + 1);
+        WorkerPool::setSharedConcurrency(pool_threads);
+        std::cout << "⚙️ Worker pool: " << pool_threads << " threads alongside " << detection_contexts
+                  << " detection contexts" << std::endl;
+    }
+
+    // The pool never returns its regions to the OS, which small kiosks cannot afford
+    if (low_memory && frame_pool) {
+        std::cout << "⚙️ Low-memory mode: frame pool disabled" << std::endl;
+        frame_pool = false;
+    }
+    
+    // Installed before the camera so capture buffers come from the pool too
+    FramePoolAllocator* frame_pool_allocator = frame_pool ? FramePoolAllocator::installAsDefault() : nullptr;
     
     // Set up signal handlers
     signal(SIGINT, signalHandler);
@@ -89,22 +155,41 @@ int main() {
     // Test 1: Initialize Camera
     std::cout << "\n📋 Test 1: Camera Initialization" << std::endl;
     CameraManager camera(2); // Use camera ID 2 as determined earlier
+    camera.setLowMemoryMode(low_memory);
     if (!camera.initialize()) {
         std::cerr << "❌ Failed to initialize camera" << std::endl;
         return 1;
     }
     std::cout << "✅ Camera initialized successfully" << std::endl;
     
+    std::shared_ptr<IdleMonitor> idle_monitor;
+    if (idle_after_s > 0) {
+        IdleConfig idle_config;
+        idle_config.idle_after_ms = idle_after_s * 1000;
+        idle_monitor = std::make_shared<IdleMonitor>(idle_config);
+        camera.setIdleMonitor(idle_monitor);
+    }
+    
     // Test 2: Initialize Image Processing
     std::cout << "\n📋 Test 2: Image Processing Initialization" << std::endl;
-    ImageProcessor image_processor;
-    std::cout << "✅ Image processor initialized" << std::endl;
+    // MarkerDetector preprocesses each camera frame itself, once
+    std::cout << "✅ Image processing runs inside the marker detector" << std::endl;
     
     // Test 3: Initialize Marker Detection
     std::cout << "\n📋 Test 3: Marker Detection Initialization" << std::endl;
+    // One size prior for every detector, so all contexts learn from and gate on the same markers
+    std::shared_ptr<SizePriorMap> shared_size_prior = size_prior ? std::make_shared<SizePriorMap>() : nullptr;
     MarkerDetector marker_detector;
     marker_detector.setDebugMode(false); // Minimal logging for live test
     marker_detector.setVerboseMode(false);
+    marker_detector.setLowMemoryMode(low_memory);
+    if (quality_gate) {
+        marker_detector.setQualityGating(true);
+    }
+    marker_detector.setSizePrior(shared_size_prior);
+    if (benchmark && detection_contexts == 1) {
+        marker_detector.setBenchmarkMode(true);
+    }
     std::cout << "✅ Marker detector initialized" << std::endl;
     
     // Test 4: Initialize TUIO Bridge
@@ -134,6 +219,9 @@ int main() {
         std::cerr << "❌ Failed to start TUIO bridge" << std::endl;
         return 1;
     }
+    if (low_memory) {
+        tuio_bridge.setLifecycleHistoryLimit(2);
+    }
     std::cout << "✅ TUIO bridge initialized and started" << std::endl;
     
     // Test 5: Initialize TUIO Test Client
@@ -154,26 +242,16 @@ int main() {
     std::cout << "\n📋 Test 7: Starting Camera Capture" << std::endl;
     std::vector<CodiceMarker> detected_markers;
     
-    auto frame_callback = [&](const cv::Mat& frame) {
-        if (!g_running) return;
-        
-        g_stats.total_frames_processed++;
-        
-        // Process frame for marker detection
-        cv::Mat processed_frame;
-        if (!image_processor.processFrame(frame, processed_frame)) {
-            return;
+    // Sends one frame's markers to TUIO; frames arrive here in capture order
+    auto commit_markers = [&](const cv::Mat& frame, const FrameInfo&, const std::vector<CodiceMarker>& markers) {
+        g_stats.total_markers_detected += markers.size();
+        if (idle_monitor) {
+            idle_monitor->reportMarkers(markers.size());
         }
         
-        if (!marker_detector.detectMarkers(processed_frame, detected_markers)) {
-            return;
-        }
-        
-        g_stats.total_markers_detected += detected_markers.size();
-        
         // Convert to TUIO format and send
         std::vector<CodiceCam::CodiceMarker> tuio_markers;
-        for (const auto& marker : detected_markers) {
+        for (const auto& marker : markers) {
             // Convert center to normalized coordinates (0.0-1.0)
             float x = marker.center.x / frame.cols;
             float y = marker.center.y / frame.rows;
@@ -209,23 +287,107 @@ int main() {
         g_stats.total_tuio_messages_sent += tuio_markers.size();
         
         // Print detection results (minimal)
-        if (!detected_markers.empty()) {
-            std::cout << "🎯 Detected " << detected_markers.size() << " markers: ";
-            for (const auto& marker : detected_markers) {
+        if (!markers.empty()) {
+            std::cout << "🎯 Detected " << markers.size() << " markers: ";
+            for (const auto& marker : markers) {
                 std::cout << "ID" << marker.id << "(" << std::fixed << std::setprecision(2) 
                          << marker.center.x << "," << marker.center.y << ") ";
             }
             std::cout << std::endl;
         }
+        
+        return FrameStatus::DELIVERED;
+    };
+    
+    auto frame_callback = [&](const cv::Mat& frame, const FrameInfo& frame_info) {
+        if (!g_running) return FrameStatus::DROPPED_STALE;
+        
+        g_stats.total_frames_processed++;
+        
+        // Raw camera frame: the detector runs preprocessing once
+        if (!marker_detector.detectMarkers(FrameInput::fromCamera(frame, frame_info.capture_time), detected_markers)) {
+            return FrameStatus::PROCESSING_ERROR;
+        }
+        
+        return commit_markers(frame, frame_info, detected_markers);
     };
     
-    if (!camera.startCapture(frame_callback)) {
+    // One marker detector per parallel detection context
+    ParallelDetectionConfig parallel_config;
+    parallel_config.contexts = detection_contexts;
+    if (low_memory) {
+        parallel_config.max_in_flight = detection_contexts;  // No frames queued behind the contexts
+    }
+    FrameParallelDetector parallel_detector(parallel_config);
+    std::vector<std::unique_ptr<MarkerDetector>> context_detectors;
+    
+    bool capture_started;
+    if (detection_contexts > 1) {
+        for (int i = 0; i < detection_contexts; i++) {
+            context_detectors.push_back(std::make_unique<MarkerDetector>());
+            context_detectors.back()->setDebugMode(false);
+            context_detectors.back()->setVerboseMode(false);
+            context_detectors.back()->setLowMemoryMode(low_memory);
+            // A context sees every Nth frame: its last markers are stale, so nothing is coasted
+            context_detectors.back()->setQualityGating(quality_gate, FrameQualityConfig(), 0);
+            context_detectors.back()->setSizePrior(shared_size_prior);
+            context_detectors.back()->setBenchmarkMode(benchmark);
+        }
+        
+        auto detect = [&](int context, const cv::Mat& frame, const FrameInfo& info, std::vector<CodiceMarker>& markers) {
+            return context_detectors[context]->detectMarkers(FrameInput::fromCamera(frame, info.capture_time), markers);
+        };
+        
+        if (!parallel_detector.start(detect, commit_markers, &camera.getFrameAccounting())) {
+            std::cerr << "❌ Failed to start parallel detection" << std::endl;
+            return 1;
+        }
+        
+        capture_started = camera.startDeferredCapture([&](const cv::Mat& frame, const FrameInfo& frame_info) {
+            if (!g_running) {
+                camera.getFrameAccounting().finishFrame(frame_info, FrameStatus::DROPPED_STALE);
+                return;
+            }
+            g_stats.total_frames_processed++;
+            parallel_detector.submit(frame, frame_info);
+        });
+    } else {
+        capture_started = camera.startCapture(frame_callback);
+    }
+    
+    if (!capture_started) {
         std::cerr << "❌ Failed to start camera capture" << std::endl;
         return 1;
     }
     g_camera_running = true;
     std::cout << "✅ Camera capture started" << std::endl;
     
+    // Each detection context profiles the frames it detects
+    auto print_benchmark = [&]() {
+        if (context_detectors.empty()) {
+            std::cout << marker_detector.getBenchmarkReport();
+        }
+        for (size_t i = 0; i < context_detectors.size(); i++) {
+            std::cout << "Context " << i << " ";
+            std::cout << context_detectors[i]->getBenchmarkReport();
+        }
+    };
+    
+    // Peak RSS and per-subsystem memory against the budget for this resolution
+    int frames_in_flight = detection_contexts > 1 ? (low_memory ? 1 : 2) * detection_contexts : 1;
+    MemoryMonitor memory_monitor(camera.getFrameSize(), frames_in_flight);
+    memory_monitor.addSubsystem("Camera buffers", [&]() { return camera.getMemoryBytes(); });
+    memory_monitor.addSubsystem("Image processing", [&]() {
+        size_t bytes = marker_detector.getMemoryBytes();
+        for (const auto& detector : context_detectors) {
+            bytes += detector->getMemoryBytes();
+        }
+        return bytes;
+    });
+    if (detection_contexts > 1) {
+        memory_monitor.addSubsystem("Frames in flight", [&]() { return parallel_detector.getInFlightBytes(); });
+    }
+    
     // Test 8: Start TUIO Test Client
     std::cout << "\n📋 Test 8: Starting TUIO Test Client" << std::endl;
     std::cout << "📋 Instructions:" << std::endl;
@@ -257,6 +419,21 @@ int main() {
         
         if (elapsed >= stats_interval) {
             g_stats.print();
+            std::cout << camera.getFrameAccounting().getStatistics();
+            if (benchmark) {
+                print_benchmark();
+            }
+            if (frame_pool_allocator) {
+                std::cout << frame_pool_allocator->getStatistics();
+            }
+            if (detection_contexts > 1) {
+                std::cout << parallel_detector.getStatistics();
+            }
+            std::cout << cpu_quota.getStatistics();
+            if (idle_monitor) {
+                std::cout << idle_monitor->getStatistics();
+            }
+            std::cout << memory_monitor.getStatistics();
             std::cout << "\n🔄 TUIO Bridge Statistics:" << std::endl;
             std::cout << tuio_bridge.getStatistics() << std::endl;
             std::cout << "\n🔄 TUIO Test Client Statistics:" << std::endl;
@@ -270,6 +447,7 @@ int main() {
     
     // Stop camera
     camera.stopCapture();
+    parallel_detector.stop();
     g_camera_running = false;
     std::cout << "✅ Camera stopped" << std::endl;
     
@@ -287,6 +465,24 @@ int main() {
     // Final statistics
     std::cout << "\n📊 Final Test Results:" << std::endl;
     g_stats.print();
+    std::cout << camera.getFrameAccounting().getStatistics();
+    if (benchmark) {
+        print_benchmark();
+    }
+    if (frame_pool_allocator) {
+        std::cout << frame_pool_allocator->getStatistics();
+    }
+    if (detection_contexts > 1) {
+        std::cout << parallel_detector.getStatistics();
+    }
+    std::cout << cpu_quota.getStatistics();
+    if (shared_size_prior) {
+        std::cout << shared_size_prior->getStatistics();
+    }
+    if (idle_monitor) {
+        std::cout << idle_monitor->getStatistics();
+    }
+    std::cout << memory_monitor.getStatistics();
     
     std::cout << "\n🎉 Live Camera TUIO Integration Test completed!" << std::endl;
     std::cout << "The system successfully:" << std::endl;
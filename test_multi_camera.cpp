@@ -0,0 +1,114 @@
+#include "include/CameraManager.h"
+#include "include/CaptureScheduler.h"
+#include "include/MarkerDetector.h"
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <signal.h>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace CodiceCam;
+
+std::atomic<bool> g_running(true);
+
+void signalHandler(int signal) {
+    std::cout << "\n🛑 Received signal " << signal << ", shutting down gracefully..." << std::endl;
+    g_running = false;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "🎥 Multi-Camera Detection Test" << std::endl;
+    std::cout << "=============================" << std::endl;
+
+    signal(SIGINT, signalHandler);
+    signal(SIGTERM, signalHandler);
+
+    // test_multi_camera <device> <device> [...] [--no-stagger] [--duration S]
+    // --no-stagger: process every frame as soon as it is captured (baseline for latency comparison)
+    std::vector<int> devices;
+    bool stagger = true;
+    int duration_s = 60;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--no-stagger") {
+            stagger = false;
+        } else if (arg == "--duration" && i + 1 < argc) {
+            duration_s = std::max(1, std::atoi(argv[++i]));
+        } else {
+            devices.push_back(std::atoi(argv[i]));
+        }
+    }
+    if (devices.size() < 2) {
+        std::cerr << "Usage: " << argv[0] << " <device> <device> [...] [--no-stagger] [--duration S]" << std::endl;
+        return 1;
+    }
+
+    auto scheduler = stagger ? std::make_shared<CaptureScheduler>() : nullptr;
+    std::vector<std::unique_ptr<CameraManager>> cameras;
+    std::vector<std::unique_ptr<MarkerDetector>> detectors;
+
+    for (int device : devices) {
+        auto camera = std::make_unique<CameraManager>(device, 1280, 720);
+        if (!camera->initialize()) {
+            std::cerr << "❌ Failed to initialize camera " << device << std::endl;
+            return 1;
+        }
+        camera->setCaptureScheduler(scheduler);
+        cameras.push_back(std::move(camera));
+
+        detectors.push_back(std::make_unique<MarkerDetector>());
+        detectors.back()->setDebugMode(false);
+        detectors.back()->setVerboseMode(false);
+    }
+
+    for (size_t i = 0; i < cameras.size(); i++) {
+        MarkerDetector* detector = detectors[i].get();
+        bool started = cameras[i]->startCapture([detector](const cv::Mat& frame, const FrameInfo& info) {
+            std::vector<CodiceMarker> markers;
+            if (!detector->detectMarkers(FrameInput::fromCamera(frame, info.capture_time), markers)) {
+                return FrameStatus::PROCESSING_ERROR;
+            }
+            return FrameStatus::DELIVERED;
+        });
+        if (!started) {
+            std::cerr << "❌ Failed to start camera " << devices[i] << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "✅ " << cameras.size() << " cameras capturing, processing "
+              << (stagger ? "staggered" : "unstaggered") << " for " << duration_s << " s" << std::endl;
+
+    // Capture-to-commit latency (average and max) per camera, and the scheduler's slots and holds
+    auto report = [&]() {
+        for (size_t i = 0; i < cameras.size(); i++) {
+            std::cout << "\n📷 Camera " << devices[i] << "\n" << cameras[i]->getFrameAccounting().getStatistics();
+        }
+        if (scheduler) {
+            std::cout << scheduler->getStatistics();
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    auto last_report = start;
+    while (g_running && std::chrono::steady_clock::now() - start < std::chrono::seconds(duration_s)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        if (std::chrono::steady_clock::now() - last_report >= std::chrono::seconds(10)) {
+            report();
+            last_report = std::chrono::steady_clock::now();
+        }
+    }
+
+    // Sources leave the scheduler when their capture stops
+    std::cout << "\n📊 Final Statistics:" << std::endl;
+    report();
+
+    for (auto& camera : cameras) {
+        camera->stopCapture();
+    }
+    return 0;
+}
@@ -0,0 +1,110 @@
+#include "include/FrameDataset.h"
+#include "include/ImageProcessor.h"
+#include "include/QuadApprox.h"
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace CodiceCam;
+
+namespace {
+    // Contours shorter than this cannot be markers; the detector drops them before the quad test
+    const double MIN_PERIMETER = 40.0;
+
+    std::string describe(const cv::Point* corners, size_t count) {
+        std::string text;
+        for (size_t i = 0; i < count; i++) {
+            text += "(" + std::to_string(corners[i].x) + "," + std::to_string(corners[i].y) + ")";
+        }
+        return text;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "📐 QuadApprox / approxPolyDP Corner Comparison" << std::endl;
+    std::cout << "==============================================" << std::endl;
+
+    // test_quad_approx <image directory | video file>
+    // Compares QuadApprox with cv::approxPolyDP(0.05 * perimeter) on every external contour of the
+    // preprocessed frames: both must agree on which contours are quads, and on their corners and order
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <image directory | video file>" << std::endl;
+        return 1;
+    }
+
+    std::vector<cv::Mat> frames;
+    if (!FrameDataset::load(argv[1], frames)) {
+        return 1;
+    }
+
+    ImageProcessor image_processor;
+    size_t contours_checked = 0;
+    size_t quads = 0;
+    size_t decision_mismatches = 0;
+    size_t corner_mismatches = 0;
+    size_t order_mismatches = 0;
+    MismatchLog mismatches;
+
+    for (size_t f = 0; f < frames.size(); f++) {
+        cv::Mat edges;
+        if (!image_processor.processFrame(frames[f], edges)) {
+            std::cerr << "⚠️  Skipping frame " << f << ": preprocessing failed" << std::endl;
+            continue;
+        }
+        std::vector<std::vector<cv::Point>> contours;
+        cv::findContours(edges, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+
+        for (const auto& contour : contours) {
+            double perimeter = cv::arcLength(contour, true);
+            if (perimeter < MIN_PERIMETER) {
+                continue;
+            }
+            contours_checked++;
+
+            double epsilon = 0.05 * perimeter;
+            std::vector<cv::Point> approx;
+            cv::approxPolyDP(contour, approx, epsilon, true);
+            bool reference_quad = approx.size() == 4;
+
+            cv::Point corners[4];
+            bool quad = QuadApprox::approximate(contour, epsilon, corners);
+
+            std::string problem;
+            if (quad != reference_quad) {
+                decision_mismatches++;
+                problem = std::string("quad decision ") + (quad ? "quad" : "not quad") + " vs approxPolyDP " +
+                          std::to_string(approx.size()) + " vertices";
+            } else if (quad) {
+                quads++;
+                if (!std::equal(corners, corners + 4, approx.begin())) {
+                    bool same_set = std::all_of(corners, corners + 4, [&](const cv::Point& corner) {
+                        return std::find(approx.begin(), approx.end(), corner) != approx.end();
+                    });
+                    (same_set ? order_mismatches : corner_mismatches)++;
+                    problem = std::string(same_set ? "corner order " : "corners ") + describe(corners, 4) +
+                              " vs approxPolyDP " + describe(approx.data(), approx.size());
+                }
+            }
+            if (!problem.empty()) {
+                mismatches.add(f, problem);
+            }
+        }
+    }
+
+    std::cout << "\n📊 Comparison Report:" << std::endl;
+    std::cout << "  Frames: " << frames.size() << std::endl;
+    std::cout << "  Contours checked: " << contours_checked << std::endl;
+    std::cout << "  Quads (both): " << quads << std::endl;
+    std::cout << "  Quad decision mismatches: " << decision_mismatches << std::endl;
+    std::cout << "  Corner mismatches: " << corner_mismatches << std::endl;
+    std::cout << "  Corner order mismatches: " << order_mismatches << std::endl;
+
+    if (decision_mismatches > 0 || corner_mismatches > 0 || order_mismatches > 0) {
+        std::cerr << "❌ QuadApprox differs from cv::approxPolyDP" << std::endl;
+        return 1;
+    }
+    std::cout << "✅ QuadApprox matches cv::approxPolyDP (quads, corners, order)" << std::endl;
+    return 0;
+}
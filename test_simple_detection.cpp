@@ -83,7 +83,9 @@ int main() {
             return;
         }
 
-        if (!marker_detector.detectMarkers(frame, processed_frame, detected_markers)) {
+        if (!marker_detector.detectMarkers(
+                FrameInput::fromPreprocessed(frame, image_processor.getPreprocessedFrame(), processed_frame),
+                detected_markers)) {
             return;
         }
 
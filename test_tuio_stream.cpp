@@ -78,7 +78,9 @@ int main() {
             return;
         }
         
-        if (!marker_detector.detectMarkers(processed_frame, detected_markers)) {
+        if (!marker_detector.detectMarkers(
+                FrameInput::fromPreprocessed(frame, image_processor.getPreprocessedFrame(), processed_frame),
+                detected_markers)) {
             return;
         }
         